@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "mlel/host_timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace mlsdk::el::utils {
+
+namespace {
+size_t getBucketIndex(uint64_t nanoseconds) {
+    auto microseconds = nanoseconds / 1000;
+    size_t index = 0;
+    while (microseconds != 0 && index < HostTimerHistogram::bucketCount - 1) {
+        microseconds >>= 1;
+        index++;
+    }
+    return index;
+}
+
+uint64_t getBucketUpperBound(size_t index) { return (uint64_t{1} << index) * 1000; }
+} // namespace
+
+/*******************************************************************************
+ * HostTimerHistogram
+ *******************************************************************************/
+
+void HostTimerHistogram::add(uint64_t nanoseconds) {
+    minNanoseconds = count == 0 ? nanoseconds : std::min(minNanoseconds, nanoseconds);
+    maxNanoseconds = std::max(maxNanoseconds, nanoseconds);
+    totalNanoseconds += nanoseconds;
+    count++;
+    buckets[getBucketIndex(nanoseconds)]++;
+}
+
+uint64_t HostTimerHistogram::percentile(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // The bucket bound overestimates, the largest recorded duration is a tighter bound for the last buckets
+            return std::clamp(getBucketUpperBound(i), minNanoseconds, maxNanoseconds);
+        }
+    }
+    return maxNanoseconds;
+}
+
+/*******************************************************************************
+ * HostTimerRegistry
+ *******************************************************************************/
+
+HostTimerRegistry::HostTimerRegistry(size_t _eventCapacity) : eventCapacity{_eventCapacity} {}
+
+void HostTimerRegistry::record(const char *phase, HostClock::time_point start, HostClock::time_point end) {
+    const auto nanoseconds =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    const auto threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    std::lock_guard lock(mutex);
+    auto it = histograms.find(phase);
+    if (it == histograms.end()) {
+        it = histograms.emplace(phase, HostTimerHistogram{}).first;
+    }
+    it->second.add(nanoseconds);
+
+    if (eventCapacity == 0) {
+        return;
+    }
+    if (events.size() == eventCapacity) {
+        events.pop_front();
+    }
+    events.push_back({phase, start, nanoseconds, threadId});
+}
+
+std::map<std::string, HostTimerHistogram> HostTimerRegistry::getHistograms() const {
+    std::lock_guard lock(mutex);
+    return {histograms.begin(), histograms.end()};
+}
+
+std::vector<HostTimerEvent> HostTimerRegistry::getEvents() const {
+    std::lock_guard lock(mutex);
+    return {events.begin(), events.end()};
+}
+
+/*******************************************************************************
+ * ScopedHostTimer
+ *******************************************************************************/
+
+ScopedHostTimer::ScopedHostTimer(HostTimerRegistry *_registry, const char *_phase, HostClock::duration *_elapsed)
+    : registry{_registry}, phase{_phase}, elapsed{_elapsed}, running{_registry != nullptr || _elapsed != nullptr} {
+    if (running) {
+        start = HostClock::now();
+    }
+}
+
+ScopedHostTimer::~ScopedHostTimer() { stop(); }
+
+void ScopedHostTimer::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+
+    const auto end = HostClock::now();
+    if (elapsed != nullptr) {
+        *elapsed += end - start;
+    }
+    if (registry != nullptr) {
+        registry->record(phase, start, end);
+    }
+}
+
+} // namespace mlsdk::el::utils
@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * HandleMap
+ *******************************************************************************/
+
+/**
+ * Maps Vulkan handles to the layer objects tracking them, for lookups from any number of threads.
+ *
+ * Handles are spread over shards, each with its own shared mutex, so lookups only take a shared lock on one shard and
+ * never contend with each other. Creating and destroying handles takes the shard lock exclusively. Lookups of unknown
+ * handles return nullptr and leave the map unchanged.
+ *
+ * Each thread also keeps a small direct-mapped cache of the handles it looked up last, so a thread recording into the
+ * same command buffers skips the shard lock entirely. The cache holds no references, its entries point at the values
+ * stored in the map and are only used while the map is at the generation they were cached at. Any change to the map
+ * moves it to a new generation, which invalidates the cached entries of all threads. This relies on the external
+ * synchronization Vulkan requires between destroying a handle and any other use of it.
+ */
+template <typename Key, typename Value, size_t SHARD_COUNT = 16> class HandleMap {
+  public:
+    using Pointer = std::shared_ptr<Value>;
+
+    Pointer find(Key key) const {
+        // Read the generation before the shard, so a change racing with this lookup invalidates the cached entry
+        const auto currentGeneration = generation.load(std::memory_order_acquire);
+        auto &entry = getCacheEntry(key);
+        if (entry.map == this && entry.generation == currentGeneration && entry.key == key) {
+            return *entry.value;
+        }
+
+        // Map nodes keep their address until erased, which moves the map to a new generation
+        const auto &shard = getShard(key);
+        const std::shared_lock l(shard.mutex);
+        const auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return nullptr;
+        }
+        entry = {this, currentGeneration, key, &it->second};
+        return it->second;
+    }
+
+    void insert(Key key, Pointer value) {
+        auto &shard = getShard(key);
+        const std::unique_lock l(shard.mutex);
+        shard.map.insert_or_assign(key, std::move(value));
+        nextGeneration();
+    }
+
+    /// Erase the entry for key, returning true if there was one.
+    bool erase(Key key) {
+        auto &shard = getShard(key);
+        const std::unique_lock l(shard.mutex);
+        if (shard.map.erase(key) == 0) {
+            return false;
+        }
+        nextGeneration();
+        return true;
+    }
+
+    /// Erase all entries for which pred(key, value) returns true.
+    template <typename Pred> void eraseIf(Pred pred) {
+        for (auto &shard : shards) {
+            const std::unique_lock l(shard.mutex);
+            for (auto it = shard.map.begin(); it != shard.map.end();) {
+                if (pred(it->first, it->second)) {
+                    it = shard.map.erase(it);
+                    nextGeneration();
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    /// Return the keys of all entries for which pred(key, value) returns true.
+    template <typename Pred> std::vector<Key> findKeys(Pred pred) const {
+        std::vector<Key> keys;
+        for (const auto &shard : shards) {
+            const std::shared_lock l(shard.mutex);
+            for (const auto &[key, value] : shard.map) {
+                if (pred(key, value)) {
+                    keys.push_back(key);
+                }
+            }
+        }
+        return keys;
+    }
+
+  private:
+    // Keep shards on separate cache lines, so readers of different shards do not share the line of a mutex
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, Pointer> map;
+    };
+
+    struct CacheEntry {
+        const HandleMap *map = nullptr;
+        uint64_t generation = 0;
+        Key key{};
+        const Pointer *value = nullptr;
+    };
+
+    static constexpr size_t CACHE_SIZE = 8;
+
+    void nextGeneration() {
+        // Generations are unique across all maps of this type, so a map created at the address of a destroyed one
+        // never matches the entries cached for the old map
+        generation.store(generationCounter.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    const Shard &getShard(Key key) const { return shards[hashKey(key) % SHARD_COUNT]; }
+    Shard &getShard(Key key) { return shards[hashKey(key) % SHARD_COUNT]; }
+
+    static CacheEntry &getCacheEntry(Key key) {
+        // The cache holds no references, so objects are freed when erased, with the allocator that created them
+        static thread_local std::array<CacheEntry, CACHE_SIZE> cache;
+        return cache[(hashKey(key) / SHARD_COUNT) % CACHE_SIZE];
+    }
+
+    static size_t hashKey(Key key) {
+        // Handles are mostly aligned pointers, mix the bits so the low ones are not always zero
+        auto hash = static_cast<uint64_t>(std::hash<Key>{}(key));
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return static_cast<size_t>(hash);
+    }
+
+    static inline std::atomic<uint64_t> generationCounter{0};
+
+    std::array<Shard, SHARD_COUNT> shards;
+    std::atomic<uint64_t> generation{generationCounter.fetch_add(1, std::memory_order_relaxed) + 1};
+};
+
+} // namespace mlsdk::el::layer
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlsdk::el::utils {
+
+/*******************************************************************************
+ * Host timers
+ *******************************************************************************/
+
+using HostClock = std::chrono::steady_clock;
+
+/**
+ * Distribution of the durations recorded for one host phase.
+ *
+ * Bucket 0 counts durations below one microsecond and bucket i counts durations in [2^(i-1), 2^i) microseconds. The
+ * last bucket also collects everything longer.
+ */
+struct HostTimerHistogram {
+    static constexpr size_t bucketCount = 32;
+
+    void add(uint64_t nanoseconds);
+
+    /**
+     * Return the upper bound, in nanoseconds, of the bucket holding the given fraction of the samples.
+     */
+    uint64_t percentile(double fraction) const;
+
+    uint64_t count{};
+    uint64_t totalNanoseconds{};
+    uint64_t minNanoseconds{};
+    uint64_t maxNanoseconds{};
+    std::array<uint64_t, bucketCount> buckets{};
+};
+
+struct HostTimerEvent {
+    const char *phase{};
+    HostClock::time_point start{};
+    uint64_t nanoseconds{};
+    size_t threadId{};
+};
+
+/**
+ * Thread safe collection of host phase durations. Keeps a histogram per phase and the most recent events for trace
+ * export.
+ */
+class HostTimerRegistry {
+  public:
+    static constexpr size_t defaultEventCapacity = 65536;
+
+    explicit HostTimerRegistry(size_t _eventCapacity = defaultEventCapacity);
+
+    /**
+     * Record a completed phase. Phase names are not copied into the event list and must outlive the registry, so
+     * string literals are expected.
+     */
+    void record(const char *phase, HostClock::time_point start, HostClock::time_point end);
+
+    std::map<std::string, HostTimerHistogram> getHistograms() const;
+    std::vector<HostTimerEvent> getEvents() const;
+
+  private:
+    mutable std::mutex mutex;
+    std::map<std::string, HostTimerHistogram, std::less<>> histograms;
+    std::deque<HostTimerEvent> events;
+    size_t eventCapacity;
+};
+
+/**
+ * Measure the time until the end of the scope, or until stop() is called. The duration is recorded in the registry
+ * and added to the elapsed time, each only if not null. The clock is not read if both are null.
+ */
+class ScopedHostTimer {
+  public:
+    ScopedHostTimer(HostTimerRegistry *_registry, const char *_phase, HostClock::duration *_elapsed = nullptr);
+    ~ScopedHostTimer();
+
+    ScopedHostTimer(const ScopedHostTimer &) = delete;
+    ScopedHostTimer &operator=(const ScopedHostTimer &) = delete;
+
+    void stop();
+
+  private:
+    HostTimerRegistry *registry;
+    const char *phase;
+    HostClock::duration *elapsed;
+    HostClock::time_point start{};
+    bool running;
+};
+
+} // namespace mlsdk::el::utils
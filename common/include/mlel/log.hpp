@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -25,48 +27,112 @@ namespace mlsdk::el::log {
 
 enum class Severity { Error, Warning, Info, Debug };
 
+#ifndef MLEL_COMPILED_LOG_LEVEL
+#define MLEL_COMPILED_LOG_LEVEL Debug
+#endif
+
+/**
+ * Least severe level compiled into the layers, set with the VMEL_COMPILED_LOG_LEVEL CMake option. Entries of less
+ * severe levels are discarded at compile time, whatever the environment asks for.
+ */
+constexpr Severity compiledLogLevel = Severity::MLEL_COMPILED_LOG_LEVEL;
+
+class Log;
+
+/**
+ * Write a log entry whose operands are only evaluated if the severity is enabled. Use it on hot paths and for entries
+ * with operands that are expensive to build, for example:
+ *
+ *   MLEL_LOG(graphLog, Severity::Info) << "tensor=" << *tensor << std::endl;
+ */
+#define MLEL_LOG(log, severity)                                                                                        \
+    if (!(log).enabled(severity)) {                                                                                    \
+    } else                                                                                                             \
+        (log)(severity)
+
 /*******************************************************************************
- * Log
+ * LogStream
  *******************************************************************************/
 
-class Log {
+/**
+ * One log entry being written. Output is only formatted if the severity of the entry is enabled, into a buffer of the
+ * calling thread, and the complete entry is handed to the log when the stream is destroyed at the end of the statement.
+ */
+class LogStream {
   public:
-    Log(const std::string &_environmentVariable, const std::string &_loggerName,
-        Severity _defaultLogLevel = Severity::Error);
+    LogStream() = default;
+    LogStream(const Log &_log, Severity _severity);
+    ~LogStream();
 
-    /**
-     * Output log entry if log level is higher or equal to the severity.
-     */
-    template <typename T> Log &operator<<(const T &output) {
-        if (enabled(severity)) {
+    LogStream(const LogStream &) = delete;
+    LogStream &operator=(const LogStream &) = delete;
+
+    template <typename T> const LogStream &operator<<(const T &output) const {
+        if (os != nullptr) {
             *os << output;
         }
         return *this;
     }
 
-    std::ostream *getStreamMutable() { return os; }
-
     /**
      * Handle std::functions.
      */
-    Log &operator<<(std::ostream &(*f)(std::ostream &));
+    const LogStream &operator<<(std::ostream &(*f)(std::ostream &)) const {
+        if (os != nullptr) {
+            *os << f;
+        }
+        return *this;
+    }
+
+    /**
+     * Return the stream the entry is formatted into, or nullptr if the entry is filtered out.
+     */
+    std::ostream *getStreamMutable() const { return os; }
+
+  private:
+    const Log *log = nullptr;
+    std::ostream *os = nullptr;
+    // Entries written while formatting another entry on the same thread get a buffer of their own
+    std::unique_ptr<std::ostringstream> nestedStream;
+};
+
+/*******************************************************************************
+ * Log
+ *******************************************************************************/
+
+class Log {
+  public:
+    Log(const std::string &_environmentVariable, const std::string &_loggerName,
+        Severity _defaultLogLevel = Severity::Error);
 
     /**
-     * Set log level, output log header and return reference to logger.
+     * Start a log entry of the given severity. The entry is written when the returned stream goes out of scope.
      */
-    Log &operator()(Severity _severity);
+    LogStream operator()(Severity _severity) const {
+        if (!enabled(_severity)) {
+            return LogStream{};
+        }
+        return LogStream{*this, _severity};
+    }
 
     /**
      * Return true if log is enable for severity.
      */
-    bool enabled(Severity _severity) const;
+    bool enabled(Severity _severity) const { return _severity <= compiledLogLevel && logLevel >= _severity; }
+
+    /**
+     * Output a complete entry. Entries are written by a background thread if VMEL_LOG_ASYNC is set, otherwise by the
+     * calling thread.
+     */
+    void write(std::string entry) const;
 
   private:
-    std::string_view severityToString() const;
+    friend class LogStream;
+
+    void writeHeader(std::ostream &stream, Severity severity) const;
 
     Severity logLevel;
     std::string loggerName;
-    Severity severity{Severity::Info};
     std::ostream *os;
 };
 
@@ -79,7 +145,11 @@ template <typename T> auto getValue(T value) {
     }
 };
 
-template <typename T> Log &operator<<(Log &os, const std::vector<T> &v) {
+template <typename T> const LogStream &operator<<(const LogStream &os, const std::vector<T> &v) {
+    if (os.getStreamMutable() == nullptr) {
+        return os;
+    }
+
     os << std::dec << '[';
     auto it = v.begin();
     if (it != v.end()) {
@@ -99,7 +169,7 @@ struct StringLineNumber {
     const std::string &str;
 };
 
-Log &operator<<(Log &os, const StringLineNumber &s);
+const LogStream &operator<<(const LogStream &os, const StringLineNumber &s);
 
 struct HexDump {
     HexDump(const uint8_t *_pointer, const size_t _size, const size_t _width = 16)
@@ -109,6 +179,6 @@ struct HexDump {
     const size_t width;
 };
 
-Log &operator<<(Log &os, const HexDump &dump);
+const LogStream &operator<<(const LogStream &os, const HexDump &dump);
 
 } // namespace mlsdk::el::log
@@ -9,6 +9,8 @@
 /*******************************************************************************
  * Includes
  *******************************************************************************/
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -46,6 +48,16 @@ size_t getElementCount(const std::vector<int64_t> &dimensions);
 
 std::vector<uint32_t> glslToSpirv(const std::string &glsl);
 
+/// Returns true if an environment variable value is set and not one of "0", "false", "off" or "no".
+bool isTruthyEnvironmentValue(const char *value);
+
+/**
+ * Calls func for each index in [0, count) on a persistent pool of up to hardware concurrency threads shared by all
+ * callers, the calling thread being one of them. A single index runs on the calling thread. The first exception thrown
+ * by func is rethrown once all indices are done.
+ */
+void parallelFor(std::size_t count, const std::function<void(std::size_t)> &func);
+
 struct FormatInfo {
     bool isInteger;
     bool isSigned;
@@ -12,6 +12,14 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <vector>
+
 /*******************************************************************************
  * Allocator
  *******************************************************************************/
@@ -65,4 +73,148 @@ template <class T> void destroyObject(const VkAllocationCallbacks *callbacks, T
     (Allocator<T>{callbacks}).deallocate(object, 1);
 }
 
+/*******************************************************************************
+ * Arena
+ *******************************************************************************/
+
+/**
+ * Bump allocator for the transient state built while recording a command buffer.
+ *
+ * Memory is carved out of blocks allocated through the allocation callbacks and is never freed individually. A Scope
+ * rewinds the arena to where it was when the scope was opened, so the blocks are reused by the next recorded command
+ * instead of growing with the command buffer. Like the command buffer owning it, an arena must be externally
+ * synchronized.
+ */
+class Arena {
+  public:
+    explicit Arena(const VkAllocationCallbacks *_callbacks) : callbacks{_callbacks} {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() {
+        for (const auto &block : blocks) {
+            freeBlock(block);
+        }
+    }
+
+    [[nodiscard]] void *allocate(size_t size, size_t alignment) {
+        for (; current < blocks.size(); current++, offset = 0) {
+            if (auto *pointer = allocateFromBlock(blocks[current], size, alignment)) {
+                return pointer;
+            }
+        }
+
+        // Grow geometrically, so a command buffer settles on a few blocks
+        const size_t blockSize = std::max(size + alignment, blocks.empty() ? minBlockSize : blocks.back().size * 2);
+        blocks.push_back(allocateBlock(blockSize));
+        current = blocks.size() - 1;
+        offset = 0;
+        return allocateFromBlock(blocks.back(), size, alignment);
+    }
+
+    /// Release all allocations, keeping only the largest block for the next recording.
+    void reset() {
+        while (blocks.size() > 1) {
+            freeBlock(blocks.front());
+            blocks.erase(blocks.begin());
+        }
+        current = 0;
+        offset = 0;
+    }
+
+    class Scope {
+      public:
+        explicit Scope(Arena &_arena) : arena{_arena}, current{_arena.current}, offset{_arena.offset} {}
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope() {
+            arena.current = current;
+            arena.offset = offset;
+        }
+
+      private:
+        Arena &arena;
+        const size_t current;
+        const size_t offset;
+    };
+
+  private:
+    struct Block {
+        std::byte *data;
+        size_t size;
+    };
+
+    static constexpr size_t minBlockSize = 16 * 1024;
+    static constexpr VkSystemAllocationScope scope = VK_SYSTEM_ALLOCATION_SCOPE_OBJECT;
+
+    void *allocateFromBlock(const Block &block, size_t size, size_t alignment) {
+        const auto address = reinterpret_cast<uintptr_t>(block.data) + offset;
+        const auto padding = (alignment - address % alignment) % alignment;
+        if (padding + size > block.size - offset) {
+            return nullptr;
+        }
+        offset += padding + size;
+        return reinterpret_cast<void *>(address + padding);
+    }
+
+    Block allocateBlock(size_t size) const {
+        void *data = callbacks != nullptr
+                         ? callbacks->pfnAllocation(callbacks->pUserData, size, alignof(std::max_align_t), scope)
+                         : ::malloc(size);
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        return {static_cast<std::byte *>(data), size};
+    }
+
+    void freeBlock(const Block &block) const {
+        if (callbacks != nullptr) {
+            callbacks->pfnFree(callbacks->pUserData, block.data);
+        } else {
+            ::free(block.data);
+        }
+    }
+
+    const VkAllocationCallbacks *callbacks;
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t offset = 0;
+};
+
+/**
+ * Container allocator drawing from an Arena, or from the heap when constructed without one. Containers of the same
+ * type can therefore hold either persistent or per-command state.
+ */
+template <class T> struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(Arena *_arena) noexcept : arena{_arena} {}
+    template <class U> ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena{other.arena} {}
+
+    [[nodiscard]] T *allocate(std::size_t n) const {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if (arena != nullptr) {
+            return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t) const noexcept {
+        if (arena == nullptr) {
+            ::operator delete(pointer);
+        }
+    }
+
+    template <class U> bool operator==(const ArenaAllocator<U> &other) const noexcept { return arena == other.arena; }
+    template <class U> bool operator!=(const ArenaAllocator<U> &other) const noexcept { return arena != other.arena; }
+
+    Arena *arena = nullptr;
+};
+
+template <class T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
 } // namespace mlsdk::el::layer
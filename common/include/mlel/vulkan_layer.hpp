@@ -10,6 +10,7 @@
  * Includes
  *******************************************************************************/
 
+#include "mlel/handle_map.hpp"
 #include "mlel/log.hpp"
 #include "mlel/vulkan_allocator.hpp"
 
@@ -303,7 +304,7 @@ class CommandBuffer : public Loader {
     explicit CommandBuffer(const std::shared_ptr<Device> &_device, VkCommandBuffer _commandBuffer,
                            VkCommandPool _commandPool, uint32_t _queueFamilyIndex)
         : Loader(_device->loader), device{_device}, commandBuffer{_commandBuffer}, commandPool{_commandPool},
-          queueFamilyIndex{_queueFamilyIndex} {}
+          queueFamilyIndex{_queueFamilyIndex}, arena{_device->callbacks} {}
 
     virtual ~CommandBuffer() {
         if (secondaryCommandBuffer != VK_NULL_HANDLE) {
@@ -346,6 +347,9 @@ class CommandBuffer : public Loader {
     VkPipelineLayout pipelineLayout = {};
     std::map<uint32_t, VkDescriptorSet> descriptorSets;
 
+    // Transient state of the command being recorded, reset when the command buffer is reset
+    Arena arena;
+
   private:
     VkCommandBuffer createSecondaryCommandBuffer() const {
         VkCommandBuffer cmd;
@@ -629,12 +633,9 @@ class VulkanLayer {
             return ret;
         }
 
-        {
-            scopedMutex l(globalMutex);
-            instanceMap[*instance] =
-                std::allocate_shared<Instance>(Allocator<Instance>{allocator}, *instance, getInstanceProcAddr,
-                                               allocator, getInstanceProcAddr, getNextPhysicalDeviceProcAddr);
-        }
+        auto handle = std::allocate_shared<Instance>(Allocator<Instance>{allocator}, *instance, getInstanceProcAddr,
+                                                     allocator, getInstanceProcAddr, getNextPhysicalDeviceProcAddr);
+        instanceMap.insert(*instance, std::move(handle));
         return VK_SUCCESS;
     }
 
@@ -642,20 +643,11 @@ class VulkanLayer {
         auto handle = getHandle(instance);
         handle->loader->vkDestroyInstance(instance, allocator);
 
-        {
-            scopedMutex l(globalMutex);
-
-            instanceMap.erase(instance);
+        instanceMap.erase(instance);
 
-            // Erase physical devices referencing handle
-            for (auto it = physicalDeviceMap.begin(); it != physicalDeviceMap.end();) {
-                if (it->second->instance == handle) {
-                    it = physicalDeviceMap.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        }
+        // Erase physical devices referencing handle
+        physicalDeviceMap.eraseIf(
+            [&handle](auto, const auto &physicalDevice) { return physicalDevice->instance == handle; });
     }
 
     static VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstance instance, uint32_t *physicalDeviceCount,
@@ -667,14 +659,11 @@ class VulkanLayer {
             return res;
         }
 
-        {
-            scopedMutex l(globalMutex);
-
-            if (physicalDevices != nullptr) {
-                for (uint32_t i = 0; i < *physicalDeviceCount; i++) {
-                    physicalDeviceMap[physicalDevices[i]] = std::allocate_shared<PhysicalDevice>(
-                        Allocator<PhysicalDevice>{handle->callbacks}, handle, physicalDevices[i]);
-                }
+        if (physicalDevices != nullptr) {
+            for (uint32_t i = 0; i < *physicalDeviceCount; i++) {
+                auto physicalDevice = std::allocate_shared<PhysicalDevice>(Allocator<PhysicalDevice>{handle->callbacks},
+                                                                           handle, physicalDevices[i]);
+                physicalDeviceMap.insert(physicalDevices[i], std::move(physicalDevice));
             }
         }
 
@@ -876,11 +865,8 @@ class VulkanLayer {
             return res;
         }
 
-        {
-            scopedMutex l(globalMutex);
-            deviceMap[*device] = std::allocate_shared<DeviceImpl>(Allocator<DeviceImpl>{allocator}, handle, *device,
-                                                                  getInstanceProcAddr, getDeviceProcAddr, allocator);
-        }
+        deviceMap.insert(*device, std::allocate_shared<DeviceImpl>(Allocator<DeviceImpl>{allocator}, handle, *device,
+                                                                   getInstanceProcAddr, getDeviceProcAddr, allocator));
 
         return VK_SUCCESS;
     }
@@ -889,16 +875,6 @@ class VulkanLayer {
      * Device
      *******************************************************************************/
 
-    template <typename T, typename U, typename Pred> static void erase_if(std::map<T, U> &map, Pred pred) {
-        for (auto it = map.begin(); it != map.end();) {
-            if (pred(it)) {
-                it = map.erase(it);
-            } else {
-                it++;
-            }
-        }
-    }
-
     static void VKAPI_CALL vkDestroyDevice(VkDevice device, const VkAllocationCallbacks *allocator) {
         std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> loader;
 
@@ -906,19 +882,19 @@ class VulkanLayer {
             // declare handle here to ensure no references to DeviceImpl escape this scope
             auto handle = getHandle(device);
             loader = handle->loader;
-            scopedMutex l(globalMutex);
 
             // Erase device map
             deviceMap.erase(device);
 
             // Erase queue maps
-            erase_if(queueMap, [handle](auto it) { return it->second == handle; });
+            queueMap.eraseIf([&handle](auto, const auto &queue) { return queue == handle; });
 
             // Erase command pool maps
-            erase_if(commandPoolMap, [handle](auto it) { return it->second->device == handle; });
+            commandPoolMap.eraseIf([&handle](auto, const auto &commandPool) { return commandPool->device == handle; });
 
             // Erase command buffer maps
-            erase_if(commandBufferMap, [handle](auto it) { return it->second->device == handle; });
+            commandBufferMap.eraseIf(
+                [&handle](auto, const auto &commandBuffer) { return commandBuffer->device == handle; });
 
             // Assert no more references to this device exist
             assert(handle.use_count() == 1);
@@ -939,10 +915,7 @@ class VulkanLayer {
             return result;
         }
 
-        {
-            scopedMutex l(globalMutex);
-            commandPoolMap[*commandPool] = std::make_shared<CommandPool>(handle, createInfo);
-        }
+        commandPoolMap.insert(*commandPool, std::make_shared<CommandPool>(handle, createInfo));
 
         return VK_SUCCESS;
     }
@@ -951,13 +924,10 @@ class VulkanLayer {
                                                 const VkAllocationCallbacks *allocator) {
         auto handle = getHandle(device);
 
-        {
-            scopedMutex l(globalMutex);
-            erase_if(commandBufferMap, [handle, commandPool](auto it) {
-                return it->second->device == handle && it->second->commandPool == commandPool;
-            });
-            commandPoolMap.erase(commandPool);
-        }
+        commandBufferMap.eraseIf([&handle, commandPool](auto, const auto &commandBuffer) {
+            return commandBuffer->device == handle && commandBuffer->commandPool == commandPool;
+        });
+        commandPoolMap.erase(commandPool);
 
         handle->loader->vkDestroyCommandPool(device, commandPool, allocator);
     }
@@ -971,20 +941,14 @@ class VulkanLayer {
         auto handle = getHandle(device);
         handle->loader->vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, queue);
 
-        {
-            scopedMutex l(globalMutex);
-            queueMap[*queue] = std::move(handle);
-        }
+        queueMap.insert(*queue, std::move(handle));
     }
 
     static void VKAPI_CALL vkGetDeviceQueue2(VkDevice device, const VkDeviceQueueInfo2 *queueInfo, VkQueue *queue) {
         auto handle = getHandle(device);
         handle->loader->vkGetDeviceQueue2(device, queueInfo, queue);
 
-        {
-            scopedMutex l(globalMutex);
-            queueMap[*queue] = std::move(handle);
-        }
+        queueMap.insert(*queue, std::move(handle));
     }
 
     /**************************************************************************
@@ -999,8 +963,7 @@ class VulkanLayer {
         auto res = handle->loader->vkCreateDescriptorSetLayout(device, createInfo, allocator, setLayout);
 
         if (res == VK_SUCCESS) {
-            scopedMutex l(globalMutex);
-            descriptorSetLayoutMap[*setLayout] = std::make_shared<DescriptorSetLayout>(createInfo);
+            descriptorSetLayoutMap.insert(*setLayout, std::make_shared<DescriptorSetLayout>(createInfo));
         }
 
         return res;
@@ -1011,10 +974,7 @@ class VulkanLayer {
         auto handle = getHandle(device);
         handle->loader->vkDestroyDescriptorSetLayout(device, descriptorSetLayout, allocator);
 
-        {
-            scopedMutex l(globalMutex);
-            descriptorSetLayoutMap.erase(descriptorSetLayout);
-        }
+        descriptorSetLayoutMap.erase(descriptorSetLayout);
     }
 
     /*******************************************************************************
@@ -1030,18 +990,15 @@ class VulkanLayer {
             return result;
         }
 
-        {
-            scopedMutex l(globalMutex);
-
-            uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            if (const auto it = commandPoolMap.find(allocateInfo->commandPool); it != commandPoolMap.end()) {
-                queueFamilyIndex = it->second->queueFamilyIndex;
-            }
+        uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        if (const auto commandPool = commandPoolMap.find(allocateInfo->commandPool)) {
+            queueFamilyIndex = commandPool->queueFamilyIndex;
+        }
 
-            for (unsigned int i = 0; i < allocateInfo->commandBufferCount; i++) {
-                commandBufferMap[commandBuffers[i]] = std::make_shared<CommandBuffer>(
-                    handle, commandBuffers[i], allocateInfo->commandPool, queueFamilyIndex);
-            }
+        for (unsigned int i = 0; i < allocateInfo->commandBufferCount; i++) {
+            commandBufferMap.insert(commandBuffers[i], std::make_shared<CommandBuffer>(handle, commandBuffers[i],
+                                                                                       allocateInfo->commandPool,
+                                                                                       queueFamilyIndex));
         }
 
         return VK_SUCCESS;
@@ -1052,44 +1009,34 @@ class VulkanLayer {
         auto handle = getHandle(device);
         handle->loader->vkFreeCommandBuffers(device, commandPool, commandBufferCount, commandBuffers);
 
-        {
-            scopedMutex l(globalMutex);
-
-            for (unsigned int i = 0; i < commandBufferCount; i++) {
-                commandBufferMap.erase(commandBuffers[i]);
-            }
+        for (unsigned int i = 0; i < commandBufferCount; i++) {
+            commandBufferMap.erase(commandBuffers[i]);
         }
     }
 
   protected:
     static std::shared_ptr<Instance> getHandle(const VkInstance handle) {
-        scopedMutex l(globalMutex);
-        return instanceMap[handle];
+        return instanceMap.find(handle);
     }
 
     static std::shared_ptr<PhysicalDevice> getHandle(const VkPhysicalDevice handle) {
-        scopedMutex l(globalMutex);
-        return physicalDeviceMap[handle];
+        return physicalDeviceMap.find(handle);
     }
 
     static std::shared_ptr<DeviceImpl> getHandle(const VkDevice handle) {
-        scopedMutex l(globalMutex);
-        return deviceMap[handle];
+        return deviceMap.find(handle);
     }
 
     static std::shared_ptr<DescriptorSetLayout> getHandle(const VkDescriptorSetLayout handle) {
-        scopedMutex l(globalMutex);
-        return descriptorSetLayoutMap[handle];
+        return descriptorSetLayoutMap.find(handle);
     }
 
     static std::shared_ptr<DeviceImpl> getHandle(const VkQueue handle) {
-        scopedMutex l(globalMutex);
-        return queueMap[handle];
+        return queueMap.find(handle);
     }
 
     static std::shared_ptr<CommandBuffer> getHandle(const VkCommandBuffer handle) {
-        scopedMutex l(globalMutex);
-        return commandBufferMap[handle];
+        return commandBufferMap.find(handle);
     }
 
     static VkLayerInstanceCreateInfo *findInstanceCreateInfo(const VkInstanceCreateInfo *createInfo) {
@@ -1118,16 +1065,17 @@ class VulkanLayer {
         return nullptr;
     }
 
+    // Guards state the derived layers keep beside the handle maps, which synchronize themselves
     static inline std::recursive_mutex globalMutex;
     using scopedMutex = std::lock_guard<std::recursive_mutex>;
 
-    static inline std::map<VkInstance, std::shared_ptr<Instance>> instanceMap;
-    static inline std::map<VkPhysicalDevice, std::shared_ptr<PhysicalDevice>> physicalDeviceMap;
-    static inline std::map<VkDevice, std::shared_ptr<DeviceImpl>> deviceMap;
-    static inline std::map<VkDescriptorSetLayout, std::shared_ptr<DescriptorSetLayout>> descriptorSetLayoutMap;
-    static inline std::map<VkQueue, std::shared_ptr<DeviceImpl>> queueMap;
-    static inline std::map<VkCommandPool, std::shared_ptr<CommandPool>> commandPoolMap;
-    static inline std::map<VkCommandBuffer, std::shared_ptr<CommandBuffer>> commandBufferMap;
+    static inline HandleMap<VkInstance, Instance> instanceMap;
+    static inline HandleMap<VkPhysicalDevice, PhysicalDevice> physicalDeviceMap;
+    static inline HandleMap<VkDevice, DeviceImpl> deviceMap;
+    static inline HandleMap<VkDescriptorSetLayout, DescriptorSetLayout> descriptorSetLayoutMap;
+    static inline HandleMap<VkQueue, DeviceImpl> queueMap;
+    static inline HandleMap<VkCommandPool, CommandPool> commandPoolMap;
+    static inline HandleMap<VkCommandBuffer, CommandBuffer> commandBufferMap;
 };
 
 } // namespace mlsdk::el::layer
@@ -9,13 +9,19 @@
  *******************************************************************************/
 
 #include "mlel/log.hpp"
+#include "mlel/utils.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <ctime>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 /*******************************************************************************
  * Log
@@ -64,34 +70,244 @@ std::string currentTimestamp() {
               << milliseconds.count() << ' ';
     return timestamp.str();
 }
+
+std::string_view severityToString(const Severity severity) {
+    const auto index = size_t(severity);
+    return index >= stringToSeverity.size() ? "Unknown" : stringToSeverity[index].first;
+}
+
+/*******************************************************************************
+ * EntryQueue
+ *******************************************************************************/
+
+/**
+ * Bounded lock-free queue of log entries, for any number of producers and a single consumer. Every slot carries a
+ * sequence number telling whether it is free for the producer claiming that position, or holds an entry for the
+ * consumer.
+ */
+class EntryQueue {
+  public:
+    struct Entry {
+        std::ostream *os = nullptr;
+        std::string text;
+    };
+
+    EntryQueue() {
+        for (size_t i = 0; i < slots.size(); i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(Entry &entry) {
+        auto position = pushPosition.load(std::memory_order_relaxed);
+        while (true) {
+            auto &slot = slots[position % slots.size()];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.entry = std::move(entry);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false; // Full, the consumer has not freed this slot yet
+            } else {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(Entry &entry) {
+        auto &slot = slots[popPosition % slots.size()];
+        if (slot.sequence.load(std::memory_order_acquire) != popPosition + 1) {
+            return false;
+        }
+        entry = std::move(slot.entry);
+        slot.sequence.store(popPosition + slots.size(), std::memory_order_release);
+        popPosition++;
+        return true;
+    }
+
+    bool empty() const {
+        return slots[popPosition % slots.size()].sequence.load(std::memory_order_acquire) != popPosition + 1;
+    }
+
+  private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Entry entry;
+    };
+
+    std::array<Slot, 1024> slots;
+    alignas(64) std::atomic<size_t> pushPosition{0};
+    alignas(64) size_t popPosition{0};
+};
+
+/*******************************************************************************
+ * AsyncWriter
+ *******************************************************************************/
+
+std::atomic<bool> isAsyncWriterStopped{false};
+
+/**
+ * Writes queued entries from a background thread, so threads logging never wait for the output.
+ */
+class AsyncWriter {
+  public:
+    AsyncWriter() : thread{[this] { run(); }} {}
+
+    ~AsyncWriter() {
+        isAsyncWriterStopped = true;
+        {
+            const std::scoped_lock lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        thread.join();
+    }
+
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+    void push(std::ostream *os, std::string text) {
+        EntryQueue::Entry entry{os, std::move(text)};
+        // Wait for the writer to make room rather than dropping or reordering entries
+        while (!queue.tryPush(entry)) {
+            condition.notify_one();
+            std::this_thread::yield();
+        }
+        if (isWaiting) {
+            condition.notify_one();
+        }
+    }
+
+  private:
+    void run() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (stopping && queue.empty()) {
+                return;
+            }
+
+            // The timeout bounds the delay of an entry pushed just before the writer started waiting
+            isWaiting = true;
+            condition.wait_for(lock, std::chrono::milliseconds(10), [this] { return stopping || !queue.empty(); });
+            isWaiting = false;
+        }
+    }
+
+    void drain() {
+        EntryQueue::Entry entry;
+        std::ostream *lastStream = nullptr;
+        while (queue.tryPop(entry)) {
+            *entry.os << entry.text;
+            if (lastStream != nullptr && lastStream != entry.os) {
+                lastStream->flush();
+            }
+            lastStream = entry.os;
+        }
+        if (lastStream != nullptr) {
+            lastStream->flush();
+        }
+    }
+
+    EntryQueue queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<bool> isWaiting{false};
+    bool stopping{};
+    std::thread thread;
+};
+
+AsyncWriter *getAsyncWriter() {
+    static const bool isAsync = utils::isTruthyEnvironmentValue(std::getenv("VMEL_LOG_ASYNC"));
+    if (!isAsync) {
+        return nullptr;
+    }
+
+    static AsyncWriter writer;
+    return isAsyncWriterStopped ? nullptr : &writer;
+}
+
+std::mutex &getOutputMutex() {
+    static std::mutex outputMutex;
+    return outputMutex;
+}
+
+/*******************************************************************************
+ * Entry buffers
+ *******************************************************************************/
+
+struct EntryBuffer {
+    std::ostringstream stream;
+    bool isInUse = false;
+};
+
+thread_local EntryBuffer entryBuffer;
 } // namespace
 
-Log::Log(const std::string &_environmentVariable, const std::string &_loggerName, const Severity _defaultLogLevel)
-    : logLevel{getLogLevel(_environmentVariable, _defaultLogLevel)}, loggerName(_loggerName), os(&std::cout) {}
+/*******************************************************************************
+ * LogStream
+ *******************************************************************************/
 
-Log &Log::operator<<(std::ostream &(*f)(std::ostream &)) {
-    if (enabled(severity)) {
-        *os << f;
+LogStream::LogStream(const Log &_log, const Severity _severity) : log{&_log} {
+    if (entryBuffer.isInUse) {
+        nestedStream = std::make_unique<std::ostringstream>();
+        os = nestedStream.get();
+    } else {
+        // Reuse the buffer of the thread, without the text and formatting left by the previous entry
+        static const std::ostringstream defaultStream;
+        entryBuffer.isInUse = true;
+        entryBuffer.stream.str({});
+        entryBuffer.stream.clear();
+        entryBuffer.stream.copyfmt(defaultStream);
+        os = &entryBuffer.stream;
     }
-    return *this;
+    log->writeHeader(*os, _severity);
 }
 
-Log &Log::operator()(const Severity _severity) {
-    severity = _severity;
-    if (enabled(severity)) {
-        *os << currentTimestamp() << '[' << loggerName << "][" << severityToString() << "] ";
+LogStream::~LogStream() {
+    if (os == nullptr) {
+        return;
+    }
+
+    if (nestedStream) {
+        log->write(nestedStream->str());
+    } else {
+        log->write(entryBuffer.stream.str());
+        entryBuffer.isInUse = false;
     }
-    return *this;
 }
 
-bool Log::enabled(const Severity _severity) const { return logLevel >= _severity; }
+/*******************************************************************************
+ * Log
+ *******************************************************************************/
 
-std::string_view Log::severityToString() const {
-    const auto index = size_t(severity);
-    return index >= stringToSeverity.size() ? "Unknown" : stringToSeverity[index].first;
+Log::Log(const std::string &_environmentVariable, const std::string &_loggerName, const Severity _defaultLogLevel)
+    : logLevel{getLogLevel(_environmentVariable, _defaultLogLevel)}, loggerName(_loggerName), os(&std::cout) {}
+
+void Log::write(std::string entry) const {
+    if (auto *asyncWriter = getAsyncWriter()) {
+        asyncWriter->push(os, std::move(entry));
+        return;
+    }
+
+    const std::scoped_lock lock(getOutputMutex());
+    *os << entry << std::flush;
+}
+
+void Log::writeHeader(std::ostream &stream, const Severity severity) const {
+    stream << currentTimestamp() << '[' << loggerName << "][" << severityToString(severity) << "] ";
 }
 
-Log &operator<<(Log &os, const StringLineNumber &s) {
+const LogStream &operator<<(const LogStream &os, const StringLineNumber &s) {
+    if (os.getStreamMutable() == nullptr) {
+        return os;
+    }
+
     std::string::size_type pastPos{};
     unsigned line{1};
     os << std::resetiosflags(std::ios_base::dec) << '\n';
@@ -103,7 +319,11 @@ Log &operator<<(Log &os, const StringLineNumber &s) {
     return os;
 }
 
-Log &operator<<(Log &os, const HexDump &dump) {
+const LogStream &operator<<(const LogStream &os, const HexDump &dump) {
+    if (os.getStreamMutable() == nullptr) {
+        return os;
+    }
+
     std::ios osStateOrig(nullptr);
     osStateOrig.copyfmt(*(os.getStreamMutable()));
 
@@ -11,8 +11,18 @@
 #include "mlel/utils.hpp"
 #include "mlel/log.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <vector>
 
 #include <glslang/Include/glslang_c_interface.h>
 #include <glslang/Public/resource_limits_c.h>
@@ -105,6 +115,167 @@ std::vector<uint32_t> glslToSpirv(const std::string &glsl) {
     return spirv;
 }
 
+bool isTruthyEnvironmentValue(const char *value) {
+    if (value == nullptr || value[0] == '\0') {
+        return false;
+    }
+
+    std::string str{value};
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](const unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return str != "0" && str != "false" && str != "off" && str != "no";
+}
+
+namespace {
+
+/*******************************************************************************
+ * WorkerPool
+ *******************************************************************************/
+
+std::atomic<bool> isWorkerPoolStopped{false};
+
+/**
+ * Threads shared by the parallel loops of all layers, created with the first loop that has more than one index. The
+ * calling thread of a loop works on it along with the idle workers, so a loop completes even when every worker is busy,
+ * including loops started from within another loop.
+ */
+class WorkerPool {
+  public:
+    class Job {
+      public:
+        Job(std::size_t _count, const std::function<void(std::size_t)> &_func) : count{_count}, func{_func} {}
+
+        /// Run indices until none are left to claim.
+        void work() {
+            for (auto i = next++; i < count; i = next++) {
+                try {
+                    func(i);
+                } catch (...) {
+                    const std::scoped_lock l(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+
+                if (++done == count) {
+                    const std::scoped_lock l(mutex);
+                    condition.notify_all();
+                }
+            }
+        }
+
+        /// Wait for all indices to complete, then rethrow the first exception thrown by func.
+        void wait() {
+            std::unique_lock l(mutex);
+            condition.wait(l, [this] { return done == count; });
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+      private:
+        const std::size_t count;
+        const std::function<void(std::size_t)> &func;
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::exception_ptr error;
+    };
+
+    explicit WorkerPool(std::size_t threadCount) {
+        threads.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back([this] { run(); });
+        }
+    }
+
+    ~WorkerPool() {
+        isWorkerPoolStopped = true;
+        {
+            const std::scoped_lock l(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void post(const std::shared_ptr<Job> &job) {
+        {
+            const std::scoped_lock l(mutex);
+            jobs.push_back(job);
+        }
+        condition.notify_all();
+    }
+
+    void remove(const std::shared_ptr<Job> &job) {
+        const std::scoped_lock l(mutex);
+        jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+    }
+
+  private:
+    void run() {
+        std::unique_lock l(mutex);
+        while (true) {
+            condition.wait(l, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+
+            // Workers keep the job alive, the loop may return as soon as its last index completes
+            const auto job = jobs.front();
+            l.unlock();
+            job->work();
+            l.lock();
+
+            // All indices of the job are claimed once work returns
+            if (!jobs.empty() && jobs.front() == job) {
+                jobs.pop_front();
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::shared_ptr<Job>> jobs;
+    bool stopping{};
+    std::vector<std::thread> threads;
+};
+
+WorkerPool *getWorkerPool() {
+    static const auto threadCount = std::max(1U, std::thread::hardware_concurrency());
+    if (threadCount <= 1) {
+        return nullptr;
+    }
+
+    // The calling thread of a loop is one of the threads working on it
+    static WorkerPool pool(threadCount - 1);
+    return isWorkerPoolStopped ? nullptr : &pool;
+}
+
+} // namespace
+
+void parallelFor(std::size_t count, const std::function<void(std::size_t)> &func) {
+    auto *pool = count > 1 ? getWorkerPool() : nullptr;
+    if (pool == nullptr) {
+        for (std::size_t i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    const auto job = std::make_shared<WorkerPool::Job>(count, func);
+    pool->post(job);
+    job->work();
+    pool->remove(job);
+    job->wait();
+}
+
 namespace {
 // Type tags are local shader constants defined in graph/shaders/graph_op/common.comp.
 // They are encoded as two ASCII bytes: kind ('b', 'i', 'u', 'f') followed by byte size or reduced-float subtype.
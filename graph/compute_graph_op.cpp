@@ -508,6 +508,52 @@ void ComputePipelineBase::pushDescendant(const std::shared_ptr<VirtualTensor> &t
 
 const std::string &ComputePipelineBase::getDebugName() const { return debugName; }
 
+CostEstimate ComputePipelineBase::getCostEstimate() const {
+    auto estimate = getMemoryCostEstimate();
+    if (pipelineLayout) {
+        for (const auto &descriptor : pipelineLayout->getDescriptorMap()) {
+            if (descriptor.direction == Output && descriptor.tensor) {
+                estimate.flops += descriptor.tensor->getShapeSize();
+            }
+        }
+    }
+    return estimate;
+}
+
+uint64_t ComputePipelineBase::getUsefulInvocationCount() const {
+    if (!pipelineLayout) {
+        return 0;
+    }
+
+    for (const auto &descriptor : pipelineLayout->getDescriptorMap()) {
+        if (descriptor.direction == Output && descriptor.tensor) {
+            return descriptor.tensor->getShapeSize();
+        }
+    }
+    return 0;
+}
+
+CostEstimate ComputePipelineBase::getMemoryCostEstimate() const {
+    CostEstimate estimate;
+    if (!pipelineLayout) {
+        return estimate;
+    }
+
+    // Every bound tensor is assumed to be touched exactly once, which is the compulsory traffic of the op
+    for (const auto &descriptor : pipelineLayout->getDescriptorMap()) {
+        if (!descriptor.tensor) {
+            continue;
+        }
+        auto &bytes = descriptor.direction == Output ? estimate.bytesWritten : estimate.bytesRead;
+        bytes += descriptor.tensor->getSize();
+    }
+    return estimate;
+}
+
+const std::shared_ptr<TensorDescriptor> &ComputePipelineBase::getDescriptorTensor(size_t index) const {
+    return pipelineLayout->getDescriptorMap().at(index).tensor;
+}
+
 /*******************************************************************************
  * ComputePipeline
  *******************************************************************************/
@@ -602,6 +648,13 @@ Argmax::Argmax(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       {_input->getRank(), _output->getRank()}),
       pushConstant{createPushConstant(_axis, _nanMode)} {}
 
+CostEstimate Argmax::getCostEstimate() const {
+    // One comparison per input element
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = getDescriptorTensor(1)->getShapeSize();
+    return estimate;
+}
+
 Argmax::PushConstant Argmax::createPushConstant(const uint32_t axis, const uint32_t nanMode) const {
     PushConstant constant = {
         axis,
@@ -701,6 +754,15 @@ AvgPool2D::AvgPool2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::Dispatc
                       _pipelineCache, createSpirv(_pipelineCache, _output, _accType), debugName),
       pushConstant{createPushConstant(_kernel, _stride, _pad, _inputZeroPoint, _outputZeroPoint)} {}
 
+CostEstimate AvgPool2D::getCostEstimate() const {
+    // One accumulation per kernel element and one division per output element
+    const auto &output = getDescriptorTensor(0);
+    const auto kernelSize = static_cast<uint64_t>(pushConstant.kernel[0]) * pushConstant.kernel[1];
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = output->getShapeSize() * (kernelSize + 1);
+    return estimate;
+}
+
 AvgPool2D::PushConstant AvgPool2D::createPushConstant(const std::vector<int32_t> &kernel,
                                                       const std::vector<int32_t> &stride,
                                                       const std::vector<int32_t> &pad, const int8_t inputZeroPoint,
@@ -769,6 +831,8 @@ Cast::Cast(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDyn
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _output), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _input, _output), debugName, {_input->getRank()}) {}
 
+CostEstimate Cast::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Cast::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                         const std::shared_ptr<TensorDescriptor> &output) const {
     // Configure descriptor map
@@ -864,6 +928,12 @@ Concat::Concat(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       _pipelineCache, createSpirv(_pipelineCache, _output), debugName, {_input->getRank()}),
       pushConstant{createPushConstant(_axis, _offset)} {}
 
+CostEstimate Concat::getCostEstimate() const {
+    // Each dispatch copies one input into its slice of the output
+    const auto bytes = getDescriptorTensor(1)->getSize();
+    return {0, bytes, bytes};
+}
+
 Concat::PushConstant Concat::createPushConstant(const uint32_t axis, const uint32_t offset) const {
     PushConstant constant = {
         axis,
@@ -922,6 +992,16 @@ Conv2D::Conv2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       createSpirv(_pipelineCache, _input, _output, _weights, _accType), debugName),
       pushConstant{createPushConstant(_pad, _stride, _dilation, _inputZeroPoint, _weightZeroPoint)} {}
 
+CostEstimate Conv2D::getCostEstimate() const {
+    // Weights are [OC, KH, KW, IC], so every output element takes KH * KW * IC multiply-accumulates
+    const auto &output = getDescriptorTensor(0);
+    const auto &weights = getDescriptorTensor(2);
+    const auto macsPerOutput = weights->getShapeSize() / static_cast<size_t>(weights->getDimensions()[0]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 2 * output->getShapeSize() * macsPerOutput;
+    return estimate;
+}
+
 Conv2D::PushConstant Conv2D::createPushConstant(const std::vector<int32_t> &pad, const std::vector<int32_t> &stride,
                                                 const std::vector<int32_t> &dilation, const int8_t inputZeroPoint,
                                                 const int8_t weightZeroPoint) const {
@@ -1016,6 +1096,16 @@ Conv3D::Conv3D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       createSpirv(_pipelineCache, _input, _output, _weights, _accType), debugName),
       pushConstant{createPushConstant(_pad, _stride, _dilation, _inputZeroPoint, _weightZeroPoint)} {}
 
+CostEstimate Conv3D::getCostEstimate() const {
+    // Weights are [OC, KD, KH, KW, IC], so every output element takes KD * KH * KW * IC multiply-accumulates
+    const auto &output = getDescriptorTensor(0);
+    const auto &weights = getDescriptorTensor(2);
+    const auto macsPerOutput = weights->getShapeSize() / static_cast<size_t>(weights->getDimensions()[0]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 2 * output->getShapeSize() * macsPerOutput;
+    return estimate;
+}
+
 Conv3D::PushConstant Conv3D::createPushConstant(const std::vector<int32_t> &pad, const std::vector<int32_t> &stride,
                                                 const std::vector<int32_t> &dilation, const int8_t inputZeroPoint,
                                                 const int8_t weightZeroPoint) const {
@@ -1106,6 +1196,16 @@ DepthwiseConv2D::DepthwiseConv2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::det
                       createSpirv(_pipelineCache, _input, _output, _weights, _accType), debugName),
       pushConstant{createPushConstant(_pad, _stride, _dilation, _inputZeroPoint, _weightZeroPoint)} {}
 
+CostEstimate DepthwiseConv2D::getCostEstimate() const {
+    // Weights are [KH, KW, C, M], so every output element takes KH * KW multiply-accumulates
+    const auto &output = getDescriptorTensor(0);
+    const auto &dimensions = getDescriptorTensor(2)->getDimensions();
+    const auto macsPerOutput = static_cast<uint64_t>(dimensions[0] * dimensions[1]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 2 * output->getShapeSize() * macsPerOutput;
+    return estimate;
+}
+
 DepthwiseConv2D::PushConstant DepthwiseConv2D::createPushConstant(const std::vector<int32_t> &pad,
                                                                   const std::vector<int32_t> &stride,
                                                                   const std::vector<int32_t> &dilation,
@@ -1287,6 +1387,15 @@ Fft2D::Fft2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderD
                       {&pushConstant, sizeof(pushConstant)}, _pipelineCache, createSpirv(_pipelineCache), debugName),
       pushConstant{createPushConstant(_inverse)} {}
 
+CostEstimate Fft2D::getCostEstimate() const {
+    // Radix-2 estimate of 5 * N * log2(N) operations for each of the [N, H, W] complex transforms
+    const auto &dimensions = getDescriptorTensor(0)->getDimensions();
+    const auto points = static_cast<double>(dimensions[1] * dimensions[2]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = static_cast<uint64_t>(5.0 * static_cast<double>(dimensions[0]) * points * std::log2(points));
+    return estimate;
+}
+
 Fft2D::PushConstant Fft2D::createPushConstant(const bool inverse) const {
     float signValue = inverse ? -1.0f : 1.0f;
     PushConstant constant = {
@@ -1328,6 +1437,8 @@ Gather::Gather(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
     : ComputePipeline(_loader, _device, createDescriptorMap(_values, _indices, _output), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _indices, _output), debugName, {}) {}
 
+CostEstimate Gather::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Gather::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &values,
                                           const std::shared_ptr<TensorDescriptor> &indices,
                                           const std::shared_ptr<TensorDescriptor> &output) const {
@@ -1372,6 +1483,15 @@ Matmul::Matmul(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       createSpirv(_pipelineCache, _input1, _output), debugName),
       pushConstant{createPushConstant(_inputZeroPoint1, _inputZeroPoint2)} {}
 
+CostEstimate Matmul::getCostEstimate() const {
+    // [N, H, C] x [N, C, W] takes C multiply-accumulates per output element
+    const auto &output = getDescriptorTensor(0);
+    const auto channels = static_cast<uint64_t>(getDescriptorTensor(1)->getDimensions()[2]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 2 * output->getShapeSize() * channels;
+    return estimate;
+}
+
 Matmul::PushConstant Matmul::createPushConstant(const int32_t inputZeroPoint1, const int32_t inputZeroPoint2) const {
     PushConstant constant = {
         inputZeroPoint1,
@@ -1427,6 +1547,15 @@ MaxPool2D::MaxPool2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::Dispatc
                       _pipelineCache, createSpirv(_pipelineCache, _output, _nanMode), debugName),
       pushConstant{createPushConstant(_kernel, _stride, _pad, _nanMode)} {}
 
+CostEstimate MaxPool2D::getCostEstimate() const {
+    // One comparison per kernel element
+    const auto &output = getDescriptorTensor(0);
+    const auto kernelSize = static_cast<uint64_t>(pushConstant.kernel[0]) * pushConstant.kernel[1];
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = output->getShapeSize() * kernelSize;
+    return estimate;
+}
+
 MaxPool2D::PushConstant MaxPool2D::createPushConstant(const std::vector<int32_t> &kernel,
                                                       const std::vector<int32_t> &stride,
                                                       const std::vector<int32_t> &pad, const uint32_t nanMode) const {
@@ -1600,6 +1729,8 @@ Pad::Pad(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynam
                       debugName, {_input->getRank()}),
       pushConstant{createPushConstant(_padConst, _padConstInt)} {}
 
+CostEstimate Pad::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 Pad::PushConstant Pad::createPushConstant(const real_t padConst, const int32_t padConstInt) const {
     PushConstant constant = {
         padConst,
@@ -1650,6 +1781,13 @@ Reduce::Reduce(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
                       {_output->getRank()}),
       pushConstant{createPushConstant(_axis, _nanMode, getFormatInfo(_input->getFormat())->isInteger)} {}
 
+CostEstimate Reduce::getCostEstimate() const {
+    // One operation per input element
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = getDescriptorTensor(1)->getShapeSize();
+    return estimate;
+}
+
 Reduce::PushConstant Reduce::createPushConstant(const uint32_t axis, const uint32_t nanMode,
                                                 const bool isInteger) const {
     PushConstant constant = {
@@ -1708,6 +1846,13 @@ Rescale::Rescale(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoa
                       debugName, {_output->getRank(), _scale32, _doubleRound, _perChannel}),
       pushConstant{createPushConstant(_inputZeroPoint, _outputZeroPoint)} {}
 
+CostEstimate Rescale::getCostEstimate() const {
+    // Input zero point, multiply, rounding shift and output zero point per element
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 4 * getDescriptorTensor(0)->getShapeSize();
+    return estimate;
+}
+
 Rescale::PushConstant Rescale::createPushConstant(const int32_t inputZeroPoint, const int32_t outputZeroPoint) const {
     PushConstant constant = {
         inputZeroPoint,
@@ -1767,6 +1912,8 @@ Reshape::Reshape(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoa
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _output), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _output), debugName, {_input->getRank(), _output->getRank()}) {}
 
+CostEstimate Reshape::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Reshape::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                            const std::shared_ptr<TensorDescriptor> &output) const {
     // Configure descriptor map
@@ -1871,6 +2018,8 @@ Reverse::Reverse(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoa
                       _pipelineCache, createSpirv(_pipelineCache, _output), debugName, {_output->getRank()}),
       pushConstant{createPushConstant(_axis)} {}
 
+CostEstimate Reverse::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 Reverse::PushConstant Reverse::createPushConstant(const uint32_t axis) const {
     PushConstant constant = {
         axis,
@@ -1914,6 +2063,15 @@ Rfft2D::Rfft2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoade
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _outputReal, _outputImag), {}, _pipelineCache,
                       createSpirv(_pipelineCache), debugName) {}
 
+CostEstimate Rfft2D::getCostEstimate() const {
+    // A real input transform takes roughly half the operations of the complex one
+    const auto &input = getDescriptorTensor(2)->getDimensions();
+    const auto points = static_cast<double>(input[1] * input[2]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = static_cast<uint64_t>(2.5 * static_cast<double>(input[0]) * points * std::log2(points));
+    return estimate;
+}
+
 DescriptorMap Rfft2D::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                           const std::shared_ptr<TensorDescriptor> &outputReal,
                                           const std::shared_ptr<TensorDescriptor> &outputImag) const {
@@ -1945,6 +2103,8 @@ Scatter::Scatter(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoa
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _values, _indices, _output), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _indices, _output), debugName, {}) {}
 
+CostEstimate Scatter::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Scatter::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                            const std::shared_ptr<TensorDescriptor> &values,
                                            const std::shared_ptr<TensorDescriptor> &indices,
@@ -2031,6 +2191,8 @@ Slice::Slice(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderD
                       createSpirv(_pipelineCache, _input), debugName, {_input->getRank()}),
       pushConstant{createPushConstant(_start)} {}
 
+CostEstimate Slice::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 Slice::PushConstant Slice::createPushConstant(const std::vector<uint32_t> &start) const {
     PushConstant constant{};
     std::copy(start.begin(), start.end(), constant.start);
@@ -2073,6 +2235,8 @@ Table::Table(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderD
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _output, _table), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _input, _output), debugName, {_output->getRank()}) {}
 
+CostEstimate Table::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Table::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                          const std::shared_ptr<TensorDescriptor> &output,
                                          const std::shared_ptr<TensorDescriptor> &table) const {
@@ -2114,6 +2278,8 @@ Tile::Tile(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDyn
     : ComputePipeline(_loader, _device, createDescriptorMap(_input, _output), {}, _pipelineCache,
                       createSpirv(_pipelineCache, _output), debugName, {_input->getRank()}) {}
 
+CostEstimate Tile::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 DescriptorMap Tile::createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                         const std::shared_ptr<TensorDescriptor> &output) const {
     // Configure descriptor map
@@ -2152,6 +2318,8 @@ Transpose::Transpose(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::Dispatc
                       createSpirv(_pipelineCache, _output), debugName, {_output->getRank()}),
       pushConstant{createPushConstant(_perms)} {}
 
+CostEstimate Transpose::getCostEstimate() const { return getMemoryCostEstimate(); }
+
 Transpose::PushConstant Transpose::createPushConstant(const std::vector<uint32_t> &perms) const {
     PushConstant constant{};
     std::copy(perms.begin(), perms.end(), constant.perms);
@@ -2200,6 +2368,16 @@ TransposeConv2D::TransposeConv2D(const std::shared_ptr<VULKAN_HPP_NAMESPACE::det
                       createSpirv(_pipelineCache, _input, _output, _weights, _accType), debugName),
       pushConstant{createPushConstant(_outPad, _stride, _inputZeroPoint, _weightZeroPoint)} {}
 
+CostEstimate TransposeConv2D::getCostEstimate() const {
+    // Weights are [OC, KH, KW, IC], so every input element contributes to KH * KW * OC multiply-accumulates
+    const auto &input = getDescriptorTensor(1);
+    const auto &weights = getDescriptorTensor(2);
+    const auto macsPerInput = weights->getShapeSize() / static_cast<size_t>(weights->getDimensions()[3]);
+    auto estimate = getMemoryCostEstimate();
+    estimate.flops = 2 * input->getShapeSize() * macsPerInput;
+    return estimate;
+}
+
 TransposeConv2D::PushConstant TransposeConv2D::createPushConstant(const std::vector<int32_t> &outPad,
                                                                   const std::vector<int32_t> &stride,
                                                                   const int8_t inputZeroPoint,
@@ -12,6 +12,7 @@
 
 #include "compute_pipeline_common.hpp"
 #include "mlel/utils.hpp"
+#include "mlel/vulkan_allocator.hpp"
 #include "pipeline_cache.hpp"
 #include "tensor.hpp"
 
@@ -104,7 +105,10 @@ class ComputeDescriptorSet {
 };
 
 using DescriptorSetInstanceKey = std::tuple<VkPipelineLayout, uint32_t>;
-using ComputeDescriptorSetMap = std::map<DescriptorSetInstanceKey, std::shared_ptr<ComputeDescriptorSet>>;
+// Maps merged while recording a dispatch are allocated from the command buffer arena, all others from the heap
+using ComputeDescriptorSetMap =
+    std::map<DescriptorSetInstanceKey, std::shared_ptr<ComputeDescriptorSet>, std::less<DescriptorSetInstanceKey>,
+             layer::ArenaAllocator<std::pair<const DescriptorSetInstanceKey, std::shared_ptr<ComputeDescriptorSet>>>>;
 
 /*******************************************************************************
  * ComputePipelineLayout
@@ -154,6 +158,12 @@ class ComputePipelineLayout {
  * ComputePipelineBase
  *******************************************************************************/
 
+struct CostEstimate {
+    uint64_t flops = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+};
+
 class ComputePipelineBase {
   public:
     explicit ComputePipelineBase(const std::shared_ptr<ComputePipelineLayout> &_pipelineLayout,
@@ -173,7 +183,22 @@ class ComputePipelineBase {
 
     const std::string &getDebugName() const;
 
+    /**
+     * Analytic estimate of the arithmetic operations and memory traffic of one dispatch, derived from the tensor
+     * descriptors. The default treats the pipeline as elementwise with one operation per output element.
+     */
+    virtual CostEstimate getCostEstimate() const;
+
+    /**
+     * Number of shader invocations that produce a result, one per element of the first output tensor. Compared against
+     * the invocations issued by the dispatch to measure lane utilization.
+     */
+    virtual uint64_t getUsefulInvocationCount() const;
+
   protected:
+    CostEstimate getMemoryCostEstimate() const;
+    const std::shared_ptr<TensorDescriptor> &getDescriptorTensor(size_t index) const;
+
     std::shared_ptr<ComputePipelineLayout> pipelineLayout;
     std::vector<std::shared_ptr<VirtualTensor>> parents;
     std::vector<std::shared_ptr<VirtualTensor>> descendants;
@@ -229,6 +254,8 @@ class Argmax : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_output, uint32_t _axis, uint32_t _nanMode,
            const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t axis;
@@ -291,6 +318,8 @@ class AvgPool2D : public ComputePipeline {
               const std::vector<int32_t> &_stride, const std::vector<int32_t> &_pad, uint32_t _accType,
               int8_t _inputZeroPoint, int8_t _outputZeroPoint, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t kernel[2];
@@ -325,6 +354,8 @@ class Cast : public ComputePipeline {
          const std::shared_ptr<PipelineCache> &_pipelineCache, const std::shared_ptr<TensorDescriptor> &_input,
          const std::shared_ptr<TensorDescriptor> &_output, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &output) const;
@@ -378,6 +409,8 @@ class Concat : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_output, uint32_t _axis, uint32_t _offset,
            const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t axis;
@@ -412,6 +445,8 @@ class Conv2D : public ComputePipeline {
            const std::vector<int32_t> &_stride, const std::vector<int32_t> &_dilation, int8_t _inputZeroPoint,
            int8_t _weightZeroPoint, uint32_t _accType, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint;
@@ -459,6 +494,8 @@ class Conv3D : public ComputePipeline {
            const std::vector<int32_t> &_stride, const std::vector<int32_t> &_dilation, int8_t _inputZeroPoint,
            int8_t _weightZeroPoint, uint32_t _accType, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint;
@@ -501,6 +538,8 @@ class DepthwiseConv2D : public ComputePipeline {
                     const std::vector<int32_t> &_dilation, int8_t _inputZeroPoint, int8_t _weightZeroPoint,
                     uint32_t _accType, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint;
@@ -595,6 +634,8 @@ class Fft2D : public ComputePipeline {
           const std::shared_ptr<TensorDescriptor> &_inputImag, const std::shared_ptr<TensorDescriptor> &_outputReal,
           const std::shared_ptr<TensorDescriptor> &_outputImag, bool _inverse, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         float signValue;
@@ -624,6 +665,8 @@ class Gather : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_indices, const std::shared_ptr<TensorDescriptor> &_output,
            const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &values,
                                       const std::shared_ptr<TensorDescriptor> &indices,
@@ -647,6 +690,8 @@ class Matmul : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_input2, const std::shared_ptr<TensorDescriptor> &_output,
            int32_t _inputZeroPoint1, int32_t _inputZeroPoint2, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint1;
@@ -680,6 +725,8 @@ class MaxPool2D : public ComputePipeline {
               const std::vector<int32_t> &_stride, const std::vector<int32_t> &_pad, uint32_t _nanMode,
               const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t kernel[2];
@@ -774,6 +821,8 @@ class Pad : public ComputePipeline {
         const std::shared_ptr<TensorDescriptor> &_output, const std::shared_ptr<TensorDescriptor> &_padding,
         real_t _padConst, int32_t _padConstInt, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         real_t padConst;
@@ -805,6 +854,8 @@ class Reduce : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_output, uint32_t _axis, uint32_t _nanMode,
            const std::string &debugName, const std::string &_init, const std::string_view &_operation);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t axis;
@@ -838,6 +889,8 @@ class Rescale : public ComputePipeline {
             bool _scale32, bool _doubleRound, bool _perChannel, bool _inputUnsigned, bool _outputUnsigned,
             const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint;
@@ -872,6 +925,8 @@ class Reshape : public ComputePipeline {
             const std::shared_ptr<PipelineCache> &_pipelineCache, const std::shared_ptr<TensorDescriptor> &_input,
             const std::shared_ptr<TensorDescriptor> &_output, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &output) const;
@@ -926,6 +981,8 @@ class Reverse : public ComputePipeline {
             const std::shared_ptr<PipelineCache> &_pipelineCache, const std::shared_ptr<TensorDescriptor> &_input,
             const std::shared_ptr<TensorDescriptor> &_output, uint32_t _axis, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t axis;
@@ -955,6 +1012,8 @@ class Rfft2D : public ComputePipeline {
            const std::shared_ptr<TensorDescriptor> &_outputReal, const std::shared_ptr<TensorDescriptor> &_outputImag,
            const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &outputReal,
@@ -976,6 +1035,8 @@ class Scatter : public ComputePipeline {
             const std::shared_ptr<TensorDescriptor> &_values, const std::shared_ptr<TensorDescriptor> &_indices,
             const std::shared_ptr<TensorDescriptor> &_output, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &values,
@@ -1023,6 +1084,8 @@ class Slice : public ComputePipeline {
           const std::shared_ptr<TensorDescriptor> &_output, const std::vector<uint32_t> &_start,
           const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t start[MAX_CONST_LEN];
@@ -1051,6 +1114,8 @@ class Table : public ComputePipeline {
           const std::shared_ptr<TensorDescriptor> &_output, const std::shared_ptr<TensorDescriptor> &_table,
           const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &output,
@@ -1073,6 +1138,8 @@ class Tile : public ComputePipeline {
          const std::shared_ptr<PipelineCache> &_pipelineCache, const std::shared_ptr<TensorDescriptor> &_input,
          const std::shared_ptr<TensorDescriptor> &_output, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     DescriptorMap createDescriptorMap(const std::shared_ptr<TensorDescriptor> &input,
                                       const std::shared_ptr<TensorDescriptor> &output) const;
@@ -1094,6 +1161,8 @@ class Transpose : public ComputePipeline {
               const std::shared_ptr<TensorDescriptor> &_output, const std::vector<uint32_t> &_perms,
               const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         uint32_t perms[MAX_CONST_LEN];
@@ -1125,6 +1194,8 @@ class TransposeConv2D : public ComputePipeline {
                     const std::vector<int32_t> &_outPad, const std::vector<int32_t> &_stride, int8_t _inputZeroPoint,
                     int8_t _weightZeroPoint, uint32_t _accType, const std::string &debugName);
 
+    CostEstimate getCostEstimate() const override;
+
   private:
     struct PushConstant {
         int32_t inputZeroPoint;
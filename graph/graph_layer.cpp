@@ -17,24 +17,29 @@
 #include "memory_planner.hpp"
 #include "optical_flow.hpp"
 #include "pipeline_cache.hpp"
+#include "pipeline_results.hpp"
+#include "spirv_module.hpp"
 #include "version.hpp"
 
-#include "source/opt/build_module.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/module.h"
+#include "source/opt/pass_manager.h"
 #include "spirv_pass.hpp"
 #include "spirv_pass_tosaspv_v100.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
 
 using namespace mlsdk::el::compute;
@@ -68,43 +73,6 @@ bool hasVersionPrefix(std::string_view name, std::string_view prefix, size_t dig
            (name.size() > versionEnd + 1 && name[versionEnd] == '.' && isDigit(name[versionEnd + 1]));
 }
 
-std::unordered_map<uint32_t, std::vector<uint32_t>>
-makeSpecConstantDefaultValues(const VkSpecializationInfo &specializationInfo) {
-    std::unordered_map<uint32_t, std::vector<uint32_t>> values;
-    values.reserve(specializationInfo.mapEntryCount);
-
-    for (uint32_t i = 0; i < specializationInfo.mapEntryCount; i++) {
-        const auto &entry = specializationInfo.pMapEntries[i];
-
-        if (entry.size == 0) {
-            values.emplace(entry.constantID, std::vector<uint32_t>{});
-            continue;
-        }
-
-        const auto wordCount = static_cast<size_t>((entry.size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
-        std::vector<uint32_t> words(wordCount, 0u);
-        std::memcpy(words.data(), static_cast<const char *>(specializationInfo.pData) + entry.offset, entry.size);
-
-        values.emplace(entry.constantID, std::move(words));
-    }
-
-    return values;
-}
-
-void registerSpecConstantDefaultPasses(spvtools::Optimizer &optimizer, const VkSpecializationInfo *specializationInfo) {
-    if (specializationInfo == nullptr) {
-        return;
-    }
-
-    const auto specConstantDefaultValues = makeSpecConstantDefaultValues(*specializationInfo);
-    if (specConstantDefaultValues.empty()) {
-        return;
-    }
-
-    optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(specConstantDefaultValues));
-    optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
-    optimizer.RegisterPass(spvtools::CreateFoldSpecConstantOpAndCompositePass());
-}
 // Layer-private property used for graph profiling JSON results.
 constexpr VkDataGraphPipelinePropertyARM graphProfilingProperty =
     static_cast<VkDataGraphPipelinePropertyARM>(0x7ffffffe);
@@ -112,6 +80,19 @@ constexpr std::array<VkDataGraphPipelinePropertyARM, 2> dataGraphPipelinePropert
     VK_DATA_GRAPH_PIPELINE_PROPERTY_CREATION_LOG_ARM,
     graphProfilingProperty,
 };
+
+// Phases of data graph pipeline creation, in the order their durations are reported as pipeline stage creation
+// feedback.
+enum PipelineCreationPhase : size_t {
+    PIPELINE_CREATION_PHASE_PARSE,
+    PIPELINE_CREATION_PHASE_LOWERING,
+    PIPELINE_CREATION_PHASE_CONSTANTS,
+    PIPELINE_CREATION_PHASE_COUNT,
+};
+
+uint64_t toNanoseconds(utils::HostClock::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
 } // namespace
 
 /**************************************************************************
@@ -317,17 +298,39 @@ class GraphDevice : public Device {
     explicit GraphDevice(const std::shared_ptr<PhysicalDevice> &_physicalDevice, VkDevice _device,
                          PFN_vkGetInstanceProcAddr _gipr, PFN_vkGetDeviceProcAddr _gdpr,
                          const VkAllocationCallbacks *_callbacks)
-        : Device(_physicalDevice, _device, _gipr, _gdpr, _callbacks) {
-        if (GraphProfiler::isEnabled()) {
-            profiler = std::make_unique<GraphProfiler>(loader, physicalDevice->physicalDevice, device);
-        }
+        : Device(_physicalDevice, _device, _gipr, _gdpr, _callbacks) {}
+
+    HandleMap<VkDescriptorSet, DataGraphDescriptorSet> descriptorSetMap;
+    HandleMap<VkPipeline, DataGraphPipelineARM> dataGraphPipelineMap;
+    HandleMap<VkTensorViewARM, TensorView> tensorViewMap;
+    HandleMap<VkShaderModule, ShaderModule> shaderModuleMap;
+
+    /**
+     * Return the profiler, creating it with the first data graph pipeline of the device, or nullptr if profiling is
+     * disabled. Devices that never create a data graph pipeline never pay for the profiler.
+     */
+    GraphProfiler *getProfiler() {
+        std::call_once(profilerOnce, [this] {
+            if (GraphProfiler::isEnabled()) {
+                profilerStorage = std::make_unique<GraphProfiler>(loader, physicalDevice->physicalDevice, device);
+                profiler.store(profilerStorage.get(), std::memory_order_release);
+            }
+        });
+        return profiler.load(std::memory_order_acquire);
+    }
+
+    /// Return the profiler if it has been created, without creating it.
+    GraphProfiler *findProfiler() const { return profiler.load(std::memory_order_acquire); }
+
+    utils::HostTimerRegistry *getHostTimers() const {
+        auto *currentProfiler = findProfiler();
+        return currentProfiler ? &currentProfiler->getHostTimers() : nullptr;
     }
 
-    std::map<VkDescriptorSet, std::shared_ptr<DataGraphDescriptorSet>> descriptorSetMap;
-    std::map<VkPipeline, std::shared_ptr<DataGraphPipelineARM>> dataGraphPipelineMap;
-    std::map<VkTensorViewARM, std::shared_ptr<TensorView>> tensorViewMap;
-    std::map<VkShaderModule, std::shared_ptr<ShaderModule>> shaderModuleMap;
-    std::unique_ptr<GraphProfiler> profiler;
+  private:
+    std::once_flag profilerOnce;
+    std::unique_ptr<GraphProfiler> profilerStorage;
+    std::atomic<GraphProfiler *> profiler{nullptr};
 };
 
 /*****************************************************************************
@@ -362,13 +365,22 @@ void sprivMessageConsumer(spv_message_level_t level, const char *, const spv_pos
     graphLog(severity) << "SPIRV-Tools message: " << message << " at position " << position.index << std::endl;
 }
 
-std::optional<bool> isGraphSpirv(const uint32_t *spirvCode, const size_t spirvSize) {
-    auto ir = spvtools::BuildModule(SPV_ENV_UNIVERSAL_1_6, sprivMessageConsumer, spirvCode, spirvSize);
-    if (ir == nullptr || ir->module() == nullptr) {
+std::unique_ptr<spvtools::opt::IRContext> buildModule(const uint32_t *spirvCode, const size_t spirvSize) {
+    auto ir = buildGraphModule(spirvCode, spirvSize, sprivMessageConsumer);
+    if (ir == nullptr) {
         graphLog(Severity::Error) << "Failed to compile spirv code." << std::endl;
+    }
+    return ir;
+}
+
+bool isGraphSpirv(const spvtools::opt::IRContext &ir) { return !ir.module()->graphs().empty(); }
+
+std::optional<bool> isGraphSpirv(const uint32_t *spirvCode, const size_t spirvSize) {
+    const auto ir = buildModule(spirvCode, spirvSize);
+    if (ir == nullptr) {
         return std::nullopt;
     }
-    return !ir->module()->graphs().empty();
+    return isGraphSpirv(*ir);
 }
 
 struct SupportedVersions {
@@ -376,11 +388,10 @@ struct SupportedVersions {
     std::optional<std::string> motionEngine;
 };
 
-bool checkInstVersion(const uint32_t *spirvCode, const size_t spirvSize, SupportedVersions &supportedVersions) {
-    const auto ir = spvtools::BuildModule(SPV_ENV_UNIVERSAL_1_6, sprivMessageConsumer, spirvCode, spirvSize);
+bool checkInstVersion(const spvtools::opt::IRContext &ir, SupportedVersions &supportedVersions) {
     const auto tryGetExtInstVersion = [&ir](const std::string_view &prefix,
                                             size_t digitCount) -> std::optional<std::string> {
-        for (const auto &inst : ir->module()->ext_inst_imports()) {
+        for (const auto &inst : ir.module()->ext_inst_imports()) {
             auto name = inst.GetInOperand(0).AsString();
             if (hasVersionPrefix(name, prefix, digitCount)) {
                 return name;
@@ -568,7 +579,8 @@ class GraphLayer : public VulkanLayerImpl {
 
     static void collectSignaledFences(const std::shared_ptr<GraphDevice> &handle, uint32_t fenceCount,
                                       const VkFence *fences) {
-        if (!handle->profiler || fences == nullptr) {
+        auto *profiler = handle->findProfiler();
+        if (!profiler || fences == nullptr) {
             return;
         }
 
@@ -578,7 +590,7 @@ class GraphLayer : public VulkanLayerImpl {
             }
 
             if (handle->loader->vkGetFenceStatus(handle->device, fences[i]) == VK_SUCCESS) {
-                handle->profiler->collectFence(fences[i]);
+                profiler->collectFence(fences[i]);
             }
         }
     }
@@ -586,8 +598,9 @@ class GraphLayer : public VulkanLayerImpl {
     static VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device) {
         auto handle = VulkanLayerImpl::getHandle(device);
         const auto result = handle->loader->vkDeviceWaitIdle(device);
-        if (result == VK_SUCCESS && handle->profiler) {
-            handle->profiler->collectDevice();
+        auto *profiler = handle->findProfiler();
+        if (result == VK_SUCCESS && profiler) {
+            profiler->collectDevice();
         }
         return result;
     }
@@ -596,10 +609,11 @@ class GraphLayer : public VulkanLayerImpl {
                                                VkBool32 waitAll, uint64_t timeout) {
         auto handle = VulkanLayerImpl::getHandle(device);
         const auto result = handle->loader->vkWaitForFences(device, fenceCount, pFences, waitAll, timeout);
-        if (result == VK_SUCCESS && handle->profiler && pFences != nullptr) {
+        auto *profiler = handle->findProfiler();
+        if (result == VK_SUCCESS && profiler && pFences != nullptr) {
             if (waitAll) {
                 for (uint32_t i = 0; i < fenceCount; ++i) {
-                    handle->profiler->collectFence(pFences[i]);
+                    profiler->collectFence(pFences[i]);
                 }
             } else {
                 collectSignaledFences(handle, fenceCount, pFences);
@@ -611,8 +625,9 @@ class GraphLayer : public VulkanLayerImpl {
     static VkResult VKAPI_CALL vkGetFenceStatus(VkDevice device, VkFence fence) {
         auto handle = VulkanLayerImpl::getHandle(device);
         const auto result = handle->loader->vkGetFenceStatus(device, fence);
-        if (result == VK_SUCCESS && handle->profiler) {
-            handle->profiler->collectFence(fence);
+        auto *profiler = handle->findProfiler();
+        if (result == VK_SUCCESS && profiler) {
+            profiler->collectFence(fence);
         }
         return result;
     }
@@ -665,14 +680,15 @@ class GraphLayer : public VulkanLayerImpl {
                                              VkFence fence) {
         auto handle = VulkanLayerImpl::getHandle(queue);
         const auto commandBuffers = getCommandBuffers(submitCount, pSubmits);
-        const bool shouldProfile = handle->profiler && handle->profiler->hasProfiledCommandBuffers(commandBuffers);
+        auto *profiler = handle->findProfiler();
+        const bool shouldProfile = profiler && profiler->hasProfiledCommandBuffers(commandBuffers);
         if (shouldProfile) {
-            handle->profiler->prepareCommandBuffersForSubmit(commandBuffers);
+            profiler->prepareCommandBuffersForSubmit(commandBuffers);
         }
 
         const auto result = handle->loader->vkQueueSubmit(queue, submitCount, pSubmits, fence);
         if (result == VK_SUCCESS && shouldProfile) {
-            handle->profiler->registerSubmit(queue, commandBuffers, fence);
+            profiler->registerSubmit(queue, commandBuffers, fence);
         }
 
         return result;
@@ -682,14 +698,15 @@ class GraphLayer : public VulkanLayerImpl {
                                               VkFence fence) {
         auto handle = VulkanLayerImpl::getHandle(queue);
         const auto commandBuffers = getCommandBuffers(submitCount, pSubmits);
-        const bool shouldProfile = handle->profiler && handle->profiler->hasProfiledCommandBuffers(commandBuffers);
+        auto *profiler = handle->findProfiler();
+        const bool shouldProfile = profiler && profiler->hasProfiledCommandBuffers(commandBuffers);
         if (shouldProfile) {
-            handle->profiler->prepareCommandBuffersForSubmit(commandBuffers);
+            profiler->prepareCommandBuffersForSubmit(commandBuffers);
         }
 
         const auto result = handle->loader->vkQueueSubmit2(queue, submitCount, pSubmits, fence);
         if (result == VK_SUCCESS && shouldProfile) {
-            handle->profiler->registerSubmit(queue, commandBuffers, fence);
+            profiler->registerSubmit(queue, commandBuffers, fence);
         }
 
         return result;
@@ -699,16 +716,17 @@ class GraphLayer : public VulkanLayerImpl {
                                                  VkFence fence) {
         auto handle = VulkanLayerImpl::getHandle(queue);
         const auto commandBuffers = getCommandBuffers(submitCount, pSubmits);
-        const bool shouldProfile = handle->profiler && handle->profiler->hasProfiledCommandBuffers(commandBuffers);
+        auto *profiler = handle->findProfiler();
+        const bool shouldProfile = profiler && profiler->hasProfiledCommandBuffers(commandBuffers);
         if (shouldProfile) {
-            handle->profiler->prepareCommandBuffersForSubmit(commandBuffers);
+            profiler->prepareCommandBuffersForSubmit(commandBuffers);
         }
 
         const auto submit =
             handle->loader->vkQueueSubmit2KHR ? handle->loader->vkQueueSubmit2KHR : handle->loader->vkQueueSubmit2;
         const auto result = submit(queue, submitCount, pSubmits, fence);
         if (result == VK_SUCCESS && shouldProfile) {
-            handle->profiler->registerSubmit(queue, commandBuffers, fence);
+            profiler->registerSubmit(queue, commandBuffers, fence);
         }
 
         return result;
@@ -717,8 +735,9 @@ class GraphLayer : public VulkanLayerImpl {
     static VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue) {
         auto handle = VulkanLayerImpl::getHandle(queue);
         const auto result = handle->loader->vkQueueWaitIdle(queue);
-        if (result == VK_SUCCESS && handle->profiler) {
-            handle->profiler->collectQueue(queue);
+        auto *profiler = handle->findProfiler();
+        if (result == VK_SUCCESS && profiler) {
+            profiler->collectQueue(queue);
         }
         return result;
     }
@@ -828,407 +847,480 @@ class GraphLayer : public VulkanLayerImpl {
      * Graph layer
      **************************************************************************/
 
-    static VkResult VKAPI_CALL vkCreateDataGraphPipelinesARM(VkDevice device, VkDeferredOperationKHR,
-                                                             VkPipelineCache pipelineCache, uint32_t createInfoCount,
-                                                             const VkDataGraphPipelineCreateInfoARM *createInfos,
-                                                             const VkAllocationCallbacks *callbacks,
-                                                             VkPipeline *pipelines) {
-        auto deviceHandle = VulkanLayerImpl::getHandle(device);
-        auto pipelineCacheHandle = getHandle(pipelineCache);
-
-        for (uint32_t i = 0; i < createInfoCount; i++) {
-            const auto &createInfo = createInfos[i];
-
-            const auto *creationFeedbackInfo = findType<VkPipelineCreationFeedbackCreateInfo>(
-                createInfo.pNext, VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO);
-            std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-            if (creationFeedbackInfo != nullptr) {
-                startTime = std::chrono::high_resolution_clock::now();
+    /**
+     * Create the pipeline for a single create info. Pipelines of one vkCreateDataGraphPipelinesARM call are created
+     * concurrently, so this only touches state owned by the new pipeline or synchronized by the device.
+     */
+    static VkResult createDataGraphPipeline(const std::shared_ptr<GraphDevice> &deviceHandle,
+                                            const std::shared_ptr<PipelineCache> &pipelineCacheHandle,
+                                            const VkDataGraphPipelineCreateInfoARM &createInfo,
+                                            const VkAllocationCallbacks *callbacks,
+                                            std::shared_ptr<DataGraphPipelineARM> &createdPipeline) {
+        if ((createInfo.flags & VK_PIPELINE_CREATE_2_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_KHR) != 0) {
+            // Data graph pipelines are always lowered when created, there is no cache to create them from
+            return VK_PIPELINE_COMPILE_REQUIRED;
+        }
+
+        auto *hostTimers = deviceHandle->getHostTimers();
+
+        const auto *creationFeedbackInfo = findType<VkPipelineCreationFeedbackCreateInfo>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO);
+
+        // Phase durations are only accumulated when the application asks for creation feedback
+        utils::HostClock::duration pipelineDuration{};
+        std::array<utils::HostClock::duration, PIPELINE_CREATION_PHASE_COUNT> phaseDurations{};
+        const auto getElapsed = [&](size_t phase) {
+            return creationFeedbackInfo != nullptr ? &phaseDurations[phase] : nullptr;
+        };
+        utils::ScopedHostTimer pipelineTimer(hostTimers, "vkCreateDataGraphPipelinesARM",
+                                             creationFeedbackInfo != nullptr ? &pipelineDuration : nullptr);
+
+        const auto *dataGraphPipelineShaderModuleCreateInfo = findType<VkDataGraphPipelineShaderModuleCreateInfoARM>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_SHADER_MODULE_CREATE_INFO_ARM);
+
+        const auto *singleNodeCreateInfo = findType<VkDataGraphPipelineSingleNodeCreateInfoARM>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_SINGLE_NODE_CREATE_INFO_ARM);
+
+        const VkDataGraphPipelineOpticalFlowCreateInfoARM *opticalFlowCreateInfo = nullptr;
+        if (singleNodeCreateInfo != nullptr &&
+            singleNodeCreateInfo->nodeType == VK_DATA_GRAPH_PIPELINE_NODE_TYPE_OPTICAL_FLOW_ARM) {
+            opticalFlowCreateInfo = findType<VkDataGraphPipelineOpticalFlowCreateInfoARM>(
+                createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_OPTICAL_FLOW_CREATE_INFO_ARM);
+            if (opticalFlowCreateInfo == nullptr) {
+                graphLog(Severity::Error) << "Missing OF create info in single node create info" << std::endl;
+                return VK_ERROR_UNKNOWN;
             }
+        }
 
-            const auto *dataGraphPipelineShaderModuleCreateInfo =
-                findType<VkDataGraphPipelineShaderModuleCreateInfoARM>(
-                    createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_SHADER_MODULE_CREATE_INFO_ARM);
+        if (!dataGraphPipelineShaderModuleCreateInfo && !opticalFlowCreateInfo) {
+            graphLog(Severity::Error) << "DataGraphPipelineCreateInfo Missing pNext struct" << std::endl;
+            return VK_ERROR_UNKNOWN;
+        }
+        if (dataGraphPipelineShaderModuleCreateInfo && opticalFlowCreateInfo) {
+            graphLog(Severity::Error) << "Multiple DataGraphPipelineCreateInfo pNext structs" << std::endl;
+            return VK_ERROR_UNKNOWN;
+        }
 
-            const auto *singleNodeCreateInfo = findType<VkDataGraphPipelineSingleNodeCreateInfoARM>(
-                createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_SINGLE_NODE_CREATE_INFO_ARM);
+        const auto type = dataGraphPipelineShaderModuleCreateInfo != nullptr
+                              ? DataGraphPipelineARM::Type::GRAPH
+                              : DataGraphPipelineARM::Type::OPTICAL_FLOW;
+        // Create pipeline handle
+        auto pipeline = std::allocate_shared<DataGraphPipelineARM>(Allocator<GraphPipeline>{callbacks},
+                                                                   deviceHandle, pipelineCacheHandle, type);
+        graphLog(Severity::Info) << graphPipelineCreatedLog << std::endl;
 
-            const VkDataGraphPipelineOpticalFlowCreateInfoARM *opticalFlowCreateInfo = nullptr;
-            if (singleNodeCreateInfo != nullptr &&
-                singleNodeCreateInfo->nodeType == VK_DATA_GRAPH_PIPELINE_NODE_TYPE_OPTICAL_FLOW_ARM) {
-                opticalFlowCreateInfo = findType<VkDataGraphPipelineOpticalFlowCreateInfoARM>(
-                    createInfo.pNext, VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_OPTICAL_FLOW_CREATE_INFO_ARM);
-                if (opticalFlowCreateInfo == nullptr) {
-                    graphLog(Severity::Error) << "Missing OF create info in single node create info" << std::endl;
+        if (pipeline->isGraph()) {
+            // Given by type check above, this should never be nullptr
+            assert(dataGraphPipelineShaderModuleCreateInfo);
+            auto &graphPipeline = pipeline->graphPipeline;
+            utils::ScopedHostTimer parseTimer(hostTimers, "vkCreateDataGraphPipelinesARM/parse",
+                                              getElapsed(PIPELINE_CREATION_PHASE_PARSE));
+            // Copy tensor resources to pipeline
+            for (uint32_t j = 0; j < createInfo.resourceInfoCount; j++) {
+                const auto &resourceInfo = createInfo.pResourceInfos[j];
+                const auto *tensorDescription =
+                    findType<VkTensorDescriptionARM>(resourceInfo.pNext, VK_STRUCTURE_TYPE_TENSOR_DESCRIPTION_ARM);
+
+                if (tensorDescription == nullptr) {
+                    graphLog(Severity::Error) << "Missing tensor description" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
-            }
 
-            if (!dataGraphPipelineShaderModuleCreateInfo && !opticalFlowCreateInfo) {
-                graphLog(Severity::Error) << "DataGraphPipelineCreateInfo Missing pNext struct" << std::endl;
-                return VK_ERROR_UNKNOWN;
+                graphPipeline->makeDescriptorSetBinding(resourceInfo.descriptorSet, resourceInfo.binding,
+                                                        resourceInfo.arrayElement, *tensorDescription);
             }
-            if (dataGraphPipelineShaderModuleCreateInfo && opticalFlowCreateInfo) {
-                graphLog(Severity::Error) << "Multiple DataGraphPipelineCreateInfo pNext structs" << std::endl;
-                return VK_ERROR_UNKNOWN;
-            }
-
-            const auto type = dataGraphPipelineShaderModuleCreateInfo != nullptr
-                                  ? DataGraphPipelineARM::Type::GRAPH
-                                  : DataGraphPipelineARM::Type::OPTICAL_FLOW;
-            // Create pipeline handle
-            auto pipeline = std::allocate_shared<DataGraphPipelineARM>(Allocator<GraphPipeline>{callbacks},
-                                                                       deviceHandle, pipelineCacheHandle, type);
-            pipelines[i] = reinterpret_cast<VkPipeline>(pipeline.get());
-            graphLog(Severity::Info) << graphPipelineCreatedLog << std::endl;
-
-            if (pipeline->isGraph()) {
-                // Given by type check above, this should never be nullptr
-                assert(dataGraphPipelineShaderModuleCreateInfo);
-                auto &graphPipeline = pipeline->graphPipeline;
-                // Copy tensor resources to pipeline
-                for (uint32_t j = 0; j < createInfo.resourceInfoCount; j++) {
-                    const auto &resourceInfo = createInfo.pResourceInfos[j];
-                    const auto *tensorDescription =
-                        findType<VkTensorDescriptionARM>(resourceInfo.pNext, VK_STRUCTURE_TYPE_TENSOR_DESCRIPTION_ARM);
-
-                    if (tensorDescription == nullptr) {
-                        graphLog(Severity::Error) << "Missing tensor description" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-
-                    graphPipeline->makeDescriptorSetBinding(resourceInfo.descriptorSet, resourceInfo.binding,
-                                                            resourceInfo.arrayElement, *tensorDescription);
-                }
-
-                // Constants
-                for (uint32_t j = 0; j < dataGraphPipelineShaderModuleCreateInfo->constantCount; j++) {
-                    const auto &constant = dataGraphPipelineShaderModuleCreateInfo->pConstants[j];
 
-                    const auto *graphPipelineConstantTensor =
-                        findType<VkTensorDescriptionARM>(constant.pNext, VK_STRUCTURE_TYPE_TENSOR_DESCRIPTION_ARM);
+            // Constants
+            for (uint32_t j = 0; j < dataGraphPipelineShaderModuleCreateInfo->constantCount; j++) {
+                const auto &constant = dataGraphPipelineShaderModuleCreateInfo->pConstants[j];
 
-                    if (graphPipelineConstantTensor == nullptr) {
-                        graphLog(Severity::Error) << "Missing const tensor description" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-
-                    graphPipeline->makeConstTensor(constant.id, *graphPipelineConstantTensor, constant.pConstantData);
-                }
-                const uint32_t *spirvCode = nullptr;
-                size_t spirvSize = 0;
-                if (dataGraphPipelineShaderModuleCreateInfo->module == VK_NULL_HANDLE) {
-                    const auto *shaderModuleCreateInfo = findType<VkShaderModuleCreateInfo>(
-                        createInfo.pNext, VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO);
-                    if (shaderModuleCreateInfo == nullptr) {
-                        graphLog(Severity::Error) << "Missing both shader handle and shader create info" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
+                const auto *graphPipelineConstantTensor =
+                    findType<VkTensorDescriptionARM>(constant.pNext, VK_STRUCTURE_TYPE_TENSOR_DESCRIPTION_ARM);
 
-                    spirvCode = shaderModuleCreateInfo->pCode;
-                    spirvSize = shaderModuleCreateInfo->codeSize / sizeof(uint32_t);
-                    auto isGraph = isGraphSpirv(spirvCode, spirvSize);
-                    if (!isGraph.has_value()) {
-                        return VK_ERROR_UNKNOWN;
-                    }
-                    if (!isGraph.value()) {
-                        graphLog(Severity::Error) << "spirv code does not contain graph." << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-                } else {
-                    auto shaderModule = getHandle(deviceHandle, dataGraphPipelineShaderModuleCreateInfo->module);
-                    if (!shaderModule) {
-                        graphLog(Severity::Error) << "Shader module not recognized by Graph layer" << std::endl;
-                        return VK_ERROR_FEATURE_NOT_PRESENT;
-                    }
-                    spirvCode = shaderModule->code.data();
-                    spirvSize = shaderModule->code.size();
+                if (graphPipelineConstantTensor == nullptr) {
+                    graphLog(Severity::Error) << "Missing const tensor description" << std::endl;
+                    return VK_ERROR_UNKNOWN;
                 }
 
-                SupportedVersions supportedVersions;
-                if (!checkInstVersion(spirvCode, spirvSize, supportedVersions)) {
+                graphPipeline->makeConstTensor(constant.id, *graphPipelineConstantTensor, constant.pConstantData);
+            }
+            const uint32_t *spirvCode = nullptr;
+            size_t spirvSize = 0;
+            if (dataGraphPipelineShaderModuleCreateInfo->module == VK_NULL_HANDLE) {
+                const auto *shaderModuleCreateInfo = findType<VkShaderModuleCreateInfo>(
+                    createInfo.pNext, VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO);
+                if (shaderModuleCreateInfo == nullptr) {
+                    graphLog(Severity::Error) << "Missing both shader handle and shader create info" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
 
-                // Create optimizer
-                spvtools::Optimizer optimizer{SPV_ENV_UNIVERSAL_1_6};
-
-                // Register passes
-                registerSpecConstantDefaultPasses(optimizer,
-                                                  dataGraphPipelineShaderModuleCreateInfo->pSpecializationInfo);
-                pipeline->isTosaGraph = supportedVersions.tosa.has_value();
-                if (supportedVersions.tosa.has_value()) {
-                    pipeline->profilingPipelineKind = ProfilingPipelineKind::TOSA;
-                } else if (supportedVersions.motionEngine.has_value()) {
-                    pipeline->profilingPipelineKind = ProfilingPipelineKind::MOTION_ENGINE;
-                } else {
-                    pipeline->profilingPipelineKind = ProfilingPipelineKind::GRAPH_OP;
+                spirvCode = shaderModuleCreateInfo->pCode;
+                spirvSize = shaderModuleCreateInfo->codeSize / sizeof(uint32_t);
+            } else {
+                auto shaderModule = getHandle(deviceHandle, dataGraphPipelineShaderModuleCreateInfo->module);
+                if (!shaderModule) {
+                    graphLog(Severity::Error) << "Shader module not recognized by Graph layer" << std::endl;
+                    return VK_ERROR_FEATURE_NOT_PRESENT;
                 }
+                spirvCode = shaderModule->code.data();
+                spirvSize = shaderModule->code.size();
+            }
 
-                optimizer.RegisterPass(spvtools::CreateGraphPass<spvtools::opt::GraphPassTosaSpv100>(*graphPipeline));
+            // Build the IR once, it is inspected and then lowered in place
+            auto ir = buildModule(spirvCode, spirvSize);
+            if (ir == nullptr) {
+                return VK_ERROR_UNKNOWN;
+            }
+            if (dataGraphPipelineShaderModuleCreateInfo->module == VK_NULL_HANDLE && !isGraphSpirv(*ir)) {
+                graphLog(Severity::Error) << "spirv code does not contain graph." << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
 
-                // Run passes
-                spvtools::OptimizerOptions options;
-                options.set_run_validator(false);
-                std::vector<uint32_t> optimizedModule;
-                if (!optimizer.Run(spirvCode, spirvSize, &optimizedModule, options)) {
-                    graphLog(Severity::Error) << "Failed to run optimizer passes" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
+            SupportedVersions supportedVersions;
+            if (!checkInstVersion(*ir, supportedVersions)) {
+                return VK_ERROR_UNKNOWN;
+            }
+            parseTimer.stop();
+
+            // Running the passes lowers the graph to compute pipelines, the lowered module itself is not needed
+            utils::ScopedHostTimer loweringTimer(hostTimers, "vkCreateDataGraphPipelinesARM/lowering",
+                                                 getElapsed(PIPELINE_CREATION_PHASE_LOWERING));
+            spvtools::opt::PassManager passes;
+            passes.SetMessageConsumer(sprivMessageConsumer);
+
+            // Add passes
+            addSpecConstantDefaultPasses(passes, dataGraphPipelineShaderModuleCreateInfo->pSpecializationInfo);
+            pipeline->isTosaGraph = supportedVersions.tosa.has_value();
+            if (supportedVersions.tosa.has_value()) {
+                pipeline->profilingPipelineKind = ProfilingPipelineKind::TOSA;
+            } else if (supportedVersions.motionEngine.has_value()) {
+                pipeline->profilingPipelineKind = ProfilingPipelineKind::MOTION_ENGINE;
+            } else {
+                pipeline->profilingPipelineKind = ProfilingPipelineKind::GRAPH_OP;
+            }
 
-                // Create constants descriptor sets
-                pipeline->makeConstantsDescriptorSets();
-            } else if (pipeline->isOpticalFlow()) {
-                assert(opticalFlowCreateInfo);
-                graphLog(Severity::Debug) << "Creating Optical Flow pipeline" << std::endl;
-                // Initialise OpticalFlow
-                const auto &opticalFlowPipeline = pipeline->opticalFlow;
-                OpticalFlow::Config config;
-                config.useMvInput =
-                    (opticalFlowCreateInfo->flags & VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_HINT_BIT_ARM) != 0;
-                config.outputCost =
-                    (opticalFlowCreateInfo->flags & VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_COST_BIT_ARM) != 0;
-                config.maxSearchRange = 3;
-
-                constexpr uint32_t supportedFlags = VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_HINT_BIT_ARM |
-                                                    VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_COST_BIT_ARM;
-                if (opticalFlowCreateInfo->flags & ~supportedFlags) {
-                    graphLog(Severity::Error) << "Invalid OF flags" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
+            passes.AddPass<spvtools::opt::GraphPassTosaSpv100>(*graphPipeline);
 
-                if (config.useMvInput && !OpticalFlow::Spec::hintSupported) {
-                    graphLog(Severity::Error) << "OF hint is not supported by this implementation" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (config.outputCost && !OpticalFlow::Spec::costSupported) {
-                    graphLog(Severity::Error) << "OF cost output is not supported by this implementation" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
+            // Run passes
+            if (passes.Run(ir.get()) == spvtools::opt::Pass::Status::Failure) {
+                graphLog(Severity::Error) << "Failed to run graph passes" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            ir.reset();
+            loweringTimer.stop();
 
-                switch (opticalFlowCreateInfo->outputGridSize) {
+            // Create constants descriptor sets
+            utils::ScopedHostTimer constantsTimer(hostTimers, "vkCreateDataGraphPipelinesARM/constants",
+                                                  getElapsed(PIPELINE_CREATION_PHASE_CONSTANTS));
+            pipeline->makeConstantsDescriptorSets();
+        } else if (pipeline->isOpticalFlow()) {
+            assert(opticalFlowCreateInfo);
+            graphLog(Severity::Debug) << "Creating Optical Flow pipeline" << std::endl;
+            // Initialise OpticalFlow
+            const auto &opticalFlowPipeline = pipeline->opticalFlow;
+            OpticalFlow::Config config;
+            config.useMvInput =
+                (opticalFlowCreateInfo->flags & VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_HINT_BIT_ARM) != 0;
+            config.outputCost =
+                (opticalFlowCreateInfo->flags & VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_COST_BIT_ARM) != 0;
+            config.maxSearchRange = 3;
+
+            constexpr uint32_t supportedFlags = VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_HINT_BIT_ARM |
+                                                VK_DATA_GRAPH_OPTICAL_FLOW_CREATE_ENABLE_COST_BIT_ARM;
+            if (opticalFlowCreateInfo->flags & ~supportedFlags) {
+                graphLog(Severity::Error) << "Invalid OF flags" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+
+            if (config.useMvInput && !OpticalFlow::Spec::hintSupported) {
+                graphLog(Severity::Error) << "OF hint is not supported by this implementation" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.outputCost && !OpticalFlow::Spec::costSupported) {
+                graphLog(Severity::Error) << "OF cost output is not supported by this implementation" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+
+            switch (opticalFlowCreateInfo->outputGridSize) {
+            case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_1X1_BIT_ARM:
+                config.levelOfLastEstimation = 0;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_2X2_BIT_ARM:
+                config.levelOfLastEstimation = 1;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_4X4_BIT_ARM:
+                config.levelOfLastEstimation = 2;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_8X8_BIT_ARM:
+                config.levelOfLastEstimation = 3;
+                break;
+            default:
+                graphLog(Severity::Error) << "Invalid OF output grid size" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+
+            if (config.useMvInput && opticalFlowCreateInfo->hintGridSize == 0) {
+                graphLog(Severity::Error) << "OF hint grid size cannot be zero when hint is enabled" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (opticalFlowCreateInfo->hintGridSize != 0 &&
+                opticalFlowCreateInfo->hintGridSize != opticalFlowCreateInfo->outputGridSize) {
+                graphLog(Severity::Error)
+                    << "Output and hint grid sizes must match when hint grid size is set" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (opticalFlowCreateInfo->hintGridSize != 0) {
+                switch (opticalFlowCreateInfo->hintGridSize) {
                 case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_1X1_BIT_ARM:
-                    config.levelOfLastEstimation = 0;
-                    break;
                 case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_2X2_BIT_ARM:
-                    config.levelOfLastEstimation = 1;
-                    break;
                 case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_4X4_BIT_ARM:
-                    config.levelOfLastEstimation = 2;
-                    break;
                 case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_8X8_BIT_ARM:
-                    config.levelOfLastEstimation = 3;
                     break;
                 default:
-                    graphLog(Severity::Error) << "Invalid OF output grid size" << std::endl;
+                    graphLog(Severity::Error) << "Invalid OF hint grid size" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
+            }
 
-                if (config.useMvInput && opticalFlowCreateInfo->hintGridSize == 0) {
-                    graphLog(Severity::Error) << "OF hint grid size cannot be zero when hint is enabled" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (opticalFlowCreateInfo->hintGridSize != 0 &&
-                    opticalFlowCreateInfo->hintGridSize != opticalFlowCreateInfo->outputGridSize) {
-                    graphLog(Severity::Error)
-                        << "Output and hint grid sizes must match when hint grid size is set" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (opticalFlowCreateInfo->hintGridSize != 0) {
-                    switch (opticalFlowCreateInfo->hintGridSize) {
-                    case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_1X1_BIT_ARM:
-                    case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_2X2_BIT_ARM:
-                    case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_4X4_BIT_ARM:
-                    case VK_DATA_GRAPH_OPTICAL_FLOW_GRID_SIZE_8X8_BIT_ARM:
-                        break;
-                    default:
-                        graphLog(Severity::Error) << "Invalid OF hint grid size" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-                }
+            switch (opticalFlowCreateInfo->performanceLevel) {
+            case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_SLOW_ARM:
+                config.performanceLevel = OpticalFlow::PerformanceLevel::SLOW;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_MEDIUM_ARM:
+                config.performanceLevel = OpticalFlow::PerformanceLevel::MEDIUM;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_FAST_ARM:
+                config.performanceLevel = OpticalFlow::PerformanceLevel::FAST;
+                break;
+            case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_UNKNOWN_ARM:
+                config.performanceLevel = OpticalFlow::PerformanceLevel::UNKNOWN;
+                break;
+            default:
+                graphLog(Severity::Error) << "Invalid OF performance level" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
 
-                switch (opticalFlowCreateInfo->performanceLevel) {
-                case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_SLOW_ARM:
-                    config.performanceLevel = OpticalFlow::PerformanceLevel::SLOW;
-                    break;
-                case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_MEDIUM_ARM:
-                    config.performanceLevel = OpticalFlow::PerformanceLevel::MEDIUM;
-                    break;
-                case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_FAST_ARM:
-                    config.performanceLevel = OpticalFlow::PerformanceLevel::FAST;
-                    break;
-                case VK_DATA_GRAPH_OPTICAL_FLOW_PERFORMANCE_LEVEL_UNKNOWN_ARM:
-                    config.performanceLevel = OpticalFlow::PerformanceLevel::UNKNOWN;
-                    break;
-                default:
-                    graphLog(Severity::Error) << "Invalid OF performance level" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
+            config.imageFormat = opticalFlowCreateInfo->imageFormat;
+            config.flowFormat = opticalFlowCreateInfo->flowVectorFormat;
+            config.costFormat = opticalFlowCreateInfo->costFormat;
 
-                config.imageFormat = opticalFlowCreateInfo->imageFormat;
-                config.flowFormat = opticalFlowCreateInfo->flowVectorFormat;
-                config.costFormat = opticalFlowCreateInfo->costFormat;
+            config.width = opticalFlowCreateInfo->width;
+            config.height = opticalFlowCreateInfo->height;
 
-                config.width = opticalFlowCreateInfo->width;
-                config.height = opticalFlowCreateInfo->height;
+            const auto *opticalFlowNodeCreateInfo = singleNodeCreateInfo;
+            if (opticalFlowNodeCreateInfo == nullptr ||
+                opticalFlowNodeCreateInfo->nodeType != VK_DATA_GRAPH_PIPELINE_NODE_TYPE_OPTICAL_FLOW_ARM) {
+                graphLog(Severity::Error) << "Missing OF single node create info" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (opticalFlowNodeCreateInfo->connectionCount == 0 || opticalFlowNodeCreateInfo->pConnections == nullptr) {
+                graphLog(Severity::Error) << "Missing OF connectivity map" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
 
-                const auto *opticalFlowNodeCreateInfo = singleNodeCreateInfo;
-                if (opticalFlowNodeCreateInfo == nullptr ||
-                    opticalFlowNodeCreateInfo->nodeType != VK_DATA_GRAPH_PIPELINE_NODE_TYPE_OPTICAL_FLOW_ARM) {
-                    graphLog(Severity::Error) << "Missing OF single node create info" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (opticalFlowNodeCreateInfo->connectionCount == 0 ||
-                    opticalFlowNodeCreateInfo->pConnections == nullptr) {
-                    graphLog(Severity::Error) << "Missing OF connectivity map" << std::endl;
-                    return VK_ERROR_UNKNOWN;
+            const auto isFormatSupported = [](VkFormat format, const auto &supported) {
+                return supported.find(format) != supported.end();
+            };
+            if (!isFormatSupported(config.imageFormat, OpticalFlow::Spec::supportedImageFormats)) {
+                graphLog(Severity::Error) << "Invalid OF input/reference image format" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (!isFormatSupported(config.flowFormat, OpticalFlow::Spec::supportedFlowFormats)) {
+                graphLog(Severity::Error) << "Invalid OF flow vector format" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.outputCost && !isFormatSupported(config.costFormat, OpticalFlow::Spec::supportedCostFormats)) {
+                graphLog(Severity::Error) << "Invalid OF cost format" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.width < OpticalFlow::Spec::minWidth || config.width > OpticalFlow::Spec::maxWidth) {
+                graphLog(Severity::Error) << "Invalid OF width" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.height < OpticalFlow::Spec::minHeight || config.height > OpticalFlow::Spec::maxHeight) {
+                graphLog(Severity::Error) << "Invalid OF height" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+
+            auto getLayout = [&createInfo](uint32_t binding, uint32_t set) -> std::optional<VkImageLayout> {
+                for (uint32_t i = 0; i < createInfo.resourceInfoCount; ++i) {
+                    if (createInfo.pResourceInfos[i].descriptorSet == set &&
+                        createInfo.pResourceInfos[i].binding == binding) {
+                        const auto *const resourceInfoImageLayout =
+                            findType<VkDataGraphPipelineResourceInfoImageLayoutARM>(
+                                createInfo.pResourceInfos[i].pNext,
+                                VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_RESOURCE_INFO_IMAGE_LAYOUT_ARM);
+                        if (resourceInfoImageLayout == nullptr) {
+                            graphLog(Severity::Error)
+                                << "Missing pipeline resource image info layout struct" << std::endl;
+                            return std::nullopt;
+                        }
+                        return resourceInfoImageLayout->layout;
+                    }
                 }
+                graphLog(Severity::Error) << "Missing OF resource info for connection set/binding" << std::endl;
+                return std::nullopt;
+            };
 
-                const auto isFormatSupported = [](VkFormat format, const auto &supported) {
-                    return supported.find(format) != supported.end();
-                };
-                if (!isFormatSupported(config.imageFormat, OpticalFlow::Spec::supportedImageFormats)) {
-                    graphLog(Severity::Error) << "Invalid OF input/reference image format" << std::endl;
+            bool hasInput = false;
+            bool hasReference = false;
+            bool hasHint = false;
+            bool hasFlowVector = false;
+            bool hasCost = false;
+            std::set<VkDataGraphPipelineNodeConnectionTypeARM> seenConnectionTypes;
+            std::set<std::pair<uint32_t, uint32_t>> seenSetBindingPairs;
+
+            for (uint32_t connection = 0; connection < opticalFlowNodeCreateInfo->connectionCount; connection++) {
+                if (opticalFlowNodeCreateInfo->pConnections[connection].pNext != nullptr) {
+                    graphLog(Severity::Error) << "OF connection pNext must be null" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
-                if (!isFormatSupported(config.flowFormat, OpticalFlow::Spec::supportedFlowFormats)) {
-                    graphLog(Severity::Error) << "Invalid OF flow vector format" << std::endl;
+
+                const uint32_t set = opticalFlowNodeCreateInfo->pConnections[connection].set;
+                const uint32_t binding = opticalFlowNodeCreateInfo->pConnections[connection].binding;
+                const auto connectionType = opticalFlowNodeCreateInfo->pConnections[connection].connection;
+
+                if (!seenSetBindingPairs.insert({set, binding}).second) {
+                    graphLog(Severity::Error) << "Duplicate OF set/binding in connectivity map" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
-                if (config.outputCost &&
-                    !isFormatSupported(config.costFormat, OpticalFlow::Spec::supportedCostFormats)) {
-                    graphLog(Severity::Error) << "Invalid OF cost format" << std::endl;
+                if (!seenConnectionTypes.insert(connectionType).second) {
+                    graphLog(Severity::Error) << "Duplicate OF connection type in connectivity map" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
-                if (config.width < OpticalFlow::Spec::minWidth || config.width > OpticalFlow::Spec::maxWidth) {
-                    graphLog(Severity::Error) << "Invalid OF width" << std::endl;
+
+                const auto layout = getLayout(binding, set);
+                if (!layout.has_value()) {
                     return VK_ERROR_UNKNOWN;
                 }
-                if (config.height < OpticalFlow::Spec::minHeight || config.height > OpticalFlow::Spec::maxHeight) {
-                    graphLog(Severity::Error) << "Invalid OF height" << std::endl;
+
+                /* Create configuration */
+                OpticalFlow::Config::InputImage inputImage;
+                inputImage.binding = binding;
+                inputImage.set = set;
+                inputImage.layout = *layout;
+                switch (connectionType) {
+                case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_REFERENCE_ARM:
+                    /* Input Image storage */
+                    hasReference = true;
+                    config.srcSearch = inputImage;
+                    break;
+                case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_INPUT_ARM:
+                    /* Input Template Image storage */
+                    hasInput = true;
+                    config.srcTemplate = inputImage;
+                    break;
+                case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_HINT_ARM:
+                    /* Input Flow Input hint storage */
+                    hasHint = true;
+                    config.srcFlow = inputImage;
+                    break;
+                case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_FLOW_VECTOR_ARM:
+                    /* Output Flow Image storage */
+                    hasFlowVector = true;
+                    config.dstFlow = inputImage;
+                    break;
+                case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_COST_ARM:
+                    /* Output Cost Image storage */
+                    hasCost = true;
+                    config.dstCost = inputImage;
+                    break;
+                default:
+                    graphLog(Severity::Error) << "Invalid OF connection" << std::endl;
                     return VK_ERROR_UNKNOWN;
                 }
+            }
 
-                auto getLayout = [&createInfo](uint32_t binding, uint32_t set) -> std::optional<VkImageLayout> {
-                    for (uint32_t i = 0; i < createInfo.resourceInfoCount; ++i) {
-                        if (createInfo.pResourceInfos[i].descriptorSet == set &&
-                            createInfo.pResourceInfos[i].binding == binding) {
-                            const auto *const resourceInfoImageLayout =
-                                findType<VkDataGraphPipelineResourceInfoImageLayoutARM>(
-                                    createInfo.pResourceInfos[i].pNext,
-                                    VK_STRUCTURE_TYPE_DATA_GRAPH_PIPELINE_RESOURCE_INFO_IMAGE_LAYOUT_ARM);
-                            if (resourceInfoImageLayout == nullptr) {
-                                graphLog(Severity::Error)
-                                    << "Missing pipeline resource image info layout struct" << std::endl;
-                                return std::nullopt;
-                            }
-                            return resourceInfoImageLayout->layout;
-                        }
-                    }
-                    graphLog(Severity::Error) << "Missing OF resource info for connection set/binding" << std::endl;
-                    return std::nullopt;
-                };
+            if (!hasInput || !hasReference || !hasFlowVector) {
+                graphLog(Severity::Error)
+                    << "Missing required OF connections (input/reference/flow output)" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.useMvInput != hasHint) {
+                graphLog(Severity::Error) << "OF hint connection does not match hint create flag" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
+            if (config.outputCost != hasCost) {
+                graphLog(Severity::Error) << "OF cost connection does not match cost create flag" << std::endl;
+                return VK_ERROR_UNKNOWN;
+            }
 
-                bool hasInput = false;
-                bool hasReference = false;
-                bool hasHint = false;
-                bool hasFlowVector = false;
-                bool hasCost = false;
-                std::set<VkDataGraphPipelineNodeConnectionTypeARM> seenConnectionTypes;
-                std::set<std::pair<uint32_t, uint32_t>> seenSetBindingPairs;
-
-                for (uint32_t connection = 0; connection < opticalFlowNodeCreateInfo->connectionCount; connection++) {
-                    if (opticalFlowNodeCreateInfo->pConnections[connection].pNext != nullptr) {
-                        graphLog(Severity::Error) << "OF connection pNext must be null" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
+            utils::ScopedHostTimer loweringTimer(hostTimers, "vkCreateDataGraphPipelinesARM/optical_flow",
+                                                 getElapsed(PIPELINE_CREATION_PHASE_LOWERING));
+            opticalFlowPipeline->init(config);
+        }
 
-                    const uint32_t set = opticalFlowNodeCreateInfo->pConnections[connection].set;
-                    const uint32_t binding = opticalFlowNodeCreateInfo->pConnections[connection].binding;
-                    const auto connectionType = opticalFlowNodeCreateInfo->pConnections[connection].connection;
+        createdPipeline = std::move(pipeline);
 
-                    if (!seenSetBindingPairs.insert({set, binding}).second) {
-                        graphLog(Severity::Error) << "Duplicate OF set/binding in connectivity map" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-                    if (!seenConnectionTypes.insert(connectionType).second) {
-                        graphLog(Severity::Error) << "Duplicate OF connection type in connectivity map" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
+        pipelineTimer.stop();
+        if (creationFeedbackInfo != nullptr) {
+            creationFeedbackInfo->pPipelineCreationFeedback->flags |= VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT;
+            creationFeedbackInfo->pPipelineCreationFeedback->duration = toNanoseconds(pipelineDuration);
 
-                    const auto layout = getLayout(binding, set);
-                    if (!layout.has_value()) {
-                        return VK_ERROR_UNKNOWN;
-                    }
+            // Data graph pipelines have no shader stages, the stage feedback entries report the creation phases
+            for (uint32_t j = 0; j < creationFeedbackInfo->pipelineStageCreationFeedbackCount; j++) {
+                auto &stageFeedback = creationFeedbackInfo->pPipelineStageCreationFeedbacks[j];
+                stageFeedback = j < PIPELINE_CREATION_PHASE_COUNT
+                                    ? VkPipelineCreationFeedback{VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT,
+                                                                 toNanoseconds(phaseDurations[j])}
+                                    : VkPipelineCreationFeedback{};
+            }
+        }
 
-                    /* Create configuration */
-                    OpticalFlow::Config::InputImage inputImage;
-                    inputImage.binding = binding;
-                    inputImage.set = set;
-                    inputImage.layout = *layout;
-                    switch (connectionType) {
-                    case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_REFERENCE_ARM:
-                        /* Input Image storage */
-                        hasReference = true;
-                        config.srcSearch = inputImage;
-                        break;
-                    case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_INPUT_ARM:
-                        /* Input Template Image storage */
-                        hasInput = true;
-                        config.srcTemplate = inputImage;
-                        break;
-                    case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_HINT_ARM:
-                        /* Input Flow Input hint storage */
-                        hasHint = true;
-                        config.srcFlow = inputImage;
-                        break;
-                    case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_FLOW_VECTOR_ARM:
-                        /* Output Flow Image storage */
-                        hasFlowVector = true;
-                        config.dstFlow = inputImage;
-                        break;
-                    case VK_DATA_GRAPH_PIPELINE_NODE_CONNECTION_TYPE_OPTICAL_FLOW_COST_ARM:
-                        /* Output Cost Image storage */
-                        hasCost = true;
-                        config.dstCost = inputImage;
-                        break;
-                    default:
-                        graphLog(Severity::Error) << "Invalid OF connection" << std::endl;
-                        return VK_ERROR_UNKNOWN;
-                    }
-                }
+        return VK_SUCCESS;
+    }
 
-                if (!hasInput || !hasReference || !hasFlowVector) {
-                    graphLog(Severity::Error)
-                        << "Missing required OF connections (input/reference/flow output)" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (config.useMvInput != hasHint) {
-                    graphLog(Severity::Error) << "OF hint connection does not match hint create flag" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
-                if (config.outputCost != hasCost) {
-                    graphLog(Severity::Error) << "OF cost connection does not match cost create flag" << std::endl;
-                    return VK_ERROR_UNKNOWN;
-                }
+    static VkResult VKAPI_CALL vkCreateDataGraphPipelinesARM(VkDevice device, VkDeferredOperationKHR,
+                                                             VkPipelineCache pipelineCache, uint32_t createInfoCount,
+                                                             const VkDataGraphPipelineCreateInfoARM *createInfos,
+                                                             const VkAllocationCallbacks *callbacks,
+                                                             VkPipeline *pipelines) {
+        auto deviceHandle = VulkanLayerImpl::getHandle(device);
+        auto pipelineCacheHandle = getHandle(pipelineCache);
+        // The first data graph pipeline of the device creates its profiler
+        deviceHandle->getProfiler();
 
-                opticalFlowPipeline->init(config);
-            }
+        const auto isEarlyReturn = [&](uint32_t i) {
+            return (createInfos[i].flags & VK_PIPELINE_CREATE_2_EARLY_RETURN_ON_FAILURE_BIT_KHR) != 0;
+        };
 
-            {
-                scopedMutex l(globalMutex);
-                deviceHandle->dataGraphPipelineMap[pipelines[i]] = pipeline;
+        // Create infos are independent and are lowered in parallel. Results are reported in create info order, so the
+        // returned result and the handles written do not depend on how the work was scheduled.
+        std::vector<std::shared_ptr<DataGraphPipelineARM>> createdPipelines(createInfoCount);
+        std::vector<VkResult> results(createInfoCount, VK_SUCCESS);
+        std::vector<std::exception_ptr> exceptions(createInfoCount);
+        // Create infos after the first one failing with the early return flag are not created
+        std::atomic<uint32_t> earlyReturnIndex{createInfoCount};
+        utils::parallelFor(createInfoCount, [&](std::size_t index) {
+            const auto i = static_cast<uint32_t>(index);
+            if (i > earlyReturnIndex.load(std::memory_order_relaxed)) {
+                return;
             }
 
-            if (creationFeedbackInfo != nullptr) {
-                auto endTime = std::chrono::high_resolution_clock::now();
-                creationFeedbackInfo->pPipelineCreationFeedback->flags |= VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT;
-                creationFeedbackInfo->pPipelineCreationFeedback->duration = static_cast<uint64_t>(
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+            try {
+                results[i] = createDataGraphPipeline(deviceHandle, pipelineCacheHandle, createInfos[i], callbacks,
+                                                     createdPipelines[i]);
+            } catch (...) {
+                exceptions[i] = std::current_exception();
             }
-        }
 
-        return VK_SUCCESS;
+            if ((results[i] != VK_SUCCESS || exceptions[i]) && isEarlyReturn(i)) {
+                auto current = earlyReturnIndex.load(std::memory_order_relaxed);
+                while (i < current && !earlyReturnIndex.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+                    // A failed exchange reloads current
+                }
+            }
+        });
+
+        // Pipelines before a failing create info stay created, as if the create infos were processed in turn
+        return collectPipelineResults(
+            results, exceptions, isEarlyReturn,
+            [&](uint32_t i) {
+                const auto pipeline = reinterpret_cast<VkPipeline>(createdPipelines[i].get());
+                deviceHandle->dataGraphPipelineMap.insert(pipeline, std::move(createdPipelines[i]));
+                return pipeline;
+            },
+            pipelines);
     }
 
     static void VKAPI_CALL vkGetPhysicalDeviceFeatures2KHR(VkPhysicalDevice physicalDevice,
@@ -1277,6 +1369,13 @@ class GraphLayer : public VulkanLayerImpl {
         return vulkan12Features.descriptorBindingUniformBufferUpdateAfterBind == VK_TRUE;
     }
 
+    static bool supportsPipelineStatisticsQuery(VkPhysicalDevice physicalDevice) {
+        auto handle = VulkanLayerImpl::getHandle(physicalDevice);
+        VkPhysicalDeviceFeatures features{};
+        handle->loader->vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+        return features.pipelineStatisticsQuery == VK_TRUE;
+    }
+
     static VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *createInfo,
                                               const VkAllocationCallbacks *allocator, VkDevice *device) {
         auto originCreateInfoChain = dumpVkStructureList(createInfo);
@@ -1287,6 +1386,25 @@ class GraphLayer : public VulkanLayerImpl {
         findAndRemoveType<VkPhysicalDeviceDataGraphOpticalFlowFeaturesARM>(
             &newCreateInfo, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DATA_GRAPH_OPTICAL_FLOW_FEATURES_ARM);
 
+        // Pipeline statistics profiling needs the query feature on top of the features enabled by the application
+        VkPhysicalDeviceFeatures enabledFeatures{};
+        VkPhysicalDeviceFeatures2 enabledFeatures2{};
+        if (GraphProfiler::isPipelineStatisticsEnabled() && supportsPipelineStatisticsQuery(physicalDevice)) {
+            const auto *features2 =
+                removeType<VkPhysicalDeviceFeatures2>(&newCreateInfo, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+            if (features2 != nullptr) {
+                enabledFeatures2 = *features2;
+                enabledFeatures2.features.pipelineStatisticsQuery = VK_TRUE;
+                appendType(&newCreateInfo, &enabledFeatures2);
+            } else {
+                if (createInfo->pEnabledFeatures != nullptr) {
+                    enabledFeatures = *createInfo->pEnabledFeatures;
+                }
+                enabledFeatures.pipelineStatisticsQuery = VK_TRUE;
+                newCreateInfo.pEnabledFeatures = &enabledFeatures;
+            }
+        }
+
         auto result = VulkanLayerImpl::vkCreateDevice(physicalDevice, &newCreateInfo, allocator, device);
 
         loadVkStructureList(const_cast<VkDeviceCreateInfo *>(createInfo), originCreateInfoChain);
@@ -1304,10 +1422,7 @@ class GraphLayer : public VulkanLayerImpl {
             return;
         }
 
-        {
-            scopedMutex l(globalMutex);
-            deviceHandle->dataGraphPipelineMap.erase(pipeline);
-        }
+        deviceHandle->dataGraphPipelineMap.erase(pipeline);
     }
 
     static VkResult VKAPI_CALL vkCreateDataGraphPipelineSessionARM(
@@ -1339,6 +1454,9 @@ class GraphLayer : public VulkanLayerImpl {
             graphLog(Severity::Error) << "OF sessions currently require OF cache create flag" << std::endl;
             return VK_ERROR_UNKNOWN;
         }
+
+        // Session creation plans the transient memory of the graph
+        utils::ScopedHostTimer sessionTimer(deviceHandle->getHostTimers(), "vkCreateDataGraphPipelineSessionARM");
         *session = reinterpret_cast<VkDataGraphPipelineSessionARM>(
             allocateObject<DataGraphPipelineSessionARM>(callbacks, deviceHandle, pipelineImpl, createInfo->flags));
 
@@ -1476,7 +1594,7 @@ class GraphLayer : public VulkanLayerImpl {
                 return VK_ERROR_UNKNOWN;
             }
         }
-        const auto dataGraphPipelinePropertiesSize = deviceHandle->profiler != nullptr
+        const auto dataGraphPipelinePropertiesSize = GraphProfiler::isEnabled()
                                                          ? dataGraphPipelineProperties.size()
                                                          : dataGraphPipelineProperties.size() - 1;
         if (!pProperties) {
@@ -1517,11 +1635,12 @@ class GraphLayer : public VulkanLayerImpl {
             VkResult propertyResult = VK_SUCCESS;
 
             if (pProperties[i].property == graphProfilingProperty) {
-                if (!pipeline || !deviceHandle->profiler) {
+                auto *profiler = deviceHandle->findProfiler();
+                if (!pipeline || !profiler) {
                     return VK_ERROR_UNKNOWN;
                 }
-                propertyResult = writeTextProperty(
-                    pProperties[i], deviceHandle->profiler->getPipelineJson(pPipelineInfo->dataGraphPipeline));
+                propertyResult =
+                    writeTextProperty(pProperties[i], profiler->getPipelineJson(pPipelineInfo->dataGraphPipeline));
             } else {
                 switch (pProperties[i].property) {
                 case VK_DATA_GRAPH_PIPELINE_PROPERTY_CREATION_LOG_ARM:
@@ -1674,12 +1793,10 @@ class GraphLayer : public VulkanLayerImpl {
         auto res = deviceHandle->loader->vkAllocateDescriptorSets(device, allocateInfo, descriptorSets);
 
         if (res == VK_SUCCESS) {
-            scopedMutex l(globalMutex);
-
             for (uint32_t i = 0; i < allocateInfo->descriptorSetCount; i++) {
                 const auto descriptorSetLayout = VulkanLayerImpl::getHandle(allocateInfo->pSetLayouts[i]);
-                deviceHandle->descriptorSetMap[descriptorSets[i]] =
-                    std::make_shared<DataGraphDescriptorSet>(descriptorSetLayout);
+                deviceHandle->descriptorSetMap.insert(descriptorSets[i],
+                                                      std::make_shared<DataGraphDescriptorSet>(descriptorSetLayout));
             }
         }
 
@@ -1694,7 +1811,6 @@ class GraphLayer : public VulkanLayerImpl {
             deviceHandle->loader->vkFreeDescriptorSets(device, descriptorPool, descriptorSetCount, descriptorSets);
 
         while (descriptorSetCount-- > 0) {
-            scopedMutex l(globalMutex);
             deviceHandle->descriptorSetMap.erase(descriptorSets[descriptorSetCount]);
         }
 
@@ -1733,14 +1849,9 @@ class GraphLayer : public VulkanLayerImpl {
             for (const auto &[pipelineSet, computeDescriptorSetMap] : descriptorSet->externalDescriptorSets) {
                 const auto &[vkPipeline, set] = pipelineSet;
 
-                std::shared_ptr<DataGraphPipelineARM> dataGraphPipelineArm;
-                {
-                    scopedMutex l(globalMutex);
-                    const auto it = deviceHandle->dataGraphPipelineMap.find(vkPipeline);
-                    if (it == deviceHandle->dataGraphPipelineMap.end()) {
-                        continue; // To avoid adding nullptr
-                    }
-                    dataGraphPipelineArm = it->second;
+                const auto dataGraphPipelineArm = deviceHandle->dataGraphPipelineMap.find(vkPipeline);
+                if (!dataGraphPipelineArm) {
+                    continue;
                 }
 
                 const auto binding = vkWriteDescriptorSet.dstBinding;
@@ -1800,27 +1911,29 @@ class GraphLayer : public VulkanLayerImpl {
                                                     const VkCommandBufferBeginInfo *pBeginInfo) {
         auto handle = VulkanLayerImpl::getHandle(commandBuffer);
         auto deviceHandle = VulkanLayerImpl::getHandle(handle->device->device);
-        if (deviceHandle->profiler) {
-            deviceHandle->profiler->clearCommandBuffer(commandBuffer);
+        if (auto *profiler = deviceHandle->findProfiler()) {
+            profiler->clearCommandBuffer(commandBuffer);
         }
+        handle->arena.reset();
         return handle->loader->vkBeginCommandBuffer(commandBuffer, pBeginInfo);
     }
 
     static VkResult VKAPI_CALL vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags) {
         auto handle = VulkanLayerImpl::getHandle(commandBuffer);
         auto deviceHandle = VulkanLayerImpl::getHandle(handle->device->device);
-        if (deviceHandle->profiler) {
-            deviceHandle->profiler->clearCommandBuffer(commandBuffer);
+        if (auto *profiler = deviceHandle->findProfiler()) {
+            profiler->clearCommandBuffer(commandBuffer);
         }
+        handle->arena.reset();
         return handle->loader->vkResetCommandBuffer(commandBuffer, flags);
     }
 
     static void VKAPI_CALL vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount,
                                                 const VkCommandBuffer *commandBuffers) {
         auto deviceHandle = VulkanLayerImpl::getHandle(device);
-        if (deviceHandle->profiler) {
+        if (auto *profiler = deviceHandle->findProfiler()) {
             for (uint32_t i = 0; i < commandBufferCount; ++i) {
-                deviceHandle->profiler->clearCommandBuffer(commandBuffers[i]);
+                profiler->clearCommandBuffer(commandBuffers[i]);
             }
         }
         VulkanLayerImpl::vkFreeCommandBuffers(device, commandPool, commandBufferCount, commandBuffers);
@@ -1829,19 +1942,12 @@ class GraphLayer : public VulkanLayerImpl {
     static void VKAPI_CALL vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool,
                                                 const VkAllocationCallbacks *allocator) {
         auto deviceHandle = VulkanLayerImpl::getHandle(device);
-        if (deviceHandle->profiler) {
-            std::vector<VkCommandBuffer> commandBuffers;
-            {
-                scopedMutex l(globalMutex);
-                for (const auto &[commandBuffer, commandBufferHandle] : commandBufferMap) {
-                    if (commandBufferHandle->device == deviceHandle &&
-                        commandBufferHandle->commandPool == commandPool) {
-                        commandBuffers.push_back(commandBuffer);
-                    }
-                }
-            }
+        if (auto *profiler = deviceHandle->findProfiler()) {
+            const auto commandBuffers = commandBufferMap.findKeys([&](auto, const auto &commandBufferHandle) {
+                return commandBufferHandle->device == deviceHandle && commandBufferHandle->commandPool == commandPool;
+            });
             for (auto *const commandBuffer : commandBuffers) {
-                deviceHandle->profiler->clearCommandBuffer(commandBuffer);
+                profiler->clearCommandBuffer(commandBuffer);
             }
         }
         VulkanLayerImpl::vkDestroyCommandPool(device, commandPool, allocator);
@@ -1851,8 +1957,8 @@ class GraphLayer : public VulkanLayerImpl {
                                                 const VkCommandBuffer *pCommandBuffers) {
         auto handle = VulkanLayerImpl::getHandle(commandBuffer);
         auto deviceHandle = VulkanLayerImpl::getHandle(handle->device->device);
-        if (deviceHandle->profiler) {
-            deviceHandle->profiler->registerExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
+        if (auto *profiler = deviceHandle->findProfiler()) {
+            profiler->registerExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
         }
         handle->loader->vkCmdExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
     }
@@ -1865,16 +1971,20 @@ class GraphLayer : public VulkanLayerImpl {
         const auto &pipeline = session->pipeline;
         auto *vkPipeline = reinterpret_cast<VkPipeline>(pipeline.get());
         auto deviceHandle = VulkanLayerImpl::getHandle(handle->device->device);
+        auto *hostTimers = deviceHandle->getHostTimers();
+        utils::ScopedHostTimer dispatchTimer(hostTimers, "vkCmdDispatchDataGraphARM");
 
         if (pipeline->isGraph()) {
             const auto &graphPipeline = pipeline->graphPipeline;
+            utils::ScopedHostTimer descriptorsTimer(hostTimers, "vkCmdDispatchDataGraphARM/descriptors");
             /*
              * Merge descriptor sets, they can have three different origins:
              * - Constants owned by the pipeline
              * - Session ram owned by the session
              * - External owned by the application
              */
-            ComputeDescriptorSetMap allDescriptorSetMap;
+            const Arena::Scope arenaScope{handle->arena};
+            ComputeDescriptorSetMap allDescriptorSetMap{ComputeDescriptorSetMap::allocator_type{&handle->arena}};
 
             for (const auto &[set, vkDescriptorSet] : handle->descriptorSets) {
                 auto descriptorSet = getHandle(deviceHandle, vkDescriptorSet);
@@ -1922,9 +2032,11 @@ class GraphLayer : public VulkanLayerImpl {
                                        pipeline->constantsDescriptorSets.end());
             allDescriptorSetMap.insert(session->sessionRamDescriptorSets.begin(),
                                        session->sessionRamDescriptorSets.end());
+            descriptorsTimer.stop();
 
-            if (deviceHandle->profiler) {
-                const auto dispatchDecorator = deviceHandle->profiler->makeDispatchDecorator(
+            utils::ScopedHostTimer recordTimer(hostTimers, "vkCmdDispatchDataGraphARM/record");
+            if (auto *profiler = deviceHandle->findProfiler()) {
+                const auto dispatchDecorator = profiler->makeDispatchDecorator(
                     vkPipeline, commandBuffer, handle->queueFamilyIndex,
                     static_cast<uint32_t>(graphPipeline->getPipelines().size()), pipeline->profilingPipelineKind);
                 graphPipeline->cmdBindAndDispatch(commandBuffer, allDescriptorSetMap, dispatchDecorator);
@@ -1970,6 +2082,7 @@ class GraphLayer : public VulkanLayerImpl {
                 return;
             }
 
+            utils::ScopedHostTimer descriptorsTimer(hostTimers, "vkCmdDispatchDataGraphARM/descriptors");
             OpticalFlowDescriptorMap descriptorMap;
             for (const auto &[set, vkDescriptorSet] : handle->descriptorSets) {
                 auto descriptorSet = getHandle(deviceHandle, vkDescriptorSet);
@@ -1983,8 +2096,11 @@ class GraphLayer : public VulkanLayerImpl {
                 }
             }
             opticalFlowPipeline->updateDescriptorSets(descriptorMap);
-            if (deviceHandle->profiler) {
-                const auto dispatchDecorator = deviceHandle->profiler->makeOpticalFlowDispatchDecorator(
+            descriptorsTimer.stop();
+
+            utils::ScopedHostTimer recordTimer(hostTimers, "vkCmdDispatchDataGraphARM/record");
+            if (auto *profiler = deviceHandle->findProfiler()) {
+                const auto dispatchDecorator = profiler->makeOpticalFlowDispatchDecorator(
                     vkPipeline, commandBuffer, handle->queueFamilyIndex,
                     opticalFlowPipeline->getMaxDispatchPipelineCount());
                 opticalFlowPipeline->cmdBindAndDispatch(commandBuffer, opticalFlowFlags, meanFlowL1NormHint,
@@ -2006,8 +2122,7 @@ class GraphLayer : public VulkanLayerImpl {
         auto res = deviceHandle->loader->vkCreateTensorViewARM(device, createInfo, allocator, tensorView);
 
         if (res == VK_SUCCESS) {
-            scopedMutex l(globalMutex);
-            deviceHandle->tensorViewMap[*tensorView] = std::make_shared<TensorView>(createInfo);
+            deviceHandle->tensorViewMap.insert(*tensorView, std::make_shared<TensorView>(createInfo));
         }
 
         return res;
@@ -2018,10 +2133,7 @@ class GraphLayer : public VulkanLayerImpl {
         auto deviceHandle = VulkanLayerImpl::getHandle(device);
         deviceHandle->loader->vkDestroyTensorViewARM(device, tensorView, allocator);
 
-        {
-            scopedMutex l(globalMutex);
-            deviceHandle->tensorViewMap.erase(tensorView);
-        }
+        deviceHandle->tensorViewMap.erase(tensorView);
     }
 
     /*******************************************************************************
@@ -2041,10 +2153,7 @@ class GraphLayer : public VulkanLayerImpl {
         if (isGraph.value()) {
             auto shaderModule = std::make_shared<ShaderModule>(pCreateInfo);
             *pShaderModule = reinterpret_cast<VkShaderModule>(shaderModule.get());
-            {
-                scopedMutex l(globalMutex);
-                deviceHandle->shaderModuleMap[*pShaderModule] = std::move(shaderModule);
-            }
+            deviceHandle->shaderModuleMap.insert(*pShaderModule, std::move(shaderModule));
             return VK_SUCCESS;
         }
         return deviceHandle->loader->vkCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule);
@@ -2053,10 +2162,7 @@ class GraphLayer : public VulkanLayerImpl {
     static void VKAPI_CALL vkDestroyShaderModule(VkDevice device, VkShaderModule shaderModule,
                                                  const VkAllocationCallbacks *allocator) {
         auto deviceHandle = VulkanLayerImpl::getHandle(device);
-        scopedMutex l(globalMutex);
-        if (deviceHandle->shaderModuleMap.count(shaderModule)) {
-            deviceHandle->shaderModuleMap.erase(shaderModule);
-        } else {
+        if (!deviceHandle->shaderModuleMap.erase(shaderModule)) {
             deviceHandle->loader->vkDestroyShaderModule(device, shaderModule, allocator);
         }
     }
@@ -2106,27 +2212,32 @@ class GraphLayer : public VulkanLayerImpl {
             }
         };
 
+        const Arena::Scope arenaScope{handle->arena};
+        const ArenaAllocator<void> allocator{&handle->arena};
+
         // replace pipeline memory barrier graph flag
-        std::vector<VkMemoryBarrier2> memoryBarriers{
-            pDependencyInfo->pMemoryBarriers, pDependencyInfo->pMemoryBarriers + pDependencyInfo->memoryBarrierCount};
+        ArenaVector<VkMemoryBarrier2> memoryBarriers{
+            pDependencyInfo->pMemoryBarriers, pDependencyInfo->pMemoryBarriers + pDependencyInfo->memoryBarrierCount,
+            allocator};
         replaceBarriersGraphFlag(memoryBarriers);
 
         // replace image memory barrier graph flag
-        std::vector<VkImageMemoryBarrier2> imageBarriers{pDependencyInfo->pImageMemoryBarriers,
-                                                         pDependencyInfo->pImageMemoryBarriers +
-                                                             pDependencyInfo->imageMemoryBarrierCount};
+        ArenaVector<VkImageMemoryBarrier2> imageBarriers{
+            pDependencyInfo->pImageMemoryBarriers,
+            pDependencyInfo->pImageMemoryBarriers + pDependencyInfo->imageMemoryBarrierCount, allocator};
         replaceBarriersGraphFlag(imageBarriers);
 
-        std::vector<VkBufferMemoryBarrier2> bufferBarriers{pDependencyInfo->pBufferMemoryBarriers,
-                                                           pDependencyInfo->pBufferMemoryBarriers +
-                                                               pDependencyInfo->bufferMemoryBarrierCount};
+        ArenaVector<VkBufferMemoryBarrier2> bufferBarriers{
+            pDependencyInfo->pBufferMemoryBarriers,
+            pDependencyInfo->pBufferMemoryBarriers + pDependencyInfo->bufferMemoryBarrierCount, allocator};
         replaceBarriersGraphFlag(bufferBarriers);
 
         // replace tensor memory barrier graph flag
         if (tensorDependencyInfo != nullptr) {
-            std::vector<VkTensorMemoryBarrierARM> tensorMemoryBarriers{
+            ArenaVector<VkTensorMemoryBarrierARM> tensorMemoryBarriers{
                 tensorDependencyInfo->pTensorMemoryBarriers,
-                tensorDependencyInfo->pTensorMemoryBarriers + tensorDependencyInfo->tensorMemoryBarrierCount};
+                tensorDependencyInfo->pTensorMemoryBarriers + tensorDependencyInfo->tensorMemoryBarrierCount,
+                allocator};
 
             replaceBarriersGraphFlag(tensorMemoryBarriers);
 
@@ -2176,15 +2287,13 @@ class GraphLayer : public VulkanLayerImpl {
         switch (pNameInfo->objectType) {
         case VK_OBJECT_TYPE_PIPELINE: {
             auto *pipeline = reinterpret_cast<VkPipeline>(pNameInfo->objectHandle);
-            scopedMutex l(globalMutex);
-            if (deviceHandle->dataGraphPipelineMap.find(pipeline) != deviceHandle->dataGraphPipelineMap.end()) {
+            if (deviceHandle->dataGraphPipelineMap.find(pipeline)) {
                 return VK_SUCCESS;
             }
         } break;
         case VK_OBJECT_TYPE_SHADER_MODULE: {
             auto *shaderModule = reinterpret_cast<VkShaderModule>(pNameInfo->objectHandle);
-            scopedMutex l(globalMutex);
-            if (deviceHandle->shaderModuleMap.find(shaderModule) != deviceHandle->shaderModuleMap.end()) {
+            if (deviceHandle->shaderModuleMap.find(shaderModule)) {
                 return VK_SUCCESS;
             }
         } break;
@@ -2246,26 +2355,22 @@ class GraphLayer : public VulkanLayerImpl {
 
     static std::shared_ptr<DataGraphDescriptorSet> getHandle(const std::shared_ptr<GraphDevice> &graphDevice,
                                                              const VkDescriptorSet handle) {
-        scopedMutex l(globalMutex);
-        return graphDevice->descriptorSetMap[handle];
+        return graphDevice->descriptorSetMap.find(handle);
     }
 
     static std::shared_ptr<DataGraphPipelineARM> getHandle(const std::shared_ptr<GraphDevice> &graphDevice,
                                                            const VkPipeline handle) {
-        scopedMutex l(globalMutex);
-        return graphDevice->dataGraphPipelineMap[handle];
+        return graphDevice->dataGraphPipelineMap.find(handle);
     }
 
     static std::shared_ptr<TensorView> getHandle(const std::shared_ptr<GraphDevice> &graphDevice,
                                                  const VkTensorViewARM handle) {
-        scopedMutex l(globalMutex);
-        return graphDevice->tensorViewMap[handle];
+        return graphDevice->tensorViewMap.find(handle);
     }
 
     static std::shared_ptr<ShaderModule> getHandle(const std::shared_ptr<GraphDevice> &graphDevice,
                                                    const VkShaderModule handle) {
-        scopedMutex l(globalMutex);
-        return graphDevice->shaderModuleMap[handle];
+        return graphDevice->shaderModuleMap.find(handle);
     }
     static std::shared_ptr<PipelineCache> getHandle(const VkPipelineCache handle) {
         scopedMutex l(globalMutex);
@@ -15,26 +15,120 @@
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
-#include <cctype>
+#include <chrono>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iterator>
 #include <limits>
+#include <optional>
+#include <sstream>
+#include <tuple>
 
 using namespace mlsdk::el::compute::graph_op;
 using namespace mlsdk::el::log;
+using namespace mlsdk::el::utils;
 
 namespace mlsdk::el::layer {
 namespace {
 
-bool isTruthyEnvironmentValue(const char *value) {
+// Number of timestamp queries in each pool created by the query pool allocator. Each profiled op uses two queries, so
+// a single pool covers a few thousand ops before another pool is needed.
+constexpr uint32_t queryPoolBlockSize = 8192;
+
+std::optional<uint32_t> allocateQueryRange(std::map<uint32_t, uint32_t> &freeRanges, uint32_t queryCount) {
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        const auto [firstQuery, rangeCount] = *it;
+        if (rangeCount < queryCount) {
+            continue;
+        }
+
+        freeRanges.erase(it);
+        if (rangeCount > queryCount) {
+            freeRanges.emplace(firstQuery + queryCount, rangeCount - queryCount);
+        }
+        return firstQuery;
+    }
+    return std::nullopt;
+}
+
+void releaseQueryRange(std::map<uint32_t, uint32_t> &freeRanges, uint32_t firstQuery, uint32_t queryCount) {
+    auto it = freeRanges.emplace(firstQuery, queryCount).first;
+
+    // Merge with the following range
+    if (const auto next = std::next(it); next != freeRanges.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        freeRanges.erase(next);
+    }
+
+    // Merge with the preceding range
+    if (it != freeRanges.begin()) {
+        if (const auto prev = std::prev(it); prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            freeRanges.erase(it);
+        }
+    }
+}
+
+double getEnvironmentDouble(const char *name) {
+    const char *value = std::getenv(name);
+    if (value == nullptr || value[0] == '\0') {
+        return 0.0;
+    }
+
+    char *end = nullptr;
+    const double result = std::strtod(value, &end);
+    if (end == value || result < 0.0) {
+        graphLog(Severity::Warning) << "Ignoring invalid value for " << name << ": " << value << std::endl;
+        return 0.0;
+    }
+    return result;
+}
+
+uint64_t getEnvironmentUint64(const char *name, uint64_t defaultValue) {
+    const char *value = std::getenv(name);
     if (value == nullptr || value[0] == '\0') {
-        return false;
+        return defaultValue;
     }
 
-    std::string str{value};
-    std::transform(str.begin(), str.end(), str.begin(),
-                   [](const unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
-    return str != "0" && str != "false" && str != "off" && str != "no";
+    // strtoull accepts a minus sign and wraps the negated value around, so negative values are rejected first
+    char *end = nullptr;
+    const auto result = std::strtoull(value, &end, 10);
+    if (end == value || *end != '\0' || std::strchr(value, '-') != nullptr) {
+        graphLog(Severity::Warning) << "Ignoring invalid value for " << name << ": " << value << std::endl;
+        return defaultValue;
+    }
+    return static_cast<uint64_t>(result);
+}
+
+std::set<std::string> getEnvironmentList(const char *name) {
+    std::set<std::string> list;
+    const char *value = std::getenv(name);
+    if (value == nullptr) {
+        return list;
+    }
+
+    std::istringstream stream{value};
+    for (std::string item; std::getline(stream, item, ',');) {
+        const auto first = item.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            continue;
+        }
+        const auto last = item.find_last_not_of(" \t");
+        list.insert(item.substr(first, last - first + 1));
+    }
+    return list;
+}
+
+std::string getTraceFilePath() {
+    const char *value = std::getenv("VMEL_GRAPH_PROFILING_TRACE");
+    return value == nullptr ? std::string{} : std::string{value};
+}
+
+std::string getMetricsFilePath() {
+    const char *value = std::getenv("VMEL_GRAPH_PROFILING_METRICS");
+    return value == nullptr ? std::string{} : std::string{value};
 }
 
 std::string normalizeOperatorName(const std::string &operatorName) {
@@ -57,6 +151,31 @@ std::string profilingPipelineKindToString(ProfilingPipelineKind pipelineKind) {
     return "unknown";
 }
 
+// Classify an op against the roofline of the device. Ops at or above the ridge point, where the compute and bandwidth
+// roofs meet, are limited by arithmetic throughput, the others by memory bandwidth.
+std::string classifyRoofline(const CostEstimate &cost, double peakGflops, double peakGigabytesPerSecond) {
+    const auto bytes = cost.bytesRead + cost.bytesWritten;
+    if (cost.flops == 0) {
+        return bytes == 0 ? "unknown" : "data_movement";
+    }
+    if (bytes == 0 || peakGflops <= 0.0 || peakGigabytesPerSecond <= 0.0) {
+        return "unknown";
+    }
+
+    const auto arithmeticIntensity = static_cast<double>(cost.flops) / static_cast<double>(bytes);
+    return arithmeticIntensity >= peakGflops / peakGigabytesPerSecond ? "compute_bound" : "memory_bound";
+}
+
+nlohmann::ordered_json makeInvocationJson(uint64_t invocations, uint64_t usefulInvocations) {
+    // Fraction of the issued invocations that produce an output element, the rest is lost to padding of the dispatch
+    // grid and to idle lanes
+    const auto laneUtilization =
+        invocations != 0 ? static_cast<double>(usefulInvocations) / static_cast<double>(invocations) : 0.0;
+    return {{"invocations", invocations},
+            {"useful_invocations", usefulInvocations},
+            {"lane_utilization", laneUtilization}};
+}
+
 } // namespace
 
 struct SampleInfo {
@@ -65,10 +184,13 @@ struct SampleInfo {
     uint32_t afterQuery{};
     std::string pipelineKind;
     std::string operatorName;
+    CostEstimate cost{};
+    uint64_t usefulInvocations{};
 };
 
 struct GraphProfiler::QueryPoolRecord {
-    VkQueryPool queryPool{};
+    QueryRange queryRange;
+    QueryRange statisticsRange;
     VkCommandBuffer commandBuffer{};
     VkPipeline dataGraphPipeline{};
     uint64_t graphDispatchIndex{};
@@ -77,6 +199,7 @@ struct GraphProfiler::QueryPoolRecord {
 
 struct GraphProfiler::Sample {
     uint64_t submissionIndex{};
+    VkQueue queue{};
     uint64_t graphDispatchIndex{};
     VkCommandBuffer commandBuffer{};
     VkPipeline dataGraphPipeline{};
@@ -87,6 +210,9 @@ struct GraphProfiler::Sample {
     uint64_t after{};
     uint64_t delta{};
     double milliseconds{};
+    CostEstimate cost{};
+    std::optional<uint64_t> invocations;
+    uint64_t usefulInvocations{};
 };
 
 struct GraphProfiler::Aggregate {
@@ -94,6 +220,10 @@ struct GraphProfiler::Aggregate {
     double totalMilliseconds{};
     double minMilliseconds{std::numeric_limits<double>::max()};
     double maxMilliseconds{};
+    CostEstimate cost{};
+    uint64_t statisticsCount{};
+    uint64_t invocations{};
+    uint64_t usefulInvocations{};
 };
 
 struct GraphProfiler::SubmitRecord {
@@ -106,12 +236,35 @@ struct GraphProfiler::SubmitRecord {
 
 bool GraphProfiler::isEnabled() { return isTruthyEnvironmentValue(std::getenv("VMEL_GRAPH_PROFILING")); }
 
+bool GraphProfiler::isPipelineStatisticsEnabled() {
+    return isEnabled() && isTruthyEnvironmentValue(std::getenv("VMEL_GRAPH_PROFILING_PIPELINE_STATISTICS"));
+}
+
 GraphProfiler::GraphProfiler(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader,
                              VkPhysicalDevice _physicalDevice, VkDevice _device)
-    : loader{_loader}, physicalDevice{_physicalDevice}, device{_device} {
+    : loader{_loader}, physicalDevice{_physicalDevice}, device{_device},
+      queryPoolAllocator{_loader, _device, VK_QUERY_TYPE_TIMESTAMP},
+      statisticsQueryPoolAllocator{_loader, _device, VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                                   VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT} {
     VkPhysicalDeviceProperties properties{};
     loader->vkGetPhysicalDeviceProperties(physicalDevice, &properties);
     timestampPeriod = properties.limits.timestampPeriod;
+    peakGflops = getEnvironmentDouble("VMEL_GRAPH_PROFILING_PEAK_GFLOPS");
+    peakGigabytesPerSecond = getEnvironmentDouble("VMEL_GRAPH_PROFILING_PEAK_GBPS");
+
+    samplingOptions.dispatchInterval = std::max<uint64_t>(getEnvironmentUint64("VMEL_GRAPH_PROFILING_INTERVAL", 1), 1);
+    samplingOptions.sampleCapacity = getEnvironmentUint64("VMEL_GRAPH_PROFILING_MAX_SAMPLES", 0);
+    samplingOptions.operatorFilter = getEnvironmentList("VMEL_GRAPH_PROFILING_FILTER");
+    state.setSampleCapacity(samplingOptions.sampleCapacity);
+
+    if (isPipelineStatisticsEnabled()) {
+        VkPhysicalDeviceFeatures features{};
+        loader->vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+        samplingOptions.pipelineStatistics = features.pipelineStatisticsQuery == VK_TRUE;
+        if (!samplingOptions.pipelineStatistics) {
+            graphLog(Severity::Warning) << "Pipeline statistics queries are not supported by the device" << std::endl;
+        }
+    }
 
     uint32_t queueFamilyCount = 0;
     loader->vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
@@ -124,52 +277,66 @@ GraphProfiler::GraphProfiler(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail:
     for (const auto &property : queueFamilyProperties) {
         queueFamilyTimestampSupport.push_back(property.timestampValidBits != 0);
     }
+
+    // Started last, the export thread reads the profiler state from now on
+    if (const auto metricsFilePath = getMetricsFilePath(); !metricsFilePath.empty()) {
+        const auto interval =
+            std::max<uint64_t>(getEnvironmentUint64("VMEL_GRAPH_PROFILING_METRICS_INTERVAL_MS", 1000), 1);
+        metricsExporter = std::make_unique<MetricsExporter>(metricsFilePath, std::chrono::milliseconds{interval},
+                                                            [this] { return makeMetrics(); });
+        graphLog(Severity::Info) << "Exporting graph profiling metrics to " << metricsFilePath << " every "
+                                 << interval << " ms" << std::endl;
+    }
 }
 
-GraphProfiler::~GraphProfiler() { clearAllCommandBuffers(); }
+GraphProfiler::~GraphProfiler() {
+    // The application has to wait for all work to finish before destroying the device, so outstanding submissions
+    // can be collected without blocking.
+    collectDevice();
+    exportTrace();
+    // Stop the export thread and append the final metrics
+    metricsExporter.reset();
+    clearAllCommandBuffers();
+}
 
-VkQueryPool GraphProfiler::getQueryPool(uint32_t queueFamilyIndex, uint32_t pipelineCount) const {
+std::optional<GraphProfiler::QueryRange> GraphProfiler::getQueryRange(uint32_t queueFamilyIndex,
+                                                                      uint32_t pipelineCount) {
     if (pipelineCount == 0 || !supportsTimestampQueries(queueFamilyIndex)) {
         graphLog(Severity::Error) << "Invalid input, pipelineCount: " << pipelineCount
                                   << " and queueFamilyIndex: " << queueFamilyIndex << std::endl;
-        return VK_NULL_HANDLE;
+        return std::nullopt;
     }
 
-    const auto queryCount = pipelineCount * 2;
-    VkQueryPoolCreateInfo queryPoolCreateInfo{
-        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, // sType
-        nullptr,                                  // pNext
-        0,                                        // flags
-        VK_QUERY_TYPE_TIMESTAMP,                  // queryType
-        queryCount,                               // queryCount
-        0,                                        // pipelineStatistics
-    };
-
-    VkQueryPool queryPool = VK_NULL_HANDLE;
-    const VkResult res = loader->vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &queryPool);
-    if (res != VK_SUCCESS) {
-        graphLog(Severity::Error) << "Failed to create graph profiling query pool" << std::endl;
-        return VK_NULL_HANDLE;
-    }
-    return queryPool;
+    return queryPoolAllocator.allocate(queueFamilyIndex, pipelineCount * 2);
 }
 
 ComputePipelineDispatchDecorator GraphProfiler::makeDispatchDecorator(VkPipeline dataGraphPipeline,
                                                                       VkCommandBuffer commandBuffer,
                                                                       uint32_t queueFamilyIndex, uint32_t pipelineCount,
                                                                       ProfilingPipelineKind pipelineKind) {
-    auto *queryPool = getQueryPool(queueFamilyIndex, pipelineCount);
-    if (queryPool == VK_NULL_HANDLE) {
+    if (!shouldProfileDispatch()) {
+        return {};
+    }
+
+    const auto queryRange = getQueryRange(queueFamilyIndex, pipelineCount);
+    if (!queryRange) {
         return {};
     }
 
-    const auto queryCount = pipelineCount * 2;
-    auto record = makeRecord(queryPool, commandBuffer, dataGraphPipeline);
-    loader->vkCmdResetQueryPool(commandBuffer, queryPool, 0, queryCount);
+    auto record = makeRecord(*queryRange, commandBuffer, dataGraphPipeline);
+    loader->vkCmdResetQueryPool(commandBuffer, queryRange->queryPool, queryRange->firstQuery, queryRange->queryCount);
+    if (samplingOptions.pipelineStatistics) {
+        // Statistics are best effort, the timestamps are still recorded if no statistics queries are available
+        if (const auto statisticsRange = statisticsQueryPoolAllocator.allocate(queueFamilyIndex, pipelineCount)) {
+            record->statisticsRange = *statisticsRange;
+            loader->vkCmdResetQueryPool(commandBuffer, statisticsRange->queryPool, statisticsRange->firstQuery,
+                                        statisticsRange->queryCount);
+        }
+    }
     state.addCommandBufferRecord(commandBuffer, record);
 
     auto pipelineKindString = profilingPipelineKindToString(pipelineKind);
-    return [this, record, queryPool, pipelineCount, pipelineKindStr = std::move(pipelineKindString)](
+    return [this, record, pipelineCount, pipelineKindStr = std::move(pipelineKindString)](
                VkCommandBuffer cmdBuffer, ComputePipelineBase &pipeline,
                const ComputeDescriptorSetMap &descriptorSetMap, uint32_t pipelineIndex) {
         const auto sampleIndex = static_cast<uint32_t>(record->samples.size());
@@ -179,33 +346,53 @@ ComputePipelineDispatchDecorator GraphProfiler::makeDispatchDecorator(VkPipeline
             return;
         }
 
-        const uint32_t beforeQuery = sampleIndex * 2;
-        const uint32_t afterQuery = beforeQuery + 1;
         auto operatorName = normalizeOperatorName(pipeline.getDebugName());
-        record->samples.push_back({pipelineIndex, beforeQuery, afterQuery, pipelineKindStr, std::move(operatorName)});
+        if (!shouldProfileOperator(pipelineKindStr, operatorName)) {
+            pipeline.cmdBindAndDispatch(cmdBuffer, descriptorSetMap);
+            return;
+        }
 
-        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool, beforeQuery);
+        const uint32_t beforeQuery = sampleIndex * 2;
+        const uint32_t afterQuery = beforeQuery + 1;
+        record->samples.push_back({pipelineIndex, beforeQuery, afterQuery, pipelineKindStr, std::move(operatorName),
+                                   pipeline.getCostEstimate(), pipeline.getUsefulInvocationCount()});
+
+        const auto &[queryPool, firstQuery, _] = record->queryRange;
+        const auto &statisticsRange = record->statisticsRange;
+        const bool hasStatistics = statisticsRange.queryCount != 0;
+        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool,
+                                     firstQuery + beforeQuery);
+        if (hasStatistics) {
+            loader->vkCmdBeginQuery(cmdBuffer, statisticsRange.queryPool, statisticsRange.firstQuery + sampleIndex, 0);
+        }
         pipeline.cmdBindAndDispatch(cmdBuffer, descriptorSetMap);
-        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool, afterQuery);
+        if (hasStatistics) {
+            loader->vkCmdEndQuery(cmdBuffer, statisticsRange.queryPool, statisticsRange.firstQuery + sampleIndex);
+        }
+        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool,
+                                     firstQuery + afterQuery);
     };
 }
 
 mlsdk::el::compute::optical_flow::ComputePipelineDispatchDecorator
 GraphProfiler::makeOpticalFlowDispatchDecorator(VkPipeline dataGraphPipeline, VkCommandBuffer commandBuffer,
                                                 uint32_t queueFamilyIndex, uint32_t pipelineCount) {
-    auto *queryPool = getQueryPool(queueFamilyIndex, pipelineCount);
-    if (queryPool == VK_NULL_HANDLE) {
+    if (!shouldProfileDispatch()) {
         return {};
     }
 
-    const auto queryCount = pipelineCount * 2;
-    auto record = makeRecord(queryPool, commandBuffer, dataGraphPipeline);
-    loader->vkCmdResetQueryPool(commandBuffer, queryPool, 0, queryCount);
+    const auto queryRange = getQueryRange(queueFamilyIndex, pipelineCount);
+    if (!queryRange) {
+        return {};
+    }
+
+    auto record = makeRecord(*queryRange, commandBuffer, dataGraphPipeline);
+    loader->vkCmdResetQueryPool(commandBuffer, queryRange->queryPool, queryRange->firstQuery, queryRange->queryCount);
     state.addCommandBufferRecord(commandBuffer, record);
 
-    return [this, record, queryPool, pipelineCount](VkCommandBuffer cmdBuffer,
-                                                    mlsdk::el::compute::optical_flow::ComputePipeline &pipeline,
-                                                    uint32_t pipelineIndex) {
+    return [this, record, pipelineCount](VkCommandBuffer cmdBuffer,
+                                         mlsdk::el::compute::optical_flow::ComputePipeline &pipeline,
+                                         uint32_t pipelineIndex) {
         const auto sampleIndex = static_cast<uint32_t>(record->samples.size());
         if (sampleIndex >= pipelineCount) {
             graphLog(Severity::Error) << "Optical-flow profiling query pool is too small for recorded dispatches"
@@ -214,17 +401,36 @@ GraphProfiler::makeOpticalFlowDispatchDecorator(VkPipeline dataGraphPipeline, Vk
             return;
         }
 
+        auto operatorName = normalizeOperatorName(pipeline.getDebugName());
+        if (!shouldProfileOperator("optical_flow", operatorName)) {
+            pipeline.bindAndDispatch(cmdBuffer);
+            return;
+        }
+
         const uint32_t beforeQuery = sampleIndex * 2;
         const uint32_t afterQuery = beforeQuery + 1;
-        auto operatorName = normalizeOperatorName(pipeline.getDebugName());
         record->samples.push_back({pipelineIndex, beforeQuery, afterQuery, "optical_flow", std::move(operatorName)});
 
-        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool, beforeQuery);
+        const auto &[queryPool, firstQuery, _] = record->queryRange;
+        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool,
+                                     firstQuery + beforeQuery);
         pipeline.bindAndDispatch(cmdBuffer);
-        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool, afterQuery);
+        loader->vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, queryPool,
+                                     firstQuery + afterQuery);
     };
 }
 
+bool GraphProfiler::shouldProfileDispatch() {
+    return dispatchCounter.fetch_add(1, std::memory_order_relaxed) % samplingOptions.dispatchInterval == 0;
+}
+
+bool GraphProfiler::shouldProfileOperator(const std::string &pipelineKind, const std::string &operatorName) const {
+    const auto &filter = samplingOptions.operatorFilter;
+    return filter.empty() || filter.count(pipelineKind) != 0 || filter.count(operatorName) != 0;
+}
+
+HostTimerRegistry &GraphProfiler::getHostTimers() { return hostTimers; }
+
 bool GraphProfiler::hasProfiledCommandBuffers(const std::vector<VkCommandBuffer> &commandBuffers) const {
     return state.hasProfiledCommandBuffers(commandBuffers);
 }
@@ -296,8 +502,9 @@ bool GraphProfiler::collectSubmission(const std::shared_ptr<SubmitRecord> &submi
             continue;
         }
 
+        const auto &[queryPool, firstQuery, _] = record->queryRange;
         const VkResult res = loader->vkGetQueryPoolResults(
-            device, record->queryPool, 0, static_cast<uint32_t>(timestamps.size()),
+            device, queryPool, firstQuery, static_cast<uint32_t>(timestamps.size()),
             timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
         if (res == VK_NOT_READY) {
             return false;
@@ -307,15 +514,36 @@ bool GraphProfiler::collectSubmission(const std::shared_ptr<SubmitRecord> &submi
             return false;
         }
 
+        // One compute shader invocation count per sample, in the order the samples were recorded
+        std::vector<uint64_t> invocations;
+        if (const auto &statisticsRange = record->statisticsRange; statisticsRange.queryCount != 0) {
+            invocations.resize(record->samples.size());
+            const VkResult statisticsRes = loader->vkGetQueryPoolResults(
+                device, statisticsRange.queryPool, statisticsRange.firstQuery,
+                static_cast<uint32_t>(invocations.size()), invocations.size() * sizeof(uint64_t), invocations.data(),
+                sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (statisticsRes == VK_NOT_READY) {
+                return false;
+            }
+            if (statisticsRes != VK_SUCCESS) {
+                graphLog(Severity::Error) << "Failed to read graph profiling pipeline statistics" << std::endl;
+                return false;
+            }
+        }
+
         newSamples.reserve(newSamples.size() + record->samples.size());
-        for (const auto &sampleInfo : record->samples) {
+        for (size_t i = 0; i < record->samples.size(); i++) {
+            const auto &sampleInfo = record->samples[i];
             const auto before = timestamps[sampleInfo.beforeQuery];
             const auto after = timestamps[sampleInfo.afterQuery];
             const auto delta = after >= before ? after - before : 0;
-            newSamples.push_back({submission->submissionIndex, record->graphDispatchIndex, record->commandBuffer,
-                                  record->dataGraphPipeline, sampleInfo.pipelineIndex, sampleInfo.pipelineKind,
-                                  sampleInfo.operatorName, before, after, delta,
-                                  static_cast<double>(delta) * static_cast<double>(timestampPeriod) / 1000000.0});
+            newSamples.push_back({submission->submissionIndex, submission->queue, record->graphDispatchIndex,
+                                  record->commandBuffer, record->dataGraphPipeline, sampleInfo.pipelineIndex,
+                                  sampleInfo.pipelineKind, sampleInfo.operatorName, before, after, delta,
+                                  static_cast<double>(delta) * static_cast<double>(timestampPeriod) / 1000000.0,
+                                  sampleInfo.cost,
+                                  invocations.empty() ? std::nullopt : std::optional<uint64_t>{invocations[i]},
+                                  sampleInfo.usefulInvocations});
         }
     }
     return true;
@@ -345,26 +573,111 @@ std::string GraphProfiler::getPipelineJson(VkPipeline dataGraphPipeline) {
         graphLog(Severity::Error) << "Failed waiting for graph profiling device idle before query" << std::endl;
     }
 
+    exportTrace();
     return makeJson(dataGraphPipeline);
 }
 
+void GraphProfiler::exportTrace() {
+    const auto traceFilePath = getTraceFilePath();
+    if (traceFilePath.empty()) {
+        return;
+    }
+
+    std::ofstream traceFile(traceFilePath);
+    if (!traceFile) {
+        graphLog(Severity::Error) << "Failed to open graph profiling trace file " << traceFilePath << std::endl;
+        return;
+    }
+
+    traceFile << makeTraceJson(state.getSamples()).dump();
+    graphLog(Severity::Info) << "Wrote graph profiling trace to " << traceFilePath << std::endl;
+}
+
 std::shared_ptr<GraphProfiler::QueryPoolRecord>
-GraphProfiler::makeRecord(VkQueryPool queryPool, VkCommandBuffer commandBuffer, VkPipeline dataGraphPipeline) {
-    auto deleter = [capturedLoader = loader, capturedDevice = device](QueryPoolRecord *record) {
-        if (record->queryPool != VK_NULL_HANDLE) {
-            capturedLoader->vkDestroyQueryPool(capturedDevice, record->queryPool, nullptr);
-        }
+GraphProfiler::makeRecord(const QueryRange &queryRange, VkCommandBuffer commandBuffer, VkPipeline dataGraphPipeline) {
+    // Query ranges go back to the allocator once neither the command buffer nor any pending submission refers to the
+    // record, so a recycled range is never overwritten while its results are still waiting to be collected.
+    auto deleter = [allocator = &queryPoolAllocator,
+                    statisticsAllocator = &statisticsQueryPoolAllocator](QueryPoolRecord *record) {
+        allocator->release(record->queryRange);
+        statisticsAllocator->release(record->statisticsRange);
         delete record;
     };
 
     auto record = std::shared_ptr<QueryPoolRecord>(new QueryPoolRecord{}, std::move(deleter));
-    record->queryPool = queryPool;
+    record->queryRange = queryRange;
     record->commandBuffer = commandBuffer;
     record->dataGraphPipeline = dataGraphPipeline;
     record->graphDispatchIndex = state.nextGraphDispatchIndex();
     return record;
 }
 
+GraphProfiler::QueryPoolAllocator::QueryPoolAllocator(
+    const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader, VkDevice _device,
+    VkQueryType _queryType, VkQueryPipelineStatisticFlags _pipelineStatistics)
+    : loader{_loader}, device{_device}, queryType{_queryType}, pipelineStatistics{_pipelineStatistics} {}
+
+GraphProfiler::QueryPoolAllocator::~QueryPoolAllocator() {
+    for (const auto &[_, familyPools] : pools) {
+        for (const auto &pool : familyPools) {
+            loader->vkDestroyQueryPool(device, pool.queryPool, nullptr);
+        }
+    }
+}
+
+std::optional<GraphProfiler::QueryRange> GraphProfiler::QueryPoolAllocator::allocate(uint32_t queueFamilyIndex,
+                                                                                     uint32_t queryCount) {
+    std::lock_guard lock(mutex);
+    auto &familyPools = pools[queueFamilyIndex];
+    for (auto &pool : familyPools) {
+        if (const auto firstQuery = allocateQueryRange(pool.freeRanges, queryCount)) {
+            return QueryRange{pool.queryPool, *firstQuery, queryCount};
+        }
+    }
+
+    const auto poolQueryCount = std::max(queryPoolBlockSize, queryCount);
+    VkQueryPoolCreateInfo queryPoolCreateInfo{
+        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, // sType
+        nullptr,                                  // pNext
+        0,                                        // flags
+        queryType,                                // queryType
+        poolQueryCount,                           // queryCount
+        pipelineStatistics,                       // pipelineStatistics
+    };
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    const VkResult res = loader->vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &queryPool);
+    if (res != VK_SUCCESS) {
+        graphLog(Severity::Error) << "Failed to create graph profiling query pool" << std::endl;
+        return std::nullopt;
+    }
+
+    MLEL_LOG(graphLog, Severity::Debug) << "Created graph profiling query pool with " << poolQueryCount
+                                        << " queries for queue family " << queueFamilyIndex << std::endl;
+
+    auto &pool = familyPools.emplace_back(Pool{queryPool, poolQueryCount, {}});
+    if (poolQueryCount > queryCount) {
+        pool.freeRanges.emplace(queryCount, poolQueryCount - queryCount);
+    }
+    return QueryRange{queryPool, 0, queryCount};
+}
+
+void GraphProfiler::QueryPoolAllocator::release(const QueryRange &range) {
+    if (range.queryPool == VK_NULL_HANDLE || range.queryCount == 0) {
+        return;
+    }
+
+    std::lock_guard lock(mutex);
+    for (auto &[_, familyPools] : pools) {
+        const auto it = std::find_if(familyPools.begin(), familyPools.end(),
+                                     [&range](const auto &pool) { return pool.queryPool == range.queryPool; });
+        if (it != familyPools.end()) {
+            releaseQueryRange(it->freeRanges, range.firstQuery, range.queryCount);
+            return;
+        }
+    }
+}
+
 uint64_t GraphProfiler::LockedState::nextGraphDispatchIndex() {
     std::lock_guard lock(mutex);
     return graphDispatchCounter++;
@@ -510,6 +823,13 @@ void GraphProfiler::LockedState::completeSubmissions(const CompletedSubmissions
         samples.insert(samples.end(), newSamples.begin(), newSamples.end());
         submissions.erase(it);
     }
+
+    // Keep only the most recent samples when the history is bounded
+    if (sampleCapacity != 0 && samples.size() > sampleCapacity) {
+        const auto excess = samples.size() - sampleCapacity;
+        samples.erase(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(excess));
+        droppedSampleCount += excess;
+    }
 }
 
 void GraphProfiler::LockedState::clearCommandBuffer(VkCommandBuffer commandBuffer) {
@@ -547,7 +867,7 @@ void GraphProfiler::LockedState::removeSubmissionsForCommandBufferLocked(VkComma
 
 std::vector<GraphProfiler::Sample> GraphProfiler::LockedState::getSamples() const {
     std::lock_guard lock(mutex);
-    return samples;
+    return {samples.begin(), samples.end()};
 }
 
 std::vector<GraphProfiler::Sample> GraphProfiler::LockedState::getSamples(VkPipeline dataGraphPipeline) const {
@@ -558,27 +878,66 @@ std::vector<GraphProfiler::Sample> GraphProfiler::LockedState::getSamples(VkPipe
     return pipelineSamples;
 }
 
+uint64_t GraphProfiler::LockedState::getDroppedSampleCount() const {
+    std::lock_guard lock(mutex);
+    return droppedSampleCount;
+}
+
+void GraphProfiler::LockedState::setSampleCapacity(size_t capacity) {
+    std::lock_guard lock(mutex);
+    sampleCapacity = capacity;
+}
+
 void GraphProfiler::clearAllCommandBuffers() { state.clearAllCommandBuffers(); }
 
-nlohmann::ordered_json GraphProfiler::toJson(const Sample &sample) {
-    return {{"submission", sample.submissionIndex},   {"graph_dispatch", sample.graphDispatchIndex},
-            {"pipeline_index", sample.pipelineIndex}, {"pipeline_kind", sample.pipelineKind},
-            {"operator_name", sample.operatorName},   {"cycle_count_before", sample.before},
-            {"cycle_count_after", sample.after},      {"cycle_count_delta", sample.delta},
-            {"time_ms", sample.milliseconds}};
+nlohmann::ordered_json GraphProfiler::toJson(const Sample &sample) const {
+    nlohmann::ordered_json json = {{"submission", sample.submissionIndex},
+                                   {"graph_dispatch", sample.graphDispatchIndex},
+                                   {"pipeline_index", sample.pipelineIndex},
+                                   {"pipeline_kind", sample.pipelineKind},
+                                   {"operator_name", sample.operatorName},
+                                   {"cycle_count_before", sample.before},
+                                   {"cycle_count_after", sample.after},
+                                   {"cycle_count_delta", sample.delta},
+                                   {"time_ms", sample.milliseconds}};
+    json.update(toJson(sample.cost, sample.milliseconds));
+    if (sample.invocations.has_value()) {
+        json.update(makeInvocationJson(*sample.invocations, sample.usefulInvocations));
+    }
+    return json;
 }
 
 nlohmann::ordered_json GraphProfiler::toJson(const Aggregate &aggregate, const std::string &pipelineKind,
-                                             const std::string &operatorName) {
+                                             const std::string &operatorName) const {
     const bool hasSamples = aggregate.count != 0;
     const auto average = hasSamples ? aggregate.totalMilliseconds / aggregate.count : 0.0;
-    return {{"pipeline_kind", pipelineKind},
-            {"operator_name", operatorName},
-            {"dispatch_count", aggregate.count},
-            {"total_time_ms", aggregate.totalMilliseconds},
-            {"average_time_ms", average},
-            {"min_time_ms", hasSamples ? aggregate.minMilliseconds : 0.0},
-            {"max_time_ms", hasSamples ? aggregate.maxMilliseconds : 0.0}};
+    nlohmann::ordered_json json = {{"pipeline_kind", pipelineKind},
+                                   {"operator_name", operatorName},
+                                   {"dispatch_count", aggregate.count},
+                                   {"total_time_ms", aggregate.totalMilliseconds},
+                                   {"average_time_ms", average},
+                                   {"min_time_ms", hasSamples ? aggregate.minMilliseconds : 0.0},
+                                   {"max_time_ms", hasSamples ? aggregate.maxMilliseconds : 0.0}};
+    json.update(toJson(aggregate.cost, aggregate.totalMilliseconds));
+    if (aggregate.statisticsCount != 0) {
+        json.update(makeInvocationJson(aggregate.invocations, aggregate.usefulInvocations));
+    }
+    return json;
+}
+
+nlohmann::ordered_json GraphProfiler::toJson(const CostEstimate &cost, double milliseconds) const {
+    const auto bytes = cost.bytesRead + cost.bytesWritten;
+    const auto arithmeticIntensity = bytes != 0 ? static_cast<double>(cost.flops) / static_cast<double>(bytes) : 0.0;
+    // Operations per millisecond divided by 1e6 gives giga-operations per second
+    const auto gflopsPerSecond = milliseconds > 0.0 ? static_cast<double>(cost.flops) / milliseconds / 1e6 : 0.0;
+    const auto gigabytesPerSecond = milliseconds > 0.0 ? static_cast<double>(bytes) / milliseconds / 1e6 : 0.0;
+    return {{"flops", cost.flops},
+            {"bytes_read", cost.bytesRead},
+            {"bytes_written", cost.bytesWritten},
+            {"arithmetic_intensity", arithmeticIntensity},
+            {"gflops_per_s", gflopsPerSecond},
+            {"gb_per_s", gigabytesPerSecond},
+            {"roofline", classifyRoofline(cost, peakGflops, peakGigabytesPerSecond)}};
 }
 
 std::string GraphProfiler::makeJson() const { return makeJson(state.getSamples()); }
@@ -596,6 +955,15 @@ std::string GraphProfiler::makeJson(const std::vector<Sample> &profileSamples) c
         aggregate.totalMilliseconds += sample.milliseconds;
         aggregate.minMilliseconds = std::min(aggregate.minMilliseconds, sample.milliseconds);
         aggregate.maxMilliseconds = std::max(aggregate.maxMilliseconds, sample.milliseconds);
+        aggregate.cost.flops += sample.cost.flops;
+        aggregate.cost.bytesRead += sample.cost.bytesRead;
+        aggregate.cost.bytesWritten += sample.cost.bytesWritten;
+        if (sample.invocations.has_value()) {
+            // Only samples with statistics contribute, so the utilization is not skewed by unqueried dispatches
+            aggregate.statisticsCount++;
+            aggregate.invocations += *sample.invocations;
+            aggregate.usefulInvocations += sample.usefulInvocations;
+        }
     }
 
     using Json = nlohmann::ordered_json;
@@ -615,11 +983,213 @@ std::string GraphProfiler::makeJson(const std::vector<Sample> &profileSamples) c
 
     Json output;
     output["timestamp_period_ns"] = timestampPeriod;
+    output["peak_gflops"] = peakGflops;
+    output["peak_gb_per_s"] = peakGigabytesPerSecond;
+    output["dispatch_interval"] = samplingOptions.dispatchInterval;
+    output["pipeline_statistics"] = samplingOptions.pipelineStatistics;
+    output["dropped_samples"] = state.getDroppedSampleCount();
     output["samples"] = std::move(sampleJson);
     output["by_operator"] = std::move(aggregateJson);
+    output["host_phases"] = makeHostPhasesJson();
     return output.dump(2);
 }
 
+std::string GraphProfiler::makeMetrics() const {
+    using SeriesKey = std::tuple<VkPipeline, std::string, std::string>;
+    std::map<SeriesKey, std::vector<double>> latencies;
+    for (const auto &sample : state.getSamples()) {
+        latencies[{sample.dataGraphPipeline, sample.pipelineKind, sample.operatorName}].push_back(
+            sample.milliseconds / 1000.0);
+    }
+
+    std::vector<LatencySeries> series;
+    series.reserve(latencies.size());
+    for (auto &[key, seconds] : latencies) {
+        const auto &[dataGraphPipeline, pipelineKind, operatorName] = key;
+        std::ostringstream pipeline;
+        pipeline << dataGraphPipeline;
+        series.push_back({pipeline.str(), pipelineKind, operatorName, std::move(seconds)});
+    }
+
+    const auto now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return formatOpenMetrics(series, now);
+}
+
+nlohmann::ordered_json GraphProfiler::makeHostPhasesJson() const {
+    using Json = nlohmann::ordered_json;
+    const auto toMilliseconds = [](uint64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1000000.0; };
+
+    Json phases = Json::array();
+    for (const auto &[phase, histogram] : hostTimers.getHistograms()) {
+        const auto average = histogram.count != 0 ? histogram.totalNanoseconds / histogram.count : 0;
+        Json buckets = Json::array();
+        for (const auto bucket : histogram.buckets) {
+            buckets.push_back(bucket);
+        }
+        phases.push_back({{"phase", phase},
+                          {"count", histogram.count},
+                          {"total_time_ms", toMilliseconds(histogram.totalNanoseconds)},
+                          {"average_time_ms", toMilliseconds(average)},
+                          {"min_time_ms", toMilliseconds(histogram.minNanoseconds)},
+                          {"max_time_ms", toMilliseconds(histogram.maxNanoseconds)},
+                          {"p50_time_ms", toMilliseconds(histogram.percentile(0.50))},
+                          {"p95_time_ms", toMilliseconds(histogram.percentile(0.95))},
+                          {"p99_time_ms", toMilliseconds(histogram.percentile(0.99))},
+                          {"histogram_us_log2", std::move(buckets)}});
+    }
+    return phases;
+}
+
+nlohmann::ordered_json GraphProfiler::makeTraceJson(const std::vector<Sample> &profileSamples) const {
+    using Json = nlohmann::ordered_json;
+    constexpr uint32_t processId = 1;
+
+    Json events = Json::array();
+    events.push_back(
+        {{"name", "process_name"}, {"ph", "M"}, {"pid", processId}, {"args", {{"name", "Graph profiling"}}}});
+
+    appendHostTraceEvents(events);
+
+    Json output;
+    output["displayTimeUnit"] = "ns";
+    if (profileSamples.empty()) {
+        output["traceEvents"] = std::move(events);
+        return output;
+    }
+
+    // Timestamps have an arbitrary origin, so the trace starts at the earliest recorded timestamp
+    const auto origin =
+        std::min_element(profileSamples.begin(), profileSamples.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.before < rhs.before;
+        })->before;
+    const auto toMicroseconds = [this](uint64_t ticks) {
+        return static_cast<double>(ticks) * static_cast<double>(timestampPeriod) / 1000.0;
+    };
+
+    // One track per queue, named in order of first appearance
+    std::map<VkQueue, uint32_t> queueTracks;
+    for (const auto &sample : profileSamples) {
+        const auto track = static_cast<uint32_t>(queueTracks.size());
+        queueTracks.try_emplace(sample.queue, track);
+    }
+    for (const auto &[queue, track] : queueTracks) {
+        std::ostringstream trackName;
+        trackName << "Queue " << track << " (" << queue << ")";
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", processId},
+                          {"tid", track},
+                          {"args", {{"name", trackName.str()}}}});
+    }
+
+    // First and last op of every submitted graph dispatch, used to draw flow arrows between dispatches
+    struct DispatchSpan {
+        const Sample *first{};
+        const Sample *last{};
+    };
+    using DispatchKey = std::pair<uint64_t, uint64_t>;
+    std::map<DispatchKey, DispatchSpan> dispatchSpans;
+
+    for (const auto &sample : profileSamples) {
+        const auto track = queueTracks.at(sample.queue);
+        events.push_back({{"name", sample.operatorName},
+                          {"cat", sample.pipelineKind},
+                          {"ph", "X"},
+                          {"pid", processId},
+                          {"tid", track},
+                          {"ts", toMicroseconds(sample.before - origin)},
+                          {"dur", toMicroseconds(sample.delta)},
+                          {"args",
+                           {{"pipeline_kind", sample.pipelineKind},
+                            {"graph_dispatch", sample.graphDispatchIndex},
+                            {"submission", sample.submissionIndex},
+                            {"pipeline_index", sample.pipelineIndex}}}});
+
+        auto &span = dispatchSpans[{sample.submissionIndex, sample.graphDispatchIndex}];
+        if (span.first == nullptr || sample.before < span.first->before) {
+            span.first = &sample;
+        }
+        if (span.last == nullptr || sample.before > span.last->before) {
+            span.last = &sample;
+        }
+    }
+
+    // Connect consecutive graph dispatches on the same queue, ordered by start time
+    std::map<VkQueue, std::vector<DispatchSpan>> queueSpans;
+    for (const auto &[_, span] : dispatchSpans) {
+        queueSpans[span.first->queue].push_back(span);
+    }
+
+    uint64_t flowId = 0;
+    for (auto &[queue, spans] : queueSpans) {
+        std::sort(spans.begin(), spans.end(),
+                  [](const auto &lhs, const auto &rhs) { return lhs.first->before < rhs.first->before; });
+
+        const auto track = queueTracks.at(queue);
+        for (size_t i = 1; i < spans.size(); ++i) {
+            const auto *from = spans[i - 1].last;
+            const auto *to = spans[i].first;
+            events.push_back({{"name", "graph_dispatch"},
+                              {"cat", "graph_dispatch"},
+                              {"ph", "s"},
+                              {"id", flowId},
+                              {"pid", processId},
+                              {"tid", track},
+                              {"ts", toMicroseconds(from->before - origin)}});
+            events.push_back({{"name", "graph_dispatch"},
+                              {"cat", "graph_dispatch"},
+                              {"ph", "f"},
+                              {"bp", "e"},
+                              {"id", flowId},
+                              {"pid", processId},
+                              {"tid", track},
+                              {"ts", toMicroseconds(to->before - origin)}});
+            flowId++;
+        }
+    }
+
+    output["traceEvents"] = std::move(events);
+    return output;
+}
+
+void GraphProfiler::appendHostTraceEvents(nlohmann::ordered_json &events) const {
+    constexpr uint32_t processId = 2;
+    const auto hostEvents = hostTimers.getEvents();
+    if (hostEvents.empty()) {
+        return;
+    }
+
+    events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", processId}, {"args", {{"name", "Host"}}}});
+
+    // Host time uses its own origin, the GPU and host tracks are not aligned to each other
+    const auto origin =
+        std::min_element(hostEvents.begin(), hostEvents.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.start < rhs.start;
+        })->start;
+
+    std::map<size_t, uint32_t> threadTracks;
+    for (const auto &event : hostEvents) {
+        const auto track = static_cast<uint32_t>(threadTracks.size());
+        const auto [it, inserted] = threadTracks.try_emplace(event.threadId, track);
+        if (inserted) {
+            events.push_back({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", processId},
+                              {"tid", it->second},
+                              {"args", {{"name", "Thread " + std::to_string(it->second)}}}});
+        }
+
+        const auto start = std::chrono::duration_cast<std::chrono::nanoseconds>(event.start - origin).count();
+        events.push_back({{"name", event.phase},
+                          {"cat", "host"},
+                          {"ph", "X"},
+                          {"pid", processId},
+                          {"tid", it->second},
+                          {"ts", static_cast<double>(start) / 1000.0},
+                          {"dur", static_cast<double>(event.nanoseconds) / 1000.0}});
+    }
+}
+
 bool GraphProfiler::supportsTimestampQueries(uint32_t queueFamilyIndex) const {
     return queueFamilyIndex < queueFamilyTimestampSupport.size() && queueFamilyTimestampSupport[queueFamilyIndex];
 }
@@ -12,12 +12,19 @@
 
 #include "compute_graph_op.hpp"
 #include "compute_optical_flow.hpp"
+#include "metrics_exporter.hpp"
+#include "mlel/host_timer.hpp"
 
 #include <nlohmann/json.hpp>
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,6 +45,12 @@ class GraphProfiler {
   public:
     static bool isEnabled();
 
+    /**
+     * Return true if per-op pipeline statistics queries are requested with VMEL_GRAPH_PROFILING_PIPELINE_STATISTICS.
+     * The layer then enables the pipelineStatisticsQuery device feature when it is supported.
+     */
+    static bool isPipelineStatisticsEnabled();
+
     GraphProfiler(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader,
                   VkPhysicalDevice _physicalDevice, VkDevice _device);
     ~GraphProfiler();
@@ -64,6 +77,17 @@ class GraphProfiler {
     void clearCommandBuffer(VkCommandBuffer commandBuffer);
     std::string getPipelineJson(VkPipeline dataGraphPipeline);
 
+    /**
+     * Host side phase timers of the layer entry points, reported next to the GPU samples.
+     */
+    mlsdk::el::utils::HostTimerRegistry &getHostTimers();
+
+    /**
+     * Write all collected samples as a Chrome Trace Event file to the path given by VMEL_GRAPH_PROFILING_TRACE.
+     * Does nothing if the environment variable is not set.
+     */
+    void exportTrace();
+
   private:
     struct QueryPoolRecord;
     struct Sample;
@@ -72,6 +96,46 @@ class GraphProfiler {
     using Submissions = std::vector<std::shared_ptr<SubmitRecord>>;
     using CompletedSubmissions = std::vector<std::pair<std::shared_ptr<SubmitRecord>, std::vector<Sample>>>;
 
+    struct QueryRange {
+        VkQueryPool queryPool{};
+        uint32_t firstQuery{};
+        uint32_t queryCount{};
+    };
+
+    /**
+     * Suballocates query ranges from a small set of large query pools per queue family.
+     *
+     * Ranges are handed back when the query record owning them is released, which happens once the command buffer
+     * that recorded them has been reset or freed and all its submissions have been collected.
+     */
+    class QueryPoolAllocator {
+      public:
+        QueryPoolAllocator(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader,
+                           VkDevice _device, VkQueryType _queryType,
+                           VkQueryPipelineStatisticFlags _pipelineStatistics = 0);
+        ~QueryPoolAllocator();
+
+        QueryPoolAllocator(const QueryPoolAllocator &) = delete;
+        QueryPoolAllocator &operator=(const QueryPoolAllocator &) = delete;
+
+        std::optional<QueryRange> allocate(uint32_t queueFamilyIndex, uint32_t queryCount);
+        void release(const QueryRange &range);
+
+      private:
+        struct Pool {
+            VkQueryPool queryPool{};
+            uint32_t queryCount{};
+            std::map<uint32_t, uint32_t> freeRanges; // firstQuery -> queryCount
+        };
+
+        std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> loader;
+        VkDevice device{};
+        VkQueryType queryType{};
+        VkQueryPipelineStatisticFlags pipelineStatistics{};
+        std::mutex mutex;
+        std::map<uint32_t, std::vector<Pool>> pools;
+    };
+
     class LockedState {
       public:
         uint64_t nextGraphDispatchIndex();
@@ -90,6 +154,8 @@ class GraphProfiler {
         void clearAllCommandBuffers();
         std::vector<Sample> getSamples() const;
         std::vector<Sample> getSamples(VkPipeline dataGraphPipeline) const;
+        uint64_t getDroppedSampleCount() const;
+        void setSampleCapacity(size_t capacity);
 
       private:
         std::vector<std::shared_ptr<QueryPoolRecord>>
@@ -101,12 +167,27 @@ class GraphProfiler {
         uint64_t submissionCounter{};
         std::map<VkCommandBuffer, std::vector<std::shared_ptr<QueryPoolRecord>>> commandBufferRecords;
         Submissions submissions;
-        std::vector<Sample> samples;
+        std::deque<Sample> samples;
+        size_t sampleCapacity{};
+        uint64_t droppedSampleCount{};
     };
 
-    VkQueryPool getQueryPool(uint32_t queueFamilyIndex, uint32_t pipelineCount) const;
+    /**
+     * Controls how much work is instrumented so the profiler can be left running with bounded overhead.
+     */
+    struct SamplingOptions {
+        uint64_t dispatchInterval{1};
+        size_t sampleCapacity{};
+        std::set<std::string> operatorFilter;
+        bool pipelineStatistics{};
+    };
+
+    bool shouldProfileDispatch();
+    bool shouldProfileOperator(const std::string &pipelineKind, const std::string &operatorName) const;
+
+    std::optional<QueryRange> getQueryRange(uint32_t queueFamilyIndex, uint32_t pipelineCount);
 
-    std::shared_ptr<QueryPoolRecord> makeRecord(VkQueryPool queryPool, VkCommandBuffer commandBuffer,
+    std::shared_ptr<QueryPoolRecord> makeRecord(const QueryRange &queryRange, VkCommandBuffer commandBuffer,
                                                 VkPipeline dataGraphPipeline);
     bool collectSubmission(const std::shared_ptr<SubmitRecord> &submission, std::vector<Sample> &newSamples);
     void collectSubmissions(const Submissions &submitRecords);
@@ -114,17 +195,31 @@ class GraphProfiler {
     std::string makeJson() const;
     std::string makeJson(VkPipeline dataGraphPipeline) const;
     std::string makeJson(const std::vector<Sample> &profileSamples) const;
-    static nlohmann::ordered_json toJson(const Sample &sample);
-    static nlohmann::ordered_json toJson(const Aggregate &aggregate, const std::string &pipelineKind,
-                                         const std::string &operatorName);
+    std::string makeMetrics() const;
+    nlohmann::ordered_json makeHostPhasesJson() const;
+    nlohmann::ordered_json makeTraceJson(const std::vector<Sample> &profileSamples) const;
+    void appendHostTraceEvents(nlohmann::ordered_json &events) const;
+    nlohmann::ordered_json toJson(const Sample &sample) const;
+    nlohmann::ordered_json toJson(const Aggregate &aggregate, const std::string &pipelineKind,
+                                  const std::string &operatorName) const;
+    nlohmann::ordered_json toJson(const mlsdk::el::compute::graph_op::CostEstimate &cost, double milliseconds) const;
     bool supportsTimestampQueries(uint32_t queueFamilyIndex) const;
 
     std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> loader;
     VkPhysicalDevice physicalDevice{};
     VkDevice device{};
     float timestampPeriod{};
+    double peakGflops{};
+    double peakGigabytesPerSecond{};
+    SamplingOptions samplingOptions;
+    std::atomic<uint64_t> dispatchCounter{};
     std::vector<bool> queueFamilyTimestampSupport;
+    mlsdk::el::utils::HostTimerRegistry hostTimers;
+    QueryPoolAllocator queryPoolAllocator;
+    QueryPoolAllocator statisticsQueryPoolAllocator;
     LockedState state;
+    // Declared last so the export thread stops before the state it reads is destroyed
+    std::unique_ptr<MetricsExporter> metricsExporter;
 };
 
 } // namespace mlsdk::el::layer
@@ -100,7 +100,7 @@ void LinearMemoryPlanner::bindGraphPipelineSessionMemory(VkDeviceMemory memory,
 BestFitMemoryPlanner::BestFitMemoryPlanner(const std::shared_ptr<GraphPipeline> &_graphPipeline)
     : MemoryPlanner(_graphPipeline) {
     const Tensors tensors = createInitialTensorOrder();
-    graphLog(Severity::Debug) << "Number of tensors: " << tensors.size() << std::endl;
+    MLEL_LOG(graphLog, Severity::Debug) << "Number of tensors: " << tensors.size() << std::endl;
     const SafeToReuseMap safeToReuse = liveTensorAnalysis(tensors);
     const AlternativesMap allAlternatives = createAllAlternatives(tensors, safeToReuse);
     bestFitAllocation(tensors, safeToReuse, allAlternatives);
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "metrics_exporter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace mlsdk::el::layer {
+namespace {
+constexpr char metricName[] = "vmel_graph_operator_latency_seconds";
+constexpr std::array<std::pair<double, const char *>, 3> quantiles{{{0.50, "0.5"}, {0.95, "0.95"}, {0.99, "0.99"}}};
+
+std::string escapeLabelValue(const std::string &value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char ch : value) {
+        switch (ch) {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+std::string makeLabels(const LatencySeries &series) {
+    return "pipeline=\"" + escapeLabelValue(series.pipeline) + "\",pipeline_kind=\"" +
+           escapeLabelValue(series.pipelineKind) + "\",operator=\"" + escapeLabelValue(series.operatorName) + "\"";
+}
+} // namespace
+
+/*******************************************************************************
+ * OpenMetrics
+ *******************************************************************************/
+
+double getQuantile(std::vector<double> values, double quantile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    const auto rank = static_cast<size_t>(std::ceil(quantile * static_cast<double>(values.size())));
+    const auto index = std::clamp<size_t>(rank, 1, values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+std::string formatOpenMetrics(const std::vector<LatencySeries> &series, double timestampSeconds) {
+    std::ostringstream stream;
+    stream << std::setprecision(9);
+    stream << "# TYPE " << metricName << " summary\n";
+    stream << "# UNIT " << metricName << " seconds\n";
+    stream << "# HELP " << metricName << " GPU execution time of profiled graph operators.\n";
+
+    std::ostringstream timestamp;
+    timestamp << std::fixed << std::setprecision(3) << timestampSeconds;
+
+    for (const auto &entry : series) {
+        const auto labels = makeLabels(entry);
+        for (const auto &[quantile, name] : quantiles) {
+            stream << metricName << '{' << labels << ",quantile=\"" << name << "\"} "
+                   << getQuantile(entry.seconds, quantile) << ' ' << timestamp.str() << '\n';
+        }
+        stream << metricName << "_sum{" << labels << "} "
+               << std::accumulate(entry.seconds.begin(), entry.seconds.end(), 0.0) << ' ' << timestamp.str() << '\n';
+        stream << metricName << "_count{" << labels << "} " << entry.seconds.size() << ' ' << timestamp.str() << '\n';
+    }
+
+    stream << "# EOF\n";
+    return stream.str();
+}
+
+/*******************************************************************************
+ * MetricsExporter
+ *******************************************************************************/
+
+MetricsExporter::MetricsExporter(std::string _path, std::chrono::milliseconds _interval, Snapshot _snapshot)
+    : path{std::move(_path)}, interval{_interval}, snapshot{std::move(_snapshot)}, thread{[this] { run(); }} {}
+
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+    exportNow();
+}
+
+bool MetricsExporter::exportNow() {
+    const auto text = snapshot();
+
+    std::lock_guard lock(fileMutex);
+
+    // A pipe is read as a stream of expositions, so each snapshot is written to it directly
+    std::error_code error;
+    if (std::filesystem::is_fifo(path, error)) {
+        std::ofstream file(path, std::ios::app);
+        file << text;
+        return static_cast<bool>(file.flush());
+    }
+
+    // Otherwise the file is replaced, so readers always see exactly one complete exposition
+    const auto temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        file << text;
+        if (!file.flush()) {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+void MetricsExporter::run() {
+    std::unique_lock lock(mutex);
+    while (!condition.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        exportNow();
+        lock.lock();
+    }
+}
+
+} // namespace mlsdk::el::layer
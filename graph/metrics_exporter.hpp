@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * OpenMetrics
+ *******************************************************************************/
+
+/**
+ * Latencies of one profiled operator of one pipeline, in seconds.
+ */
+struct LatencySeries {
+    std::string pipeline;
+    std::string pipelineKind;
+    std::string operatorName;
+    std::vector<double> seconds;
+};
+
+/**
+ * Return the nearest-rank quantile of the values, or 0 if there are none.
+ */
+double getQuantile(std::vector<double> values, double quantile);
+
+/**
+ * Format the series as an OpenMetrics text exposition with one summary metric. Quantiles p50, p95 and p99 are
+ * reported per series, each sample carries the given timestamp and the exposition ends with "# EOF".
+ */
+std::string formatOpenMetrics(const std::vector<LatencySeries> &series, double timestampSeconds);
+
+/*******************************************************************************
+ * MetricsExporter
+ *******************************************************************************/
+
+/**
+ * Periodically writes a snapshot to a file from a background thread. A final snapshot is written when the exporter is
+ * destroyed.
+ *
+ * Each snapshot is written to a temporary file next to the target and renamed over it, so the file always holds
+ * exactly one complete snapshot. Snapshots are appended when the target is a named pipe.
+ */
+class MetricsExporter {
+  public:
+    using Snapshot = std::function<std::string()>;
+
+    MetricsExporter(std::string _path, std::chrono::milliseconds _interval, Snapshot _snapshot);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    /**
+     * Write a snapshot now. Return false if the file could not be written.
+     */
+    bool exportNow();
+
+  private:
+    void run();
+
+    std::string path;
+    std::chrono::milliseconds interval;
+    Snapshot snapshot;
+    std::mutex mutex;
+    std::mutex fileMutex;
+    std::condition_variable condition;
+    bool stopping{};
+    std::thread thread;
+};
+
+} // namespace mlsdk::el::layer
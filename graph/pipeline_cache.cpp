@@ -16,6 +16,7 @@
 
 #include <array>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <set>
 #include <string>
@@ -84,21 +85,33 @@ SpirvBinary PipelineCache::lookup(std::string_view shaderName, const KeyList &ke
     }
 
     const auto srcHash = crc32(glslSource);
+    const auto findUpToDate = [&]() -> const Entry * {
+        if (auto it = cache.find(key); it != cache.end() && it->second.second == srcHash) {
+            return &it->second;
+        }
+        return nullptr;
+    };
 
-    if (auto it = cache.find(key); it != cache.end()) {
-        // Cache entry exists
-        const auto &[spirv, oldHash] = it->second;
-
-        if (oldHash == srcHash) {
-            // Cache entry is up to date
-            return {spirv.data(), spirv.size()};
+    {
+        const std::scoped_lock l(mutex);
+        if (const auto *entry = findUpToDate()) {
+            return {entry->first.data(), entry->first.size()};
         }
     }
 
-    // Cache entry is missing or out of date; compile source and add to cache
-    cache[key] = {replaceCompileGlsl(glslSource, repl), srcHash};
+    // Cache entry is missing or out of date; compile source without holding the lock, pipelines created in parallel
+    // compile their shaders concurrently
+    auto spirv = replaceCompileGlsl(glslSource, repl);
+
+    const std::scoped_lock l(mutex);
+    if (const auto *entry = findUpToDate()) {
+        // Another thread compiled the same shader in the meantime
+        return {entry->first.data(), entry->first.size()};
+    }
+    auto &entry = cache[key];
+    entry = {std::move(spirv), srcHash};
 
-    return {cache[key].first.data(), cache[key].first.size()};
+    return {entry.first.data(), entry.first.size()};
 }
 
 VkPipelineCache PipelineCache::getPipelineCache() const { return pipelineCache; }
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +46,7 @@ class PipelineCache {
     using Entry = std::pair<std::vector<uint32_t>, uint32_t>;
 
     VkPipelineCache pipelineCache;
+    std::mutex mutex;
     std::map<std::string, Entry> cache;
 
     static std::string makeKey(std::string_view shaderName, const KeyList &keys);
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * Pipeline results
+ *******************************************************************************/
+
+/**
+ * Report the outcome of creating the pipelines of one vkCreate*Pipelines call, in create info order.
+ *
+ * Entry i either threw exceptions[i], failed with results[i], or succeeded, in which case publish(i) returns the handle
+ * of its pipeline. Failed entries get VK_NULL_HANDLE. The first failure of an entry for which isEarlyReturn(i) is true
+ * stops the collection, all later entries get VK_NULL_HANDLE and are not published. The first exception in order is
+ * rethrown after nulling its entry and all later ones, entries before it stay published.
+ *
+ * Errors take precedence over VK_PIPELINE_COMPILE_REQUIRED, otherwise the first failure in order is returned.
+ */
+template <typename IsEarlyReturn, typename Publish>
+VkResult collectPipelineResults(const std::vector<VkResult> &results, const std::vector<std::exception_ptr> &exceptions,
+                                IsEarlyReturn &&isEarlyReturn, Publish &&publish, VkPipeline *pipelines) {
+    const auto count = static_cast<uint32_t>(results.size());
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < count; i++) {
+        if (exceptions[i]) {
+            std::fill(pipelines + i, pipelines + count, VK_NULL_HANDLE);
+            std::rethrow_exception(exceptions[i]);
+        }
+
+        if (results[i] != VK_SUCCESS) {
+            pipelines[i] = VK_NULL_HANDLE;
+            if (result == VK_SUCCESS || (result > 0 && results[i] < 0)) {
+                result = results[i];
+            }
+            if (isEarlyReturn(i)) {
+                std::fill(pipelines + i + 1, pipelines + count, VK_NULL_HANDLE);
+                break;
+            }
+            continue;
+        }
+
+        pipelines[i] = publish(i);
+    }
+
+    return result;
+}
+
+} // namespace mlsdk::el::layer
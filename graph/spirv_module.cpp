@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "spirv_module.hpp"
+
+#include "source/opt/build_module.h"
+#include "source/opt/fold_spec_constant_op_and_composite_pass.h"
+#include "source/opt/freeze_spec_constant_value_pass.h"
+#include "source/opt/set_spec_constant_default_value_pass.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+namespace {
+
+std::unordered_map<uint32_t, std::vector<uint32_t>>
+makeSpecConstantDefaultValues(const VkSpecializationInfo &specializationInfo) {
+    std::unordered_map<uint32_t, std::vector<uint32_t>> values;
+    values.reserve(specializationInfo.mapEntryCount);
+
+    for (uint32_t i = 0; i < specializationInfo.mapEntryCount; i++) {
+        const auto &entry = specializationInfo.pMapEntries[i];
+
+        if (entry.size == 0) {
+            values.emplace(entry.constantID, std::vector<uint32_t>{});
+            continue;
+        }
+
+        const auto wordCount = static_cast<size_t>((entry.size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        std::vector<uint32_t> words(wordCount, 0u);
+        std::memcpy(words.data(), static_cast<const char *>(specializationInfo.pData) + entry.offset, entry.size);
+
+        values.emplace(entry.constantID, std::move(words));
+    }
+
+    return values;
+}
+
+} // namespace
+
+std::unique_ptr<spvtools::opt::IRContext> buildGraphModule(const uint32_t *spirvCode, size_t spirvSize,
+                                                           const spvtools::MessageConsumer &consumer) {
+    auto ir = spvtools::BuildModule(SPV_ENV_UNIVERSAL_1_6, consumer, spirvCode, spirvSize);
+    if (ir == nullptr || ir->module() == nullptr) {
+        return nullptr;
+    }
+    return ir;
+}
+
+void addSpecConstantDefaultPasses(spvtools::opt::PassManager &passes, const VkSpecializationInfo *specializationInfo) {
+    if (specializationInfo == nullptr) {
+        return;
+    }
+
+    const auto specConstantDefaultValues = makeSpecConstantDefaultValues(*specializationInfo);
+    if (specConstantDefaultValues.empty()) {
+        return;
+    }
+
+    passes.AddPass<spvtools::opt::SetSpecConstantDefaultValuePass>(specConstantDefaultValues);
+    passes.AddPass<spvtools::opt::FreezeSpecConstantValuePass>();
+    passes.AddPass<spvtools::opt::FoldSpecConstantOpAndCompositePass>();
+}
+
+} // namespace mlsdk::el::layer
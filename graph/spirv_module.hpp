@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "source/opt/ir_context.h"
+#include "source/opt/pass_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * Graph module ingestion
+ *******************************************************************************/
+
+/**
+ * Build the IR of a graph module. The IR is built once per pipeline, inspected, and lowered by running passes on it
+ * directly, without serializing the module again. Return nullptr if the module cannot be parsed.
+ */
+std::unique_ptr<spvtools::opt::IRContext> buildGraphModule(const uint32_t *spirvCode, size_t spirvSize,
+                                                           const spvtools::MessageConsumer &consumer);
+
+/**
+ * Add the passes setting the default values of the specialization constants given by the application, then freezing
+ * and folding them.
+ */
+void addSpecConstantDefaultPasses(spvtools::opt::PassManager &passes, const VkSpecializationInfo *specializationInfo);
+
+} // namespace mlsdk::el::layer
@@ -77,8 +77,8 @@ void GraphPassBase::handleGraphConstants() {
             if (tensorMap.find(resultId) == tensorMap.end()) {
                 auto &tensors = tensorMap[resultId];
                 tensors[0] = graphPipeline.getConstTensor(constantId);
-                graphLog(Severity::Info) << '%' << resultId << ": constId=" << constantId << ", tensor=" << tensors[0]
-                                         << ", " << *tensors[0] << std::endl;
+                MLEL_LOG(graphLog, Severity::Info) << '%' << resultId << ": constId=" << constantId << ", tensor="
+                                                   << tensors[0] << ", " << *tensors[0] << std::endl;
             }
             break;
         }
@@ -93,7 +93,7 @@ void GraphPassBase::handleGraphs() {
 
     // Iterate over graph entry points
     for (const auto &graphEntry : module.graph_entry_points()) {
-        graphLog(Severity::Info) << graphEntry << std::endl;
+        MLEL_LOG(graphLog, Severity::Info) << graphEntry << std::endl;
 
         // OpGraphEntryPointARM <graph id> <name> [input tensors] [output tensors]
         // auto op = graphEntry.begin();
@@ -132,7 +132,7 @@ void GraphPassBase::handleInputsAndOutputs(const Instruction &opGraphEntryPoint)
 
         // Seed OpGraphInputARM in the local cache before visiting graph ops.
         // Unlike OpVariable and OpGraphConstantARM, graph inputs do not have a GraphPipeline lookup path.
-        graphLog(Severity::Info) << '%' << resultId << ": tensor=" << inputTensor << std::endl;
+        MLEL_LOG(graphLog, Severity::Info) << '%' << resultId << ": tensor=" << inputTensor << std::endl;
         graphPipeline.makeInput(inputTensor);
         tensorMap[resultId][0] = std::move(inputTensor);
     }
@@ -167,13 +167,14 @@ void GraphPassBase::handleInputsAndOutputs(const Instruction &opGraphEntryPoint)
             const auto &compositeId = instruction->GetOperand(2);
             const auto compositeIndex = instruction->GetOperand(3).AsLiteralUint64();
 
-            graphLog(Severity::Info) << '%' << compositeId.AsId() << '[' << compositeIndex
-                                     << "]: tensor=" << outputTensor << std::endl;
+            MLEL_LOG(graphLog, Severity::Info) << '%' << compositeId.AsId() << '[' << compositeIndex << "]: tensor="
+                                               << outputTensor << std::endl;
             tensorMap[compositeId.AsId()][compositeIndex] = std::move(outputTensor);
             break;
         }
         default: {
-            graphLog(Severity::Info) << '%' << instruction->result_id() << ": tensor=" << outputTensor << std::endl;
+            MLEL_LOG(graphLog, Severity::Info) << '%' << instruction->result_id() << ": tensor=" << outputTensor
+                                               << std::endl;
             tensorMap[instruction->result_id()][0] = std::move(outputTensor);
         }
         }
@@ -284,8 +285,8 @@ std::shared_ptr<TensorDescriptor> GraphPassBase::getTensor(const Instruction &in
         auto tensor = makeTensor(getTensorType(instruction.GetOperand(1)));
         tensorMap[instruction.result_id()][arrayIndex] = tensor;
 
-        graphLog(Severity::Info) << '%' << instruction.result_id() << '[' << arrayIndex << "]: tensor=" << tensor
-                                 << ", " << *tensor << std::endl;
+        MLEL_LOG(graphLog, Severity::Info) << '%' << instruction.result_id() << '[' << arrayIndex << "]: tensor="
+                                           << tensor << ", " << *tensor << std::endl;
 
         return tensor;
     }
@@ -302,8 +303,9 @@ std::shared_ptr<TensorDescriptor> GraphPassBase::getTensor(const Instruction &in
         // Descriptor-backed variables are owned by GraphPipeline's set/binding cache.
         // Store the descriptor locally as well so subsequent uses resolve through one code path.
         tensorMap[instruction.result_id()][arrayIndex] = tensor;
-        graphLog(Severity::Info) << '%' << instruction.result_id() << '[' << arrayIndex << "]: set=" << set
-                                 << ", binding=" << binding << ", tensor=" << tensor << ", " << *tensor << std::endl;
+        MLEL_LOG(graphLog, Severity::Info) << '%' << instruction.result_id() << '[' << arrayIndex << "]: set=" << set
+                                           << ", binding=" << binding << ", tensor=" << tensor << ", " << *tensor
+                                           << std::endl;
         return tensor;
     }
     default:
@@ -492,6 +494,23 @@ size_t GraphPassBase::getElementCount(const uint32_t id) const {
     return mlsdk::el::utils::getElementCount(dimensions);
 }
 
+const analysis::Type *GraphPassBase::getFirstLeafType(const spvtools::opt::analysis::CompositeConstant *composite,
+                                                      size_t &leafCount) {
+    // The leaf count is exact for nested arrays and tensors, and only a reservation hint otherwise
+    leafCount = 1;
+    const analysis::Constant *constant = composite;
+    while (const auto *innerComposite = constant->AsCompositeConstant()) {
+        const auto &components = innerComposite->GetComponents();
+        if (components.empty()) {
+            return nullptr;
+        }
+        leafCount *= components.size();
+        constant = components.front();
+    }
+
+    return constant->type();
+}
+
 bool GraphPassBase::isCompositeReplicateConstantOpcode(const spv::Op opcode) {
     return opcode == spv::Op::OpConstantCompositeReplicateEXT || opcode == spv::Op::OpSpecConstantCompositeReplicateEXT;
 }
@@ -14,9 +14,11 @@
 #include "mlel/float.hpp"
 #include "source/opt/pass.h"
 
+#include <cstring>
 #include <numeric>
 #include <spirv-tools/optimizer.hpp>
 #include <type_traits>
+#include <vector>
 
 /*******************************************************************************
  * Base Graph Pass
@@ -98,14 +100,8 @@ class GraphPassBase : public Pass {
     template <typename T>
     void getFlattenedCompositeConstant(const spvtools::opt::analysis::CompositeConstant *composite,
                                        std::vector<T> &kernel) const {
-        const auto &components = composite->GetComponents();
-        kernel.reserve(kernel.size() + components.size());
-        for (const auto *component : components) {
-            if (const auto *innerComposite = component->AsCompositeConstant()) {
-                getFlattenedCompositeConstant(innerComposite, kernel);
-            } else {
-                kernel.push_back(getConstScalar<T>(component));
-            }
+        if (!getFlattenedHomogeneousConstant(composite, kernel)) {
+            flattenCompositeConstant(composite, kernel);
         }
     }
 
@@ -230,6 +226,149 @@ class GraphPassBase : public Pass {
 
     size_t getElementCount(uint32_t id) const;
 
+    template <typename T>
+    void flattenCompositeConstant(const spvtools::opt::analysis::CompositeConstant *composite,
+                                  std::vector<T> &kernel) const {
+        const auto &components = composite->GetComponents();
+        kernel.reserve(kernel.size() + components.size());
+        for (const auto *component : components) {
+            if (const auto *innerComposite = component->AsCompositeConstant()) {
+                flattenCompositeConstant(innerComposite, kernel);
+            } else {
+                kernel.push_back(getConstScalar<T>(component));
+            }
+        }
+    }
+
+    // Bulk path for composites whose leaves are all scalars of one type, as used for the weights of a model. The raw
+    // bits of the leaves are gathered into one contiguous buffer, then converted in a single loop with the type
+    // dispatch hoisted out of it. Returns false, leaving kernel unchanged, if the composite is not homogeneous.
+    template <typename T>
+    bool getFlattenedHomogeneousConstant(const spvtools::opt::analysis::CompositeConstant *composite,
+                                         std::vector<T> &kernel) const {
+        size_t leafCount = 0;
+        const auto *leafType = getFirstLeafType(composite, leafCount);
+        if (leafType == nullptr) {
+            return false;
+        }
+
+        if (const auto *intType = leafType->AsInteger()) {
+            switch (intType->width()) {
+            case 8:
+                return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel,
+                                               [](uint32_t bits) { return T(int8_t(bits)); });
+            case 16:
+                return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel,
+                                               [](uint32_t bits) { return T(int16_t(bits)); });
+            case 32:
+                return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel,
+                                               [](uint32_t bits) { return T(int32_t(bits)); });
+            case 64:
+                return decodeScalars<uint64_t>(composite, leafType, leafCount, kernel,
+                                               [](uint64_t bits) { return T(int64_t(bits)); });
+            default:
+                return false;
+            }
+        }
+
+        if (const auto *floatType = leafType->AsFloat()) {
+            switch (floatType->width()) {
+            case 8:
+                if (floatType->encoding() == spv::FPEncoding::Float8E5M2EXT) {
+                    return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel, [](uint32_t bits) {
+                        return fromFloatBits<T, float8_e5m2>(bits);
+                    });
+                }
+                if (floatType->encoding() == spv::FPEncoding::Float8E4M3EXT) {
+                    return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel, [](uint32_t bits) {
+                        return fromFloatBits<T, float8_e4m3>(bits);
+                    });
+                }
+                return false;
+            case 16:
+                return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel,
+                                               [](uint32_t bits) { return fromFloatBits<T, float16>(bits); });
+            case 32:
+                return decodeScalars<uint32_t>(composite, leafType, leafCount, kernel, [](uint32_t bits) {
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return T(value);
+                });
+            case 64:
+                return decodeScalars<uint64_t>(composite, leafType, leafCount, kernel, [](uint64_t bits) {
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return T(value);
+                });
+            default:
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    template <typename Bits, typename T, typename Convert>
+    static bool decodeScalars(const spvtools::opt::analysis::CompositeConstant *composite,
+                              const analysis::Type *leafType, size_t leafCount, std::vector<T> &kernel,
+                              Convert convert) {
+        std::vector<Bits> bits;
+        bits.reserve(leafCount);
+        if (!gatherScalarBits(composite, leafType, bits)) {
+            return false;
+        }
+
+        const auto offset = kernel.size();
+        kernel.resize(offset + bits.size());
+        for (size_t i = 0; i < bits.size(); i++) {
+            kernel[offset + i] = convert(bits[i]);
+        }
+
+        return true;
+    }
+
+    template <typename Bits>
+    static bool gatherScalarBits(const spvtools::opt::analysis::CompositeConstant *composite,
+                                 const analysis::Type *leafType, std::vector<Bits> &bits) {
+        for (const auto *component : composite->GetComponents()) {
+            if (const auto *innerComposite = component->AsCompositeConstant()) {
+                if (!gatherScalarBits(innerComposite, leafType, bits)) {
+                    return false;
+                }
+                continue;
+            }
+
+            const auto *scalar = component->AsScalarConstant();
+            if (scalar == nullptr || scalar->type() != leafType) {
+                return false;
+            }
+
+            const auto &words = scalar->words();
+            if constexpr (sizeof(Bits) == sizeof(uint64_t)) {
+                bits.push_back(Bits(words[0]) | Bits(words[1]) << 32);
+            } else {
+                bits.push_back(words[0]);
+            }
+        }
+
+        return true;
+    }
+
+    // Same conversion as getConstScalar, except that values already of type T are copied without going through double
+    template <typename T, typename FloatType> static T fromFloatBits(uint32_t bits) {
+        const auto value = typename FloatType::dtype(bits);
+        if constexpr (std::is_same_v<T, FloatType>) {
+            T result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        } else {
+            return T(FloatType::toDouble(value));
+        }
+    }
+
+    static const analysis::Type *getFirstLeafType(const spvtools::opt::analysis::CompositeConstant *composite,
+                                                  size_t &leafCount);
+
     static bool isCompositeReplicateConstantOpcode(spv::Op opcode);
 
     template <typename T, spv::FPEncoding fpEncoding>
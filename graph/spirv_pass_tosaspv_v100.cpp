@@ -366,8 +366,8 @@ void GraphPassTosaSpv100::handleArgmax(const Instruction *opExtInst, const std::
     const auto &nanMode = getConstScalar<uint32_t>(opExtInst->GetInOperand(3));
     const auto &inputId = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
-                             << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
+                                       << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeArgmax(getTensor(inputId), getTensor(*opExtInst), axis, nanMode, debugName);
 }
@@ -381,8 +381,9 @@ void GraphPassTosaSpv100::handleArithmeticRightShift(const Instruction *opExtIns
     const auto &inputId1 = opExtInst->GetInOperand(3);
     const auto &inputId2 = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", round=" << round
-                             << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", round=" << round
+                                       << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId()
+                                       << std::endl;
 
     graphPipeline.makeArithmeticRightShift(getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), round,
                                            debugName);
@@ -402,10 +403,10 @@ void GraphPassTosaSpv100::handleAvgPool2D(const Instruction *opExtInst, const st
     const auto &inputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(7));
     const auto &outputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(8));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", kernel=" << kernel
-                             << ", stride=" << stride << ", pad=" << pad << ", accType=" << accType
-                             << ", inputZeroPoint=" << inputZeroPoint << ", outputZeroPoint=" << outputZeroPoint
-                             << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", kernel=" << kernel
+                                       << ", stride=" << stride << ", pad=" << pad << ", accType=" << accType
+                                       << ", inputZeroPoint=" << inputZeroPoint << ", outputZeroPoint="
+                                       << outputZeroPoint << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeAvgPool2D(getTensor(inputId), getTensor(*opExtInst), kernel, stride, pad, accType,
                                 inputZeroPoint[0], outputZeroPoint[0], debugName);
@@ -418,8 +419,8 @@ void GraphPassTosaSpv100::handleCast(const Instruction *opExtInst, const std::st
     const auto &resultId = opExtInst->result_id();
     const auto &inputId = opExtInst->GetInOperand(2);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%" << inputId.AsId()
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%"
+                                       << inputId.AsId() << std::endl;
 
     graphPipeline.makeCast(getTensor(inputId), getTensor(*opExtInst), debugName);
 }
@@ -450,9 +451,9 @@ void GraphPassTosaSpv100::handleClamp(const Instruction *opExtInst, const std::s
     const auto nanMode = getConstScalar<uint32_t>(opExtInst->GetInOperand(4));
     const auto &inputId = opExtInst->GetInOperand(5);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", minVal=" << minVal
-                             << ", maxVal=" << maxVal << ", nanMode=" << nanMode << ", input=%" << inputId.AsId()
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", minVal=" << minVal
+                                       << ", maxVal=" << maxVal << ", nanMode=" << nanMode << ", input=%"
+                                       << inputId.AsId() << std::endl;
 
     graphPipeline.makeClamp(getTensor(inputId), getTensor(*opExtInst), minVal, maxVal, nanMode, debugName);
 }
@@ -468,11 +469,13 @@ void GraphPassTosaSpv100::handleConcat(const Instruction *opExtInst, const std::
     std::string inputsStr;
     for (uint32_t i = 3; i < opExtInst->NumInOperands(); i++) {
         inputs.push_back(getTensor(opExtInst->GetInOperand(i)));
-        inputsStr += ", input" + std::to_string(i - 3) + "=%" + std::to_string(opExtInst->GetInOperand(i).AsId());
+        if (graphLog.enabled(Severity::Info)) {
+            inputsStr += ", input" + std::to_string(i - 3) + "=%" + std::to_string(opExtInst->GetInOperand(i).AsId());
+        }
     }
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis << inputsStr
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
+                                       << inputsStr << std::endl;
 
     graphPipeline.makeConcat(inputs, getTensor(*opExtInst), axis, debugName);
 }
@@ -494,11 +497,11 @@ void GraphPassTosaSpv100::handleConv2D(const Instruction *opExtInst, const std::
     const auto &inputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(10));
     const auto &weightZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(11));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
-                             << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
-                             << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
-                             << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint=" << inputZeroPoint
-                             << ", weightZeroPoint=" << weightZeroPoint << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
+                                       << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
+                                       << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
+                                       << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint="
+                                       << inputZeroPoint << ", weightZeroPoint=" << weightZeroPoint << std::endl;
 
     graphPipeline.makeConv2D(getTensor(inputId), getTensor(*opExtInst), getTensor(weightId), getTensor(biasId), pad,
                              stride, dilation, inputZeroPoint[0], weightZeroPoint[0], accType, debugName);
@@ -521,11 +524,11 @@ void GraphPassTosaSpv100::handleConv3D(const Instruction *opExtInst, const std::
     const auto &inputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(10));
     const auto &weightZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(11));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
-                             << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
-                             << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
-                             << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint=" << inputZeroPoint
-                             << ", weightZeroPoint=" << weightZeroPoint << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
+                                       << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
+                                       << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
+                                       << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint="
+                                       << inputZeroPoint << ", weightZeroPoint=" << weightZeroPoint << std::endl;
 
     graphPipeline.makeConv3D(getTensor(inputId), getTensor(*opExtInst), getTensor(weightId), getTensor(biasId), pad,
                              stride, dilation, inputZeroPoint[0], weightZeroPoint[0], accType, debugName);
@@ -548,11 +551,11 @@ void GraphPassTosaSpv100::handleDepthwiseConv2D(const Instruction *opExtInst, co
     const auto &inputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(10));
     const auto &weightZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(11));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
-                             << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
-                             << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
-                             << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint=" << inputZeroPoint
-                             << ", weightZeroPoint=" << weightZeroPoint << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", pad=" << pad
+                                       << ", stride=" << stride << ", dilation=" << dilation << ", accType=" << accType
+                                       << ", localBound=" << localBound << ", input=%" << inputId.AsId() << ", weight=%"
+                                       << weightId.AsId() << ", bias=%" << biasId.AsId() << ", inputZeroPoint="
+                                       << inputZeroPoint << ", weightZeroPoint=" << weightZeroPoint << std::endl;
 
     graphPipeline.makeDepthwiseConv2D(getTensor(inputId), getTensor(*opExtInst), getTensor(weightId), getTensor(biasId),
                                       pad, stride, dilation, inputZeroPoint[0], weightZeroPoint[0], accType, debugName);
@@ -570,8 +573,8 @@ void GraphPassTosaSpv100::handleElementwiseBinary(
     const auto &inputId1 = opExtInst->GetInOperand(2);
     const auto &inputId2 = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", input1=%" << inputId1.AsId()
-                             << ", input2=%" << inputId2.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", input1=%"
+                                       << inputId1.AsId() << ", input2=%" << inputId2.AsId() << std::endl;
 
     std::invoke(function, &graphPipeline, getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), debugName);
 }
@@ -586,8 +589,8 @@ void GraphPassTosaSpv100::handleElementwiseUnary(
     const auto &resultId = opExtInst->result_id();
     const auto &inputId1 = opExtInst->GetInOperand(2);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%" << inputId1.AsId()
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%"
+                                       << inputId1.AsId() << std::endl;
 
     std::invoke(function, &graphPipeline, getTensor(inputId1), getTensor(*opExtInst), debugName);
 }
@@ -602,9 +605,9 @@ void GraphPassTosaSpv100::handleFft2D(const Instruction *opExtInst, const std::s
     const auto &inputRealId = opExtInst->GetInOperand(4);
     const auto &inputImagId = opExtInst->GetInOperand(5);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", inverse=" << inverse
-                             << ", localBound=" << localBound << ", inputReal=%" << inputRealId.AsId()
-                             << ", inputImag=%" << inputImagId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", inverse="
+                                       << inverse << ", localBound=" << localBound << ", inputReal=%"
+                                       << inputRealId.AsId() << ", inputImag=%" << inputImagId.AsId() << std::endl;
 
     graphPipeline.makeFft2D(getTensor(inputRealId), getTensor(inputImagId), getTensor(*opExtInst, 0),
                             getTensor(*opExtInst, 1), inverse, debugName);
@@ -618,8 +621,8 @@ void GraphPassTosaSpv100::handleGather(const Instruction *opExtInst, const std::
     const auto &valuesId = opExtInst->GetInOperand(2);
     const auto &indicesId = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", values=%" << valuesId.AsId()
-                             << ", indices=%" << indicesId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", values=%"
+                                       << valuesId.AsId() << ", indices=%" << indicesId.AsId() << std::endl;
 
     graphPipeline.makeGather(getTensor(valuesId), getTensor(indicesId), getTensor(*opExtInst), debugName);
 }
@@ -634,9 +637,9 @@ void GraphPassTosaSpv100::handleMatmul(const Instruction *opExtInst, const std::
     const auto &input1ZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(4));
     const auto &input2ZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(5));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%" << inputId1.AsId()
-                             << ", input2=%" << inputId2.AsId() << ", input1ZeroPoint=" << input1ZeroPoint
-                             << ", input2ZeroPoint=" << input2ZeroPoint << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%"
+                                       << inputId1.AsId() << ", input2=%" << inputId2.AsId() << ", input1ZeroPoint="
+                                       << input1ZeroPoint << ", input2ZeroPoint=" << input2ZeroPoint << std::endl;
 
     graphPipeline.makeMatmul(getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), input1ZeroPoint[0],
                              input2ZeroPoint[0], debugName);
@@ -651,8 +654,9 @@ void GraphPassTosaSpv100::handleMaximum(const Instruction *opExtInst, const std:
     const auto &inputId1 = opExtInst->GetInOperand(3);
     const auto &inputId2 = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", nanMode=" << nanMode
-                             << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", nanMode="
+                                       << nanMode << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId()
+                                       << std::endl;
 
     graphPipeline.makeMaximum(getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), nanMode, debugName);
 }
@@ -668,9 +672,9 @@ void GraphPassTosaSpv100::handleMaxPool2D(const Instruction *opExtInst, const st
     const auto &nanMode = getConstScalar<uint32_t>(opExtInst->GetInOperand(5));
     const auto &inputId = opExtInst->GetInOperand(6);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", kernel=" << kernel
-                             << ", stride=" << stride << ", pad=" << pad << ", nanMode=" << nanMode << ", input=%"
-                             << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", kernel=" << kernel
+                                       << ", stride=" << stride << ", pad=" << pad << ", nanMode=" << nanMode
+                                       << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeMaxPool2D(getTensor(inputId), getTensor(*opExtInst), kernel, stride, pad, nanMode, debugName);
 }
@@ -684,8 +688,9 @@ void GraphPassTosaSpv100::handleMinimum(const Instruction *opExtInst, const std:
     const auto &inputId1 = opExtInst->GetInOperand(3);
     const auto &inputId2 = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", nanMode=" << nanMode
-                             << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", nanMode="
+                                       << nanMode << ", input1=%" << inputId1.AsId() << ", input2=%" << inputId2.AsId()
+                                       << std::endl;
 
     graphPipeline.makeMinimum(getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), nanMode, debugName);
 }
@@ -699,8 +704,9 @@ void GraphPassTosaSpv100::handleMul(const Instruction *opExtInst, const std::str
     const auto &inputId2 = opExtInst->GetInOperand(3);
     const auto &shift = getConstVector<uint8_t>(opExtInst->GetInOperand(4));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%" << inputId1.AsId()
-                             << ", input2=%" << inputId2.AsId() << ", shift=" << shift << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%"
+                                       << inputId1.AsId() << ", input2=%" << inputId2.AsId() << ", shift=" << shift
+                                       << std::endl;
 
     graphPipeline.makeMul(getTensor(inputId1), getTensor(inputId2), getTensor(*opExtInst), shift[0], debugName);
 }
@@ -714,9 +720,9 @@ void GraphPassTosaSpv100::handleNegate(const Instruction *opExtInst, const std::
     const auto &inputZeroPoint = getConstVector<int32_t>(opExtInst->GetInOperand(3));
     const auto &outputZeroPoint = getConstVector<int32_t>(opExtInst->GetInOperand(4));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%" << inputId.AsId()
-                             << ", inputZeroPoint=" << inputZeroPoint << ", outputZeroPoint=" << outputZeroPoint
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%"
+                                       << inputId.AsId() << ", inputZeroPoint=" << inputZeroPoint
+                                       << ", outputZeroPoint=" << outputZeroPoint << std::endl;
 
     graphPipeline.makeNegate(getTensor(inputId), getTensor(*opExtInst), inputZeroPoint[0], outputZeroPoint[0],
                              debugName);
@@ -798,9 +804,9 @@ void GraphPassTosaSpv100::handlePad(const Instruction *opExtInst, const std::str
         padConstInt = int32_t(padConst);
     }
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << ", padding=" << padding
-                             << ", padConst=" << std::fixed << std::setprecision(0) << padConst << ", input=%"
-                             << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << ", padding=" << padding
+                                       << ", padConst=" << std::fixed << std::setprecision(0) << padConst << ", input=%"
+                                       << inputId.AsId() << std::endl;
 
     graphPipeline.makePad(getTensor(inputId), output, padding, padConst, padConstInt, debugName);
 }
@@ -822,12 +828,12 @@ void GraphPassTosaSpv100::handleRescale(const Instruction *opExtInst, const std:
     const auto &inputZeroPoint = getConstVector<int32_t>(opExtInst->GetInOperand(10));
     const auto &outputZeroPoint = getConstVector<int32_t>(opExtInst->GetInOperand(11));
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << ", scale32=" << scale32
-                             << ", roundingRound=" << roundingMode << ", perChannel=" << perChannel
-                             << ", inputUnsigned=" << inputUnsigned << ", outputUnsigned=" << outputUnsigned
-                             << ", input=%" << inputId.AsId() << ", multiplier=" << multiplier << ", shift=" << shift
-                             << ", inputZeroPoint=" << inputZeroPoint << ", outputZeroPoint=" << outputZeroPoint
-                             << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << ", scale32=" << scale32
+                                       << ", roundingRound=" << roundingMode << ", perChannel=" << perChannel
+                                       << ", inputUnsigned=" << inputUnsigned << ", outputUnsigned=" << outputUnsigned
+                                       << ", input=%" << inputId.AsId() << ", multiplier=" << multiplier << ", shift="
+                                       << shift << ", inputZeroPoint=" << inputZeroPoint << ", outputZeroPoint="
+                                       << outputZeroPoint << std::endl;
 
     const bool doubleRound = (roundingMode == RoundingMode::DoubleRound);
 
@@ -848,8 +854,8 @@ void GraphPassTosaSpv100::handleReduce(
     const auto &axis = getConstScalar<uint32_t>(opExtInst->GetInOperand(2));
     const auto &inputId = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", axis=" << axis
-                             << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ", " << debugName << ", axis=" << axis
+                                       << ", input=%" << inputId.AsId() << std::endl;
 
     std::invoke(function, &graphPipeline, getTensor(inputId), getTensor(*opExtInst), axis, debugName);
 }
@@ -863,8 +869,8 @@ void GraphPassTosaSpv100::handleReduceMax(const Instruction *opExtInst, const st
     const auto &nanMode = getConstScalar<uint32_t>(opExtInst->GetInOperand(3));
     const auto &inputId = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
-                             << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
+                                       << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeReduceMax(getTensor(inputId), getTensor(*opExtInst), axis, nanMode, debugName);
 }
@@ -878,8 +884,8 @@ void GraphPassTosaSpv100::handleReduceMin(const Instruction *opExtInst, const st
     const auto &nanMode = getConstScalar<uint32_t>(opExtInst->GetInOperand(3));
     const auto &inputId = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
-                             << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
+                                       << ", nanMode=" << nanMode << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeReduceMin(getTensor(inputId), getTensor(*opExtInst), axis, nanMode, debugName);
 }
@@ -892,8 +898,8 @@ void GraphPassTosaSpv100::handleReshape(const Instruction *opExtInst, const std:
     const auto &inputId = opExtInst->GetInOperand(2);
     const auto &shape = getConstVector<uint32_t>(opExtInst->GetInOperand(3));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%" << inputId.AsId()
-                             << ", shape=" << shape << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%"
+                                       << inputId.AsId() << ", shape=" << shape << std::endl;
 
     graphPipeline.makeReshape(getTensor(inputId), getTensor(*opExtInst), debugName);
 }
@@ -909,9 +915,9 @@ void GraphPassTosaSpv100::handleResize(const Instruction *opExtInst, const std::
     const auto &offset = getConstVector<int32_t>(opExtInst->GetInOperand(5));
     const auto &border = getConstVector<int32_t>(opExtInst->GetInOperand(6));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", scale=" << scale
-                             << ", offset=" << offset << ", border=" << border << ", mode=" << mode << ", input=%"
-                             << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", scale=" << scale
+                                       << ", offset=" << offset << ", border=" << border << ", mode=" << mode
+                                       << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeResize(getTensor(inputId), getTensor(*opExtInst), scale, offset, border, mode, debugName);
 }
@@ -924,8 +930,8 @@ void GraphPassTosaSpv100::handleReverse(const Instruction *opExtInst, const std:
     const auto &axis = getConstScalar<uint32_t>(opExtInst->GetInOperand(2));
     const auto &inputId = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis << ", input=%"
-                             << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", axis=" << axis
+                                       << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeReverse(getTensor(inputId), getTensor(*opExtInst), axis, debugName);
 }
@@ -938,8 +944,8 @@ void GraphPassTosaSpv100::handleRfft2D(const Instruction *opExtInst, const std::
     const auto &localBound = getBoolConstant(opExtInst->GetInOperand(2));
     const auto &inputId = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", localBound=" << localBound
-                             << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", localBound="
+                                       << localBound << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeRfft2D(getTensor(inputId), getTensor(*opExtInst, 0), getTensor(*opExtInst, 1), debugName);
 }
@@ -953,8 +959,9 @@ void GraphPassTosaSpv100::handleScatter(const Instruction *opExtInst, const std:
     const auto &indicesId = opExtInst->GetInOperand(3);
     const auto &inputId = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", valuesIn=%" << inputId.AsId()
-                             << ", indices=%" << indicesId.AsId() << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", valuesIn=%"
+                                       << inputId.AsId() << ", indices=%" << indicesId.AsId() << ", input=%"
+                                       << inputId.AsId() << std::endl;
 
     graphPipeline.makeScatter(getTensor(inputId), getTensor(valuesInId), getTensor(indicesId), getTensor(*opExtInst),
                               debugName);
@@ -969,8 +976,9 @@ void GraphPassTosaSpv100::handleSelect(const Instruction *opExtInst, const std::
     const auto &inputId2 = opExtInst->GetInOperand(3);
     const auto &inputId3 = opExtInst->GetInOperand(4);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%" << inputId1.AsId()
-                             << ", input2=%" << inputId2.AsId() << ", input3=%" << inputId3.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input1=%"
+                                       << inputId1.AsId() << ", input2=%" << inputId2.AsId() << ", input3=%"
+                                       << inputId3.AsId() << std::endl;
 
     graphPipeline.makeSelect(getTensor(inputId1), getTensor(inputId2), getTensor(inputId3), getTensor(*opExtInst),
                              debugName);
@@ -985,8 +993,8 @@ void GraphPassTosaSpv100::handleSlice(const Instruction *opExtInst, const std::s
     const auto &start = getConstVector<uint32_t>(opExtInst->GetInOperand(3));
     const auto &size = getConstVector<uint32_t>(opExtInst->GetInOperand(4));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << " , input=%" << inputId.AsId()
-                             << ", start=" << start << ", size=" << size << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << " , input=%"
+                                       << inputId.AsId() << ", start=" << start << ", size=" << size << std::endl;
 
     graphPipeline.makeSlice(getTensor(inputId), getTensor(*opExtInst), start, debugName);
 }
@@ -999,8 +1007,8 @@ void GraphPassTosaSpv100::handleTable(const Instruction *opExtInst, const std::s
     const auto &inputId = opExtInst->GetInOperand(2);
     const auto &table = getOrMakeCompositeTensor(opExtInst->GetInOperand(3).AsId());
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%" << inputId.AsId()
-                             << ", table=" << table << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%"
+                                       << inputId.AsId() << ", table=" << table << std::endl;
 
     graphPipeline.makeTable(getTensor(inputId), getTensor(*opExtInst), table, debugName);
 }
@@ -1013,8 +1021,8 @@ void GraphPassTosaSpv100::handleTile(const Instruction *opExtInst, const std::st
     const auto &inputId = opExtInst->GetInOperand(2);
     const auto &multiples = getConstVector<uint32_t>(opExtInst->GetInOperand(3));
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%" << inputId.AsId()
-                             << ", multiples=" << multiples << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", input=%"
+                                       << inputId.AsId() << ", multiples=" << multiples << std::endl;
 
     graphPipeline.makeTile(getTensor(inputId), getTensor(*opExtInst), debugName);
 }
@@ -1027,8 +1035,8 @@ void GraphPassTosaSpv100::handleTranspose(const Instruction *opExtInst, const st
     const auto &perms = getConstVector<uint32_t>(opExtInst->GetInOperand(2));
     const auto &inputId = opExtInst->GetInOperand(3);
 
-    graphLog(Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", perms=" << perms
-                             << ", input=%" << inputId.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=%" << resultId << ',' << debugName << ", perms=" << perms
+                                       << ", input=%" << inputId.AsId() << std::endl;
 
     graphPipeline.makeTranspose(getTensor(inputId), getTensor(*opExtInst), perms, debugName);
 }
@@ -1049,11 +1057,11 @@ void GraphPassTosaSpv100::handleTransposeConv2D(const Instruction *opExtInst, co
     const auto &inputZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(9));
     const auto &weightZeroPoint = getConstVector<int8_t>(opExtInst->GetInOperand(10));
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << " , outPad=" << outPad
-                             << ", stride=" << stride << ", accType=" << accType << ", localBound=" << localBound
-                             << ", input=%" << inputId.AsId() << ", weight=%" << weightId.AsId() << ", bias=%"
-                             << biasId.AsId() << ", inputZeroPoint=" << inputZeroPoint
-                             << ", weightZeroPoint=" << weightZeroPoint << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ',' << debugName << " , outPad=" << outPad
+                                       << ", stride=" << stride << ", accType=" << accType << ", localBound="
+                                       << localBound << ", input=%" << inputId.AsId() << ", weight=%" << weightId.AsId()
+                                       << ", bias=%" << biasId.AsId() << ", inputZeroPoint=" << inputZeroPoint
+                                       << ", weightZeroPoint=" << weightZeroPoint << std::endl;
 
     graphPipeline.makeTransposeConv2D(getTensor(inputId), getTensor(*opExtInst), getTensor(weightId), getTensor(biasId),
                                       outPad, stride, inputZeroPoint[0], weightZeroPoint[0], accType, debugName);
@@ -1075,11 +1083,12 @@ void GraphPassTosaSpv100::handleMinSad(const Instruction *opExtInst, const std::
     const auto &input0Id = opExtInst->GetInOperand(9);
     const auto &input1Id = opExtInst->GetInOperand(10);
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes=" << kernelSizes
-                             << ", searchWindowSizes=" << searchWindowSizes << ", inputStrides=" << inputStrides
-                             << ", windowStrides=" << windowStrides << ", windowOffsets=" << windowOffsets
-                             << ", padding=" << padding << ", searchPattern=" << searchPattern << ", input0=%"
-                             << input0Id.AsId() << ", input1=%" << input1Id.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes="
+                                       << kernelSizes << ", searchWindowSizes=" << searchWindowSizes
+                                       << ", inputStrides=" << inputStrides << ", windowStrides=" << windowStrides
+                                       << ", windowOffsets=" << windowOffsets << ", padding=" << padding
+                                       << ", searchPattern=" << searchPattern << ", input0=%" << input0Id.AsId()
+                                       << ", input1=%" << input1Id.AsId() << std::endl;
 
     graphPipeline.makeMinSad(getTensor(input0Id), getTensor(input1Id), getTensor(*opExtInst), kernelSizes,
                              searchWindowSizes, inputStrides, windowStrides, windowOffsets, padding, searchPattern,
@@ -1102,11 +1111,12 @@ void GraphPassTosaSpv100::handleMinSadCost(const Instruction *opExtInst, const s
     const auto &input0Id = opExtInst->GetInOperand(9);
     const auto &input1Id = opExtInst->GetInOperand(10);
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes=" << kernelSizes
-                             << ", searchWindowSizes=" << searchWindowSizes << ", inputStrides=" << inputStrides
-                             << ", windowStrides=" << windowStrides << ", windowOffsets=" << windowOffsets
-                             << ", padding=" << padding << ", searchPattern=" << searchPattern << ", input0=%"
-                             << input0Id.AsId() << ", input1=%" << input1Id.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes="
+                                       << kernelSizes << ", searchWindowSizes=" << searchWindowSizes
+                                       << ", inputStrides=" << inputStrides << ", windowStrides=" << windowStrides
+                                       << ", windowOffsets=" << windowOffsets << ", padding=" << padding
+                                       << ", searchPattern=" << searchPattern << ", input0=%" << input0Id.AsId()
+                                       << ", input1=%" << input1Id.AsId() << std::endl;
 
     graphPipeline.makeMinSadCost(getTensor(input0Id), getTensor(input1Id), getTensor(*opExtInst, 0),
                                  getTensor(*opExtInst, 1), kernelSizes, searchWindowSizes, inputStrides, windowStrides,
@@ -1128,11 +1138,11 @@ void GraphPassTosaSpv100::handleRawSad(const Instruction *opExtInst, const std::
     const auto &input0Id = opExtInst->GetInOperand(8);
     const auto &input1Id = opExtInst->GetInOperand(9);
 
-    graphLog(Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes=" << kernelSizes
-                             << ", searchWindowSizes=" << searchWindowSizes << ", inputStrides=" << inputStrides
-                             << ", windowStrides=" << windowStrides << ", windowOffsets=" << windowOffsets
-                             << ", padding=" << padding << ", input0=%" << input0Id.AsId() << ", input1=%"
-                             << input1Id.AsId() << std::endl;
+    MLEL_LOG(graphLog, Severity::Info) << "OpExtInst result=" << resultId << ", " << debugName << ", kernelSizes="
+                                       << kernelSizes << ", searchWindowSizes=" << searchWindowSizes
+                                       << ", inputStrides=" << inputStrides << ", windowStrides=" << windowStrides
+                                       << ", windowOffsets=" << windowOffsets << ", padding=" << padding << ", input0=%"
+                                       << input0Id.AsId() << ", input1=%" << input1Id.AsId() << std::endl;
 
     graphPipeline.makeRawSad(getTensor(input0Id), getTensor(input1Id), getTensor(*opExtInst), kernelSizes,
                              searchWindowSizes, inputStrides, windowStrides, windowOffsets, padding, debugName);
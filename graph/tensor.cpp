@@ -87,7 +87,7 @@ std::shared_ptr<Tensor> TensorDescriptor::makeTensor(const std::shared_ptr<Tenso
 
     auto tensor = std::make_shared<Tensor>(_this->loader, _this->device, _this, tensorARM, tensorViewARM);
 
-    graphLog(Severity::Debug) << "Create tensor. tensor=" << tensor << ' ' << *tensor << std::endl;
+    MLEL_LOG(graphLog, Severity::Debug) << "Create tensor. tensor=" << tensor << ' ' << *tensor << std::endl;
 
     return tensor;
 }
@@ -326,11 +326,11 @@ VkTensorViewARM TensorDescriptor::createTensorViewARM(const VkTensorARM tensor,
     return tensorView;
 }
 
-Log &operator<<(Log &os, const Tensor &tensor) {
+const LogStream &operator<<(const LogStream &os, const Tensor &tensor) {
     return os << "tensorARM=" << tensor.getVkTensorARM() << ' ' << *tensor.getTensorDescriptor();
 }
 
-Log &operator<<(Log &os, const TensorDescriptor &tensor) {
+const LogStream &operator<<(const LogStream &os, const TensorDescriptor &tensor) {
     return os << "format=" << vk::to_string(vk::Format(tensor.getFormat())) << ", shape=" << tensor.getDimensions();
 }
 
@@ -112,8 +112,8 @@ class TensorDescriptor {
     ComputePipelineBase *pipeline{nullptr};
 };
 
-mlsdk::el::log::Log &operator<<(mlsdk::el::log::Log &os, const Tensor &tensor);
-mlsdk::el::log::Log &operator<<(mlsdk::el::log::Log &os, const TensorDescriptor &tensor);
+const mlsdk::el::log::LogStream &operator<<(const mlsdk::el::log::LogStream &os, const Tensor &tensor);
+const mlsdk::el::log::LogStream &operator<<(const mlsdk::el::log::LogStream &os, const TensorDescriptor &tensor);
 
 /*******************************************************************************
  * VirtualTensor
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2023-2025 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-FileCopyrightText: Copyright 2023-2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
  * SPDX-License-Identifier: Apache-2.0
  *
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "mlel/utils.hpp"
+#include "mlel/vulkan_allocator.hpp"
 #include "tensor_view.hpp"
 
 #include <algorithm>
@@ -60,13 +61,18 @@ substituteTensorBinding(uint32_t bindingCount, const VkDescriptorSetLayoutBindin
     return descriptorSetLayoutBindings;
 }
 
-inline std::tuple<std::vector<VkWriteDescriptorSet>, std::list<VkDescriptorBufferInfo>,
-                  std::list<VkDescriptorImageInfo>>
-substituteTensorWriteDescriptorSet(const Device &dev, uint32_t descriptorWriteCount,
-                                   const VkWriteDescriptorSet *pDescriptorWrites) {
-    std::vector<VkWriteDescriptorSet> writes;
-    std::list<VkDescriptorBufferInfo> bufferInfos;
-    std::list<VkDescriptorImageInfo> imageInfos;
+template <typename T> using ArenaList = std::list<T, ArenaAllocator<T>>;
+
+// The substituted writes and the infos they point to are allocated from arena, or from the heap without one
+inline std::tuple<ArenaVector<VkWriteDescriptorSet>, ArenaList<VkDescriptorBufferInfo>,
+                  ArenaList<VkDescriptorImageInfo>>
+substituteTensorWriteDescriptorSet(uint32_t descriptorWriteCount, const VkWriteDescriptorSet *pDescriptorWrites,
+                                   Arena *arena = nullptr) {
+    const ArenaAllocator<void> allocator{arena};
+    ArenaVector<VkWriteDescriptorSet> writes(allocator);
+    ArenaList<VkDescriptorBufferInfo> bufferInfos(allocator);
+    ArenaList<VkDescriptorImageInfo> imageInfos(allocator);
+    writes.reserve(descriptorWriteCount);
 
     // Loop over write descriptors and replace tensor bindings with uniform buffer for tensor description
     for (uint32_t i = 0; i < descriptorWriteCount; i++) {
@@ -97,11 +103,7 @@ substituteTensorWriteDescriptorSet(const Device &dev, uint32_t descriptorWriteCo
         for (uint32_t j = 0; j < tensorInfo->tensorViewCount; j++) {
             auto *const tensorViewARM = reinterpret_cast<TensorViewARM *>(tensorInfo->pTensorViews[j]);
 
-            bufferInfos.emplace_back(VkDescriptorBufferInfo{
-                tensorViewARM->getDescriptorBuffer(dev), // buffer
-                0,                                       // offset,
-                VK_WHOLE_SIZE,                           // range
-            });
+            bufferInfos.emplace_back(tensorViewARM->getDescriptorBufferInfo());
 
             writes.emplace_back(VkWriteDescriptorSet{
                 VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // sType
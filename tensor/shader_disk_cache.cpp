@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "shader_disk_cache.hpp"
+#include "tensor_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+using namespace mlsdk::el::log;
+
+namespace mlsdk::el::layer {
+
+namespace {
+// Bump when the entry layout changes
+constexpr std::array<char, 8> entryMagic{'V', 'M', 'E', 'L', 'S', 'P', 'V', '2'};
+
+// An entry is the header, followed by the input words and the rewritten words
+struct EntryHeader {
+    std::array<char, 8> magic;
+    uint64_t salt;
+    uint64_t inputHash;
+    uint64_t inputSize;
+    uint64_t outputSize;
+};
+
+constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325ULL;
+constexpr uint64_t fnvPrime = 0x100000001b3ULL;
+
+uint64_t fnv1a(const uint8_t *data, size_t size, uint64_t hash = fnvOffsetBasis) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * fnvPrime;
+    }
+    return hash;
+}
+
+std::string getTemporarySuffix() {
+    // Unique per process and call, the entry is renamed into place once complete
+    static std::atomic<uint64_t> counter{0};
+    std::ostringstream suffix;
+    suffix << ".tmp." << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id()) << "."
+           << std::chrono::steady_clock::now().time_since_epoch().count() << "." << counter++;
+    return suffix.str();
+}
+} // namespace
+
+ShaderDiskCache::ShaderDiskCache(std::filesystem::path directory, std::string_view salt)
+    : m_directory{std::move(directory)},
+      m_salt{fnv1a(reinterpret_cast<const uint8_t *>(salt.data()), salt.size())} {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        tensorLog(Severity::Warning) << "Failed to create shader cache directory " << m_directory << ": "
+                                     << error.message() << std::endl;
+    }
+}
+
+std::optional<std::vector<uint32_t>> ShaderDiskCache::load(const uint32_t *spirvCode, size_t spirvSize) const {
+    const auto key = getKey(spirvCode, spirvSize);
+    std::ifstream file(getPath(key), std::ios::binary | std::ios::ate);
+    if (!file) {
+        return std::nullopt;
+    }
+    const auto fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    EntryHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != entryMagic ||
+        header.salt != m_salt || header.inputHash != key.inputHash || header.inputSize != key.inputSize ||
+        header.outputSize == 0) {
+        return std::nullopt;
+    }
+
+    // The sizes come from the file, so they are checked against its length before anything is allocated
+    const auto payloadSize = fileSize - sizeof(header);
+    if (payloadSize % sizeof(uint32_t) != 0 || header.inputSize > payloadSize / sizeof(uint32_t) ||
+        header.outputSize != payloadSize / sizeof(uint32_t) - header.inputSize) {
+        return std::nullopt;
+    }
+
+    // The hash only names the entry, a colliding input must not be served the module rewritten from another one
+    std::vector<uint32_t> input(header.inputSize);
+    if (!file.read(reinterpret_cast<char *>(input.data()),
+                   static_cast<std::streamsize>(input.size() * sizeof(uint32_t))) ||
+        !std::equal(input.begin(), input.end(), spirvCode)) {
+        return std::nullopt;
+    }
+
+    std::vector<uint32_t> rewritten(header.outputSize);
+    if (!file.read(reinterpret_cast<char *>(rewritten.data()),
+                   static_cast<std::streamsize>(rewritten.size() * sizeof(uint32_t)))) {
+        return std::nullopt;
+    }
+
+    MLEL_LOG(tensorLog, Severity::Debug) << "Loaded SPIR-V at: " << spirvCode << " from shader cache" << std::endl;
+    return rewritten;
+}
+
+void ShaderDiskCache::store(const uint32_t *spirvCode, size_t spirvSize, const std::vector<uint32_t> &rewritten) const {
+    const auto key = getKey(spirvCode, spirvSize);
+    const auto path = getPath(key);
+    auto temporaryPath = path;
+    temporaryPath += getTemporarySuffix();
+
+    const EntryHeader header{entryMagic, m_salt, key.inputHash, key.inputSize, rewritten.size()};
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(spirvCode),
+                   static_cast<std::streamsize>(spirvSize * sizeof(uint32_t)));
+        file.write(reinterpret_cast<const char *>(rewritten.data()),
+                   static_cast<std::streamsize>(rewritten.size() * sizeof(uint32_t)));
+        if (!file.flush()) {
+            tensorLog(Severity::Warning) << "Failed to write shader cache entry " << temporaryPath << std::endl;
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    // Concurrent writers produce identical entries, so whichever rename lands last wins
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        tensorLog(Severity::Warning) << "Failed to replace shader cache entry " << path << ": " << error.message()
+                                     << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
+
+ShaderDiskCache::Key ShaderDiskCache::getKey(const uint32_t *spirvCode, size_t spirvSize) const {
+    const auto hash = fnv1a(reinterpret_cast<const uint8_t *>(spirvCode), spirvSize * sizeof(uint32_t), m_salt);
+    return {hash, spirvSize};
+}
+
+std::filesystem::path ShaderDiskCache::getPath(const Key &key) const {
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << key.inputHash << "-" << key.inputSize << ".spv";
+    return m_directory / name.str();
+}
+
+} // namespace mlsdk::el::layer
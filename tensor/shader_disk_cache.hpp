@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * ShaderDiskCache
+ *******************************************************************************/
+
+/**
+ * Stores rewritten SPIR-V modules in a directory so they survive the process.
+ *
+ * Each entry is a file named after the hash of the input SPIR-V and the salt, which identifies the layer version and
+ * build flags. The entry also holds the input SPIR-V, which is compared on load, so inputs with colliding hashes never
+ * share an entry. Entries are written to a temporary file and renamed into place, so processes sharing the directory
+ * never observe a partial entry. Entries that fail to read or do not match the input are ignored.
+ */
+class ShaderDiskCache {
+  public:
+    ShaderDiskCache(std::filesystem::path directory, std::string_view salt);
+
+    std::optional<std::vector<uint32_t>> load(const uint32_t *spirvCode, size_t spirvSize) const;
+    void store(const uint32_t *spirvCode, size_t spirvSize, const std::vector<uint32_t> &rewritten) const;
+
+  private:
+    struct Key {
+        uint64_t inputHash;
+        uint64_t inputSize;
+    };
+
+    Key getKey(const uint32_t *spirvCode, size_t spirvSize) const;
+    std::filesystem::path getPath(const Key &key) const;
+
+    std::filesystem::path m_directory;
+    uint64_t m_salt;
+};
+
+} // namespace mlsdk::el::layer
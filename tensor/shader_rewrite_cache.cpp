@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "shader_rewrite_cache.hpp"
+
+#include <exception>
+
+namespace mlsdk::el::layer {
+
+const ShaderRewriteCache::Spirv *ShaderRewriteCache::find(std::size_t hash) {
+    Entry entry;
+    {
+        auto &shard = getShard(hash);
+        const std::scoped_lock l(shard.mutex);
+        const auto it = shard.entries.find(hash);
+        if (it == shard.entries.end()) {
+            return nullptr;
+        }
+        entry = it->second;
+    }
+
+    try {
+        return entry.get().get();
+    } catch (...) {
+        // The rewrite failed, the caller gets to try again
+        return nullptr;
+    }
+}
+
+const ShaderRewriteCache::Spirv &ShaderRewriteCache::getOrRewrite(std::size_t hash, const Rewrite &rewrite) {
+    auto &shard = getShard(hash);
+    std::promise<std::shared_ptr<const Spirv>> promise;
+    Entry inFlight;
+    {
+        const std::scoped_lock l(shard.mutex);
+        const auto [it, inserted] = shard.entries.try_emplace(hash);
+        if (inserted) {
+            it->second = promise.get_future().share();
+        } else {
+            inFlight = it->second;
+        }
+    }
+
+    // Wait outside the lock, rewrites of other modules in this shard must not block on it
+    if (inFlight.valid()) {
+        return *inFlight.get();
+    }
+
+    try {
+        auto spirv = std::make_shared<const Spirv>(rewrite());
+        const auto &result = *spirv;
+        promise.set_value(std::move(spirv));
+        return result;
+    } catch (...) {
+        {
+            const std::scoped_lock l(shard.mutex);
+            shard.entries.erase(hash);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+} // namespace mlsdk::el::layer
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * ShaderRewriteCache
+ *******************************************************************************/
+
+/**
+ * Rewritten SPIR-V modules keyed by the hash of the input module, shared by all threads of the process.
+ *
+ * The cache is split in shards with a mutex each, and no lock is held while a module is rewritten. A thread asking for
+ * a module another thread is already rewriting waits for that rewrite instead of starting its own. Entries are never
+ * removed, so returned modules stay valid for the lifetime of the cache.
+ */
+class ShaderRewriteCache {
+  public:
+    using Spirv = std::vector<uint32_t>;
+    using Rewrite = std::function<Spirv()>;
+
+    /// Returns the module cached for the hash, waiting for it if in flight, or nullptr if there is none.
+    const Spirv *find(std::size_t hash);
+
+    /// Returns the module cached for the hash, calling rewrite to produce it if there is none. If rewrite throws, the
+    /// exception is passed to every waiting caller and the next call retries.
+    const Spirv &getOrRewrite(std::size_t hash, const Rewrite &rewrite);
+
+  private:
+    using Entry = std::shared_future<std::shared_ptr<const Spirv>>;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::size_t, Entry> entries;
+    };
+
+    Shard &getShard(std::size_t hash) { return shards[hash % shardCount]; }
+
+    static constexpr std::size_t shardCount = 16;
+
+    std::array<Shard, shardCount> shards;
+};
+
+} // namespace mlsdk::el::layer
@@ -85,4 +85,42 @@ const int g_TensorOperandsOutOfBoundsValue = 0x2;
   _emu_GL_ARM_tensors_write_array(tensor, tensorData, coords, _emu_GL_ARM_tensors_valueArr, operands, TYPE);           \
 }
 
+// Unchecked variants, used when the layer is configured to trust tensor accesses to be in bounds. Each coordinate
+// only contributes its stride, and array reads and writes touch consecutive elements unconditionally.
+#define _emu_GL_ARM_tensors_offset_unchecked(tensor, coords, TYPE) {                                                   \
+  _emu_GL_ARM_tensors_offset = 0;                                                                                      \
+  for (int _emu_GL_ARM_tensors_i = 0; _emu_GL_ARM_tensors_i < coords.length(); ++_emu_GL_ARM_tensors_i) {              \
+    _emu_GL_ARM_tensors_offset += int64_t(coords[_emu_GL_ARM_tensors_i]) * tensor.stride[_emu_GL_ARM_tensors_i];       \
+  }                                                                                                                    \
+  _emu_GL_ARM_tensors_offset /= _emu_GL_ARM_tensors_TypeSize(TYPE);                                                    \
+}
+
+#define _emu_GL_ARM_tensors_read_array_unchecked(tensor, tensorData, coords, value, TYPE) {                            \
+  int64_t _emu_GL_ARM_tensors_offset;                                                                                  \
+  _emu_GL_ARM_tensors_offset_unchecked(tensor, coords, TYPE);                                                          \
+  for (int _emu_GL_ARM_tensors_i = 0; _emu_GL_ARM_tensors_i < value.length(); ++_emu_GL_ARM_tensors_i) {               \
+    value[_emu_GL_ARM_tensors_i] = TYPE(tensorData.data[uint(_emu_GL_ARM_tensors_offset + _emu_GL_ARM_tensors_i)]);    \
+  }                                                                                                                    \
+}
+
+#define _emu_GL_ARM_tensors_read_scalar_unchecked(tensor, tensorData, coords, value, TYPE) {                           \
+  int64_t _emu_GL_ARM_tensors_offset;                                                                                  \
+  _emu_GL_ARM_tensors_offset_unchecked(tensor, coords, TYPE);                                                          \
+  value = TYPE(tensorData.data[uint(_emu_GL_ARM_tensors_offset)]);                                                     \
+}
+
+#define _emu_GL_ARM_tensors_write_array_unchecked(tensor, tensorData, coords, value, TYPE) {                           \
+  int64_t _emu_GL_ARM_tensors_offset;                                                                                  \
+  _emu_GL_ARM_tensors_offset_unchecked(tensor, coords, TYPE);                                                          \
+  for (int _emu_GL_ARM_tensors_i = 0; _emu_GL_ARM_tensors_i < value.length(); ++_emu_GL_ARM_tensors_i) {               \
+    tensorData.data[uint(_emu_GL_ARM_tensors_offset + _emu_GL_ARM_tensors_i)] = TYPE(value[_emu_GL_ARM_tensors_i]);    \
+  }                                                                                                                    \
+}
+
+#define _emu_GL_ARM_tensors_write_scalar_unchecked(tensor, tensorData, coords, value, TYPE) {                          \
+  int64_t _emu_GL_ARM_tensors_offset;                                                                                  \
+  _emu_GL_ARM_tensors_offset_unchecked(tensor, coords, TYPE);                                                          \
+  tensorData.data[uint(_emu_GL_ARM_tensors_offset)] = TYPE(value);                                                     \
+}
+
 )"
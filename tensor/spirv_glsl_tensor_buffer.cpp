@@ -14,11 +14,17 @@ using namespace mlsdk::el::utils;
 
 namespace mlsdk::el::layer {
 
+namespace {
+// Tensor operands, see SPV_ARM_tensors
+constexpr uint32_t tensorOperandsOutOfBoundsValue = 0x2;
+} // namespace
+
 const std::string CompilerTensorAsBuffer::tensorDefines =
 #include "shaders/tensor.glsl"
     ;
 
-CompilerTensorAsBuffer::CompilerTensorAsBuffer(std::vector<uint32_t> spirv_) : CompilerGLSL(std::move(spirv_)) {
+CompilerTensorAsBuffer::CompilerTensorAsBuffer(std::vector<uint32_t> spirv_, bool isBoundsChecked_)
+    : CompilerGLSL(std::move(spirv_)), isBoundsChecked{isBoundsChecked_} {
     /* The CompilerGLSL constructor parses SPIRV to the SPIRV-Cross internal representation
      This constructor finds any tensors in the parsed data and replaces them with structs pointing to uniform buffers
      The end result is that a TensorARM variable of the followig forms (where TYPE is e.g. uint16_t and 0<RANK<=6)
@@ -222,6 +228,16 @@ void CompilerTensorAsBuffer::emit_instruction(const Instruction &instruction) {
 
         const std::string macroName =
             is_array(outType) ? "_emu_GL_ARM_tensors_read_array" : "_emu_GL_ARM_tensors_read_scalar";
+        if (!isBoundsChecked && (length <= 4 || (ops[4] & tensorOperandsOutOfBoundsValue) == 0)) {
+            statement(macroName, "_unchecked(",                  // Macro name
+                      to_expression(ops[2]), ", ",               // tensor
+                      getTensorBufferExpression(ops[2]), ", ",   // tensor data buffer
+                      to_expression(ops[3]), ", ",               // coordinates
+                      to_expression(ops[1]), ", ",               // out value
+                      type_to_glsl(get<SPIRType>(outType.self)), // glsl type of output var
+                      ");");
+            break;
+        }
         statement(macroName, "(",                            // Macro name
                   to_expression(ops[2]), ", ",               // tensor
                   getTensorBufferExpression(ops[2]), ", ",   // tensor data buffer
@@ -255,6 +271,16 @@ void CompilerTensorAsBuffer::emit_instruction(const Instruction &instruction) {
 
         const std::string macroName =
             is_array(outType) ? "_emu_GL_ARM_tensors_write_array" : "_emu_GL_ARM_tensors_write_scalar";
+        if (!isBoundsChecked) {
+            statement(macroName, "_unchecked(",                // Macro name
+                      to_expression(ops[0]), ", ",             // tensor
+                      getTensorBufferExpression(ops[0]), ", ", // tensor data buffer
+                      to_expression(ops[1]), ", ",             // coordinates
+                      to_expression(ops[2]), ", ",             // in value
+                      type_to_glsl(elementType),               // glsl type of tensor buffer
+                      ");");
+            break;
+        }
         statement(macroName, "(",                          // Macro name
                   to_expression(ops[0]), ", ",             // tensor
                   getTensorBufferExpression(ops[0]), ", ", // tensor data buffer
@@ -16,7 +16,7 @@ namespace mlsdk::el::layer {
 
 class CompilerTensorAsBuffer : public spirv_cross::CompilerGLSL {
   public:
-    explicit CompilerTensorAsBuffer(std::vector<uint32_t> spirv_);
+    explicit CompilerTensorAsBuffer(std::vector<uint32_t> spirv_, bool isBoundsChecked_ = true);
     bool hasTensors() const { return !tensorVariables.empty() || !tensorArrayVariables.empty(); }
     bool isCompute() const { return get_execution_model() == spv::ExecutionModelGLCompute; }
 
@@ -29,6 +29,8 @@ class CompilerTensorAsBuffer : public spirv_cross::CompilerGLSL {
   private:
     // Largest allowed tensor rank
     static const int MAX_RANK = 6;
+    // Reads without an out of bounds value and writes use the unchecked macros when false
+    bool isBoundsChecked;
     // GLSL constanst and macros used to emulate tensor function, loaded from `shaders/tensor.glsl`
     static const std::string tensorDefines;
     // Used to keep track of SPIRV-Cross variables across `CompilerGLSL` function calls
@@ -0,0 +1,1076 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include "spirv_pass_tensor_buffer.hpp"
+#include "tensor_log.hpp"
+
+#include "source/opt/ir_builder.h"
+#include "source/opt/pass.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <spirv-tools/optimizer.hpp>
+#include <stdexcept>
+#include <string>
+
+using namespace mlsdk::el::log;
+
+namespace {
+
+// Tensor operands, see SPV_ARM_tensors
+constexpr uint32_t tensorOperandsNontemporal = 0x1;
+constexpr uint32_t tensorOperandsOutOfBoundsValue = 0x2;
+
+// Layout of TensorDescriptor::DescriptorBuffer, the uniform buffer each tensor view is bound as
+constexpr uint32_t maxRank = 6;
+constexpr uint32_t descriptorAddressMember = 0;
+constexpr uint32_t descriptorShapeMember = 1;
+constexpr uint32_t descriptorStrideMember = 2;
+constexpr uint32_t descriptorArrayStride = 16;
+constexpr uint32_t descriptorShapeOffset = 16;
+constexpr uint32_t descriptorStrideOffset = descriptorShapeOffset + maxRank * descriptorArrayStride;
+
+constexpr size_t spirvHeaderWords = 5;
+
+bool isTensorInstruction(spv::Op opcode) {
+    return opcode == spv::Op::OpTensorReadARM || opcode == spv::Op::OpTensorWriteARM ||
+           opcode == spv::Op::OpTensorQuerySizeARM;
+}
+
+uint32_t getMemoryAccess(uint32_t tensorOperands) {
+    auto memoryAccess = static_cast<uint32_t>(spv::MemoryAccessMask::Aligned);
+    if (tensorOperands & tensorOperandsNontemporal) {
+        memoryAccess |= static_cast<uint32_t>(spv::MemoryAccessMask::Nontemporal);
+    }
+    return memoryAccess;
+}
+
+} // namespace
+
+/*******************************************************************************
+ * TensorAsBufferPass
+ *******************************************************************************/
+
+namespace spvtools::opt {
+
+/**
+ * Replaces each tensor variable with a uniform block holding the tensor descriptor record, that is the buffer device
+ * address of the tensor data followed by its shape and strides. Tensor reads and writes become bounds checked loads
+ * and stores through physical storage buffer pointers, and size queries become loads of the shape.
+ *
+ * Without bounds checking, reads without an out of bounds value and all writes are trusted to be in bounds and become
+ * plain loads and stores, skipping the shape loads, comparisons and selects.
+ */
+class TensorAsBufferPass final : public Pass {
+  public:
+    explicit TensorAsBufferPass(bool isBoundsChecked) : isBoundsChecked{isBoundsChecked} {}
+
+    const char *name() const override { return "tensor-as-buffer-pass"; }
+
+  protected:
+    Status Process() override;
+
+  private:
+    struct Tensor {
+        uint32_t descriptorPointerId;
+        uint32_t elementTypeId;
+        uint32_t storageTypeId;
+        uint32_t elementSize;
+    };
+
+    struct Access {
+        uint32_t baseAddressId;
+        std::vector<uint32_t> addressIds;
+        std::vector<uint32_t> outOfBoundsIds;
+    };
+
+    void collectTypes();
+    void collectInstructions();
+    void createDescriptorTypes();
+    void rewriteVariables();
+    void createStoreFunctions();
+    uint32_t createStoreFunction(const Tensor &tensor, uint32_t memoryAccess);
+    void lowerQuerySize(Instruction *instruction);
+    void lowerRead(Instruction *instruction);
+    void lowerWrite(Instruction *instruction);
+    void removeTensorTypes();
+    void updateCapabilities();
+
+    Tensor getTensor(uint32_t tensorId);
+    Access emitAccess(InstructionBuilder &builder, const Tensor &tensor, uint32_t coordinatesId, uint32_t count,
+                      bool isChecked);
+    uint32_t emitDescriptorLoad(InstructionBuilder &builder, uint32_t descriptorPointerId, uint32_t member,
+                                uint32_t indexId = 0);
+    uint32_t emitToUint64(InstructionBuilder &builder, uint32_t valueId, uint32_t typeId);
+    uint32_t emitFromUint64(InstructionBuilder &builder, uint32_t valueId, uint32_t typeId);
+    uint32_t emit(InstructionBuilder &builder, spv::Op opcode, uint32_t typeId,
+                  const Instruction::OperandList &operands);
+    void replace(Instruction *instruction, uint32_t valueId);
+
+    uint32_t takeId();
+    uint32_t findOrAddType(spv::Op opcode, const Instruction::OperandList &operands);
+    uint32_t addType(spv::Op opcode, const Instruction::OperandList &operands);
+    uint32_t getIntType(uint32_t width, uint32_t signedness);
+    uint32_t getPointerType(spv::StorageClass storageClass, uint32_t pointeeTypeId);
+    uint32_t getConstant(uint32_t typeId, uint64_t value);
+    uint32_t getNullConstant(uint32_t typeId);
+    uint32_t getArrayLength(const Instruction *arrayType) const;
+    void decorate(uint32_t id, spv::Decoration decoration, std::optional<uint32_t> value = std::nullopt);
+    void decorateMember(uint32_t id, uint32_t member, spv::Decoration decoration, uint32_t value);
+    void addExtension(const std::string &extension);
+    bool isTensorType(uint32_t id) const;
+
+    static constexpr auto preservedAnalyses =
+        IRContext::kAnalysisDefUse | IRContext::kAnalysisInstrToBlockMapping;
+
+    // Tensor type to element type
+    std::map<uint32_t, uint32_t> tensorTypes;
+    std::set<uint32_t> tensorArrayTypes;
+    // Pointer type to tensor or tensor array type
+    std::map<uint32_t, uint32_t> tensorPointerTypes;
+    std::vector<Instruction *> tensorFunctionTypes;
+    std::vector<Instruction *> tensorVariables;
+    std::vector<Instruction *> tensorAccessChains;
+    std::vector<Instruction *> tensorLoads;
+    std::vector<Instruction *> tensorInstructions;
+
+    uint32_t uint32Type = 0;
+    uint32_t uint64Type = 0;
+    uint32_t boolType = 0;
+    uint32_t descriptorType = 0;
+    uint32_t descriptorPointerType = 0;
+    uint32_t uint64UniformPointerType = 0;
+
+    // Storage type and memory access to the function storing one element
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> storeFunctions;
+    std::map<std::pair<uint32_t, uint64_t>, uint32_t> constants;
+    std::map<uint32_t, uint32_t> nullConstants;
+
+    bool uses8BitStorage = false;
+    bool uses16BitStorage = false;
+    bool usesBoolTensors = false;
+    const bool isBoundsChecked;
+};
+
+Pass::Status TensorAsBufferPass::Process() {
+    collectTypes();
+    if (tensorTypes.empty()) {
+        return Status::SuccessWithoutChange;
+    }
+
+    collectInstructions();
+    createDescriptorTypes();
+    rewriteVariables();
+    createStoreFunctions();
+
+    for (auto *instruction : tensorInstructions) {
+        switch (instruction->opcode()) {
+        case spv::Op::OpTensorQuerySizeARM:
+            lowerQuerySize(instruction);
+            break;
+        case spv::Op::OpTensorReadARM:
+            lowerRead(instruction);
+            break;
+        case spv::Op::OpTensorWriteARM:
+            lowerWrite(instruction);
+            break;
+        default:
+            break;
+        }
+    }
+
+    removeTensorTypes();
+    updateCapabilities();
+
+    return Status::SuccessWithChange;
+}
+
+void TensorAsBufferPass::collectTypes() {
+    for (auto &instruction : get_module()->types_values()) {
+        const auto opcode = instruction.opcode();
+        const auto typeId = instruction.type_id();
+
+        switch (opcode) {
+        case spv::Op::OpTypeTensorARM:
+            tensorTypes[instruction.result_id()] = instruction.GetSingleWordInOperand(0);
+            break;
+        case spv::Op::OpTypeArray:
+        case spv::Op::OpTypeRuntimeArray: {
+            const auto elementTypeId = instruction.GetSingleWordInOperand(0);
+            if (tensorArrayTypes.count(elementTypeId) != 0) {
+                throw std::runtime_error("Arrays of tensor arrays are not supported");
+            }
+            if (tensorTypes.count(elementTypeId) != 0) {
+                tensorArrayTypes.insert(instruction.result_id());
+            }
+            break;
+        }
+        case spv::Op::OpTypePointer: {
+            const auto pointeeTypeId = instruction.GetSingleWordInOperand(1);
+            if (!isTensorType(pointeeTypeId)) {
+                break;
+            }
+            if (spv::StorageClass(instruction.GetSingleWordInOperand(0)) != spv::StorageClass::UniformConstant) {
+                throw std::runtime_error("Tensors outside the UniformConstant storage class are not supported");
+            }
+            tensorPointerTypes[instruction.result_id()] = pointeeTypeId;
+            break;
+        }
+        case spv::Op::OpTypeStruct:
+        case spv::Op::OpTypeFunction: {
+            bool usesTensors = false;
+            for (uint32_t i = 0; i < instruction.NumInOperands(); i++) {
+                const auto id = instruction.GetSingleWordInOperand(i);
+                usesTensors = usesTensors || isTensorType(id) || tensorPointerTypes.count(id) != 0;
+            }
+            if (usesTensors && opcode == spv::Op::OpTypeStruct) {
+                throw std::runtime_error("Structs of tensors are not supported");
+            }
+            if (usesTensors) {
+                tensorFunctionTypes.push_back(&instruction);
+            }
+            break;
+        }
+        case spv::Op::OpVariable:
+            if (tensorPointerTypes.count(typeId) != 0) {
+                tensorVariables.push_back(&instruction);
+            }
+            break;
+        default:
+            if (typeId != 0 && isTensorType(typeId)) {
+                throw std::runtime_error("Tensor constants are not supported");
+            }
+            break;
+        }
+    }
+
+    // Functions taking tensors have been inlined by now, so their types must be unused
+    for (const auto *functionType : tensorFunctionTypes) {
+        if (get_def_use_mgr()->NumUsers(functionType) != 0) {
+            throw std::runtime_error("Tensors passed to functions are not supported");
+        }
+    }
+}
+
+void TensorAsBufferPass::collectInstructions() {
+    for (auto &function : *get_module()) {
+        function.ForEachInst([this](Instruction *instruction) {
+            const auto opcode = instruction->opcode();
+            const auto typeId = instruction->type_id();
+
+            if (isTensorInstruction(opcode)) {
+                tensorInstructions.push_back(instruction);
+                return;
+            }
+            if (opcode == spv::Op::OpLoad && tensorTypes.count(typeId) != 0) {
+                tensorLoads.push_back(instruction);
+                return;
+            }
+            if ((opcode == spv::Op::OpAccessChain || opcode == spv::Op::OpInBoundsAccessChain) &&
+                tensorPointerTypes.count(typeId) != 0) {
+                const auto *base = get_def_use_mgr()->GetDef(instruction->GetSingleWordInOperand(0));
+                if (base->opcode() != spv::Op::OpVariable || instruction->NumInOperands() != 2) {
+                    throw std::runtime_error("Only single index access chains into tensor arrays are supported");
+                }
+                tensorAccessChains.push_back(instruction);
+                return;
+            }
+            if (typeId != 0 && (isTensorType(typeId) || tensorPointerTypes.count(typeId) != 0)) {
+                throw std::runtime_error("Unsupported tensor instruction with opcode " +
+                                         std::to_string(static_cast<uint32_t>(opcode)));
+            }
+        });
+    }
+
+    // Loaded tensors may only be consumed as the tensor operand of tensor instructions
+    for (auto *load : tensorLoads) {
+        const auto loadId = load->result_id();
+        get_def_use_mgr()->ForEachUser(load, [loadId](Instruction *user) {
+            const auto opcode = user->opcode();
+            if (opcode == spv::Op::OpName || opcode == spv::Op::OpDecorate) {
+                return;
+            }
+            if (!isTensorInstruction(opcode) || user->GetSingleWordInOperand(0) != loadId) {
+                throw std::runtime_error("Tensors may only be used by tensor instructions");
+            }
+        });
+    }
+
+    auto *memoryModel = get_module()->GetMemoryModel();
+    const auto addressingModel = spv::AddressingModel(memoryModel->GetSingleWordInOperand(0));
+    if (addressingModel != spv::AddressingModel::Logical &&
+        addressingModel != spv::AddressingModel::PhysicalStorageBuffer64) {
+        throw std::runtime_error("Unsupported addressing model");
+    }
+}
+
+void TensorAsBufferPass::createDescriptorTypes() {
+    uint32Type = getIntType(32, 0);
+    uint64Type = getIntType(64, 0);
+    boolType = findOrAddType(spv::Op::OpTypeBool, {});
+
+    // struct { uint64_t address; uint64_t shape[6]; uint64_t stride[6]; } with std140 array strides
+    const auto rankId = getConstant(uint32Type, maxRank);
+    const auto dimensionsType = addType(spv::Op::OpTypeArray, {
+                                                                  {SPV_OPERAND_TYPE_ID, {uint64Type}},
+                                                                  {SPV_OPERAND_TYPE_ID, {rankId}},
+                                                              });
+    decorate(dimensionsType, spv::Decoration::ArrayStride, descriptorArrayStride);
+
+    descriptorType = addType(spv::Op::OpTypeStruct, {
+                                                        {SPV_OPERAND_TYPE_ID, {uint64Type}},
+                                                        {SPV_OPERAND_TYPE_ID, {dimensionsType}},
+                                                        {SPV_OPERAND_TYPE_ID, {dimensionsType}},
+                                                    });
+    decorate(descriptorType, spv::Decoration::Block);
+    decorateMember(descriptorType, descriptorAddressMember, spv::Decoration::Offset, 0);
+    decorateMember(descriptorType, descriptorShapeMember, spv::Decoration::Offset, descriptorShapeOffset);
+    decorateMember(descriptorType, descriptorStrideMember, spv::Decoration::Offset, descriptorStrideOffset);
+
+    descriptorPointerType = getPointerType(spv::StorageClass::Uniform, descriptorType);
+    uint64UniformPointerType = getPointerType(spv::StorageClass::Uniform, uint64Type);
+}
+
+void TensorAsBufferPass::rewriteVariables() {
+    std::map<uint32_t, uint32_t> pointerTypes;
+    for (const auto &[pointerTypeId, pointeeTypeId] : tensorPointerTypes) {
+        if (tensorTypes.count(pointeeTypeId) != 0) {
+            pointerTypes[pointerTypeId] = descriptorPointerType;
+            continue;
+        }
+
+        // Arrays of tensors become arrays of descriptor blocks of the same length
+        const auto *arrayType = get_def_use_mgr()->GetDef(pointeeTypeId);
+        Instruction::OperandList operands{{SPV_OPERAND_TYPE_ID, {descriptorType}}};
+        if (arrayType->opcode() == spv::Op::OpTypeArray) {
+            operands.push_back({SPV_OPERAND_TYPE_ID, {arrayType->GetSingleWordInOperand(1)}});
+        }
+        pointerTypes[pointerTypeId] =
+            getPointerType(spv::StorageClass::Uniform, addType(arrayType->opcode(), operands));
+    }
+
+    for (auto *variable : tensorVariables) {
+        variable->SetResultType(pointerTypes.at(variable->type_id()));
+        variable->SetInOperand(0, {static_cast<uint32_t>(spv::StorageClass::Uniform)});
+
+        // Only the binding and descriptor set apply to the descriptor block
+        get_decoration_mgr()->RemoveDecorationsFrom(variable->result_id(), [](const Instruction &decoration) {
+            if (decoration.opcode() != spv::Op::OpDecorate) {
+                return false;
+            }
+            const auto kind = spv::Decoration(decoration.GetSingleWordInOperand(1));
+            return kind != spv::Decoration::Binding && kind != spv::Decoration::DescriptorSet;
+        });
+
+        // The variable must follow the descriptor types, which have been added at the end of the module
+        variable->RemoveFromList();
+        get_module()->AddGlobalValue(std::unique_ptr<Instruction>(variable));
+        get_def_use_mgr()->AnalyzeInstUse(variable);
+    }
+
+    for (auto *accessChain : tensorAccessChains) {
+        accessChain->SetResultType(descriptorPointerType);
+        get_def_use_mgr()->AnalyzeInstUse(accessChain);
+    }
+}
+
+void TensorAsBufferPass::createStoreFunctions() {
+    for (const auto *instruction : tensorInstructions) {
+        if (instruction->opcode() != spv::Op::OpTensorWriteARM) {
+            continue;
+        }
+
+        if (!isBoundsChecked) {
+            // Unchecked writes store directly
+            continue;
+        }
+
+        const auto tensor = getTensor(instruction->GetSingleWordInOperand(0));
+        const auto tensorOperands = instruction->NumInOperands() > 3 ? instruction->GetSingleWordInOperand(3) : 0;
+        const auto key = std::make_pair(tensor.storageTypeId, getMemoryAccess(tensorOperands));
+        if (storeFunctions.count(key) == 0) {
+            storeFunctions[key] = createStoreFunction(tensor, key.second);
+        }
+    }
+}
+
+uint32_t TensorAsBufferPass::createStoreFunction(const Tensor &tensor, uint32_t memoryAccess) {
+    // Stores must be skipped for out of bounds elements. Branching inside a function keeps the control flow of the
+    // caller, and with it any structured merge or loop header, intact.
+    //
+    // void store(bool inBounds, T *pointer, T value) { if (inBounds) { *pointer = value; } }
+    const auto voidType = findOrAddType(spv::Op::OpTypeVoid, {});
+    const auto pointerType = getPointerType(spv::StorageClass::PhysicalStorageBuffer, tensor.storageTypeId);
+    const auto functionType = findOrAddType(spv::Op::OpTypeFunction, {
+                                                                          {SPV_OPERAND_TYPE_ID, {voidType}},
+                                                                          {SPV_OPERAND_TYPE_ID, {boolType}},
+                                                                          {SPV_OPERAND_TYPE_ID, {pointerType}},
+                                                                          {SPV_OPERAND_TYPE_ID, {tensor.storageTypeId}},
+                                                                      });
+
+    const auto functionId = takeId();
+    const auto inBoundsId = takeId();
+    const auto pointerId = takeId();
+    const auto valueId = takeId();
+    const auto entryId = takeId();
+    const auto storeId = takeId();
+    const auto mergeId = takeId();
+
+    auto function = MakeUnique<Function>(MakeUnique<Instruction>(
+        context(), spv::Op::OpFunction, voidType, functionId,
+        Instruction::OperandList{
+            {SPV_OPERAND_TYPE_FUNCTION_CONTROL, {static_cast<uint32_t>(spv::FunctionControlMask::Inline)}},
+            {SPV_OPERAND_TYPE_ID, {functionType}},
+        }));
+    function->AddParameter(MakeUnique<Instruction>(context(), spv::Op::OpFunctionParameter, boolType, inBoundsId,
+                                                   Instruction::OperandList{}));
+    function->AddParameter(MakeUnique<Instruction>(context(), spv::Op::OpFunctionParameter, pointerType, pointerId,
+                                                   Instruction::OperandList{}));
+    function->AddParameter(MakeUnique<Instruction>(context(), spv::Op::OpFunctionParameter, tensor.storageTypeId,
+                                                   valueId, Instruction::OperandList{}));
+
+    auto entry = MakeUnique<BasicBlock>(
+        MakeUnique<Instruction>(context(), spv::Op::OpLabel, 0, entryId, Instruction::OperandList{}));
+    entry->AddInstruction(MakeUnique<Instruction>(
+        context(), spv::Op::OpSelectionMerge, 0, 0,
+        Instruction::OperandList{
+            {SPV_OPERAND_TYPE_ID, {mergeId}},
+            {SPV_OPERAND_TYPE_SELECTION_CONTROL, {static_cast<uint32_t>(spv::SelectionControlMask::MaskNone)}},
+        }));
+    entry->AddInstruction(MakeUnique<Instruction>(context(), spv::Op::OpBranchConditional, 0, 0,
+                                                  Instruction::OperandList{
+                                                      {SPV_OPERAND_TYPE_ID, {inBoundsId}},
+                                                      {SPV_OPERAND_TYPE_ID, {storeId}},
+                                                      {SPV_OPERAND_TYPE_ID, {mergeId}},
+                                                  }));
+
+    auto store = MakeUnique<BasicBlock>(
+        MakeUnique<Instruction>(context(), spv::Op::OpLabel, 0, storeId, Instruction::OperandList{}));
+    store->AddInstruction(MakeUnique<Instruction>(context(), spv::Op::OpStore, 0, 0,
+                                                  Instruction::OperandList{
+                                                      {SPV_OPERAND_TYPE_ID, {pointerId}},
+                                                      {SPV_OPERAND_TYPE_ID, {valueId}},
+                                                      {SPV_OPERAND_TYPE_MEMORY_ACCESS, {memoryAccess}},
+                                                      {SPV_OPERAND_TYPE_LITERAL_INTEGER, {tensor.elementSize}},
+                                                  }));
+    store->AddInstruction(MakeUnique<Instruction>(context(), spv::Op::OpBranch, 0, 0,
+                                                  Instruction::OperandList{{SPV_OPERAND_TYPE_ID, {mergeId}}}));
+
+    auto merge = MakeUnique<BasicBlock>(
+        MakeUnique<Instruction>(context(), spv::Op::OpLabel, 0, mergeId, Instruction::OperandList{}));
+    merge->AddInstruction(MakeUnique<Instruction>(context(), spv::Op::OpReturn, 0, 0, Instruction::OperandList{}));
+
+    function->AddBasicBlock(std::move(entry));
+    function->AddBasicBlock(std::move(store));
+    function->AddBasicBlock(std::move(merge));
+    function->SetFunctionEnd(
+        MakeUnique<Instruction>(context(), spv::Op::OpFunctionEnd, 0, 0, Instruction::OperandList{}));
+
+    auto *functionPointer = function.get();
+    get_module()->AddFunction(std::move(function));
+    functionPointer->ForEachInst([this](Instruction *instruction) {
+        get_def_use_mgr()->AnalyzeInstDefUse(instruction);
+    });
+
+    // Physical storage buffer pointer parameters must declare whether they alias
+    decorate(pointerId, spv::Decoration::Aliased);
+
+    return functionId;
+}
+
+void TensorAsBufferPass::lowerQuerySize(Instruction *instruction) {
+    // OpTensorQuerySizeARM <tensor> <dimension>
+    InstructionBuilder builder(context(), instruction, preservedAnalyses);
+    const auto tensor = getTensor(instruction->GetSingleWordInOperand(0));
+    const auto sizeId = emitDescriptorLoad(builder, tensor.descriptorPointerId, descriptorShapeMember,
+                                           instruction->GetSingleWordInOperand(1));
+    replace(instruction, emitFromUint64(builder, sizeId, instruction->type_id()));
+}
+
+void TensorAsBufferPass::lowerRead(Instruction *instruction) {
+    // OpTensorReadARM <tensor> <coordinates> [<tensor operands> [<out of bounds value>]]
+    InstructionBuilder builder(context(), instruction, preservedAnalyses);
+    const auto tensor = getTensor(instruction->GetSingleWordInOperand(0));
+    const auto resultTypeId = instruction->type_id();
+    const auto *resultType = get_def_use_mgr()->GetDef(resultTypeId);
+    const bool isArray = resultType->opcode() == spv::Op::OpTypeArray;
+    const auto count = isArray ? getArrayLength(resultType) : 1;
+
+    const auto tensorOperands = instruction->NumInOperands() > 2 ? instruction->GetSingleWordInOperand(2) : 0;
+    const auto outOfBoundsValueId = (tensorOperands & tensorOperandsOutOfBoundsValue)
+                                        ? instruction->GetSingleWordInOperand(3)
+                                        : getNullConstant(tensor.elementTypeId);
+    const auto memoryAccess = getMemoryAccess(tensorOperands);
+    const auto pointerType = getPointerType(spv::StorageClass::PhysicalStorageBuffer, tensor.storageTypeId);
+    const bool isChecked = isBoundsChecked || (tensorOperands & tensorOperandsOutOfBoundsValue) != 0;
+
+    const auto access = emitAccess(builder, tensor, instruction->GetSingleWordInOperand(1), count, isChecked);
+    Instruction::OperandList valueIds;
+    for (uint32_t i = 0; i < count; i++) {
+        // Out of bounds elements load the first element of the tensor, which always exists, and discard it
+        const auto addressId = !isChecked ? access.addressIds[i]
+                                          : emit(builder, spv::Op::OpSelect, uint64Type,
+                                                 {
+                                                     {SPV_OPERAND_TYPE_ID, {access.outOfBoundsIds[i]}},
+                                                     {SPV_OPERAND_TYPE_ID, {access.baseAddressId}},
+                                                     {SPV_OPERAND_TYPE_ID, {access.addressIds[i]}},
+                                                 });
+        const auto pointerId =
+            emit(builder, spv::Op::OpConvertUToPtr, pointerType, {{SPV_OPERAND_TYPE_ID, {addressId}}});
+        auto valueId = emit(builder, spv::Op::OpLoad, tensor.storageTypeId,
+                            {
+                                {SPV_OPERAND_TYPE_ID, {pointerId}},
+                                {SPV_OPERAND_TYPE_MEMORY_ACCESS, {memoryAccess}},
+                                {SPV_OPERAND_TYPE_LITERAL_INTEGER, {tensor.elementSize}},
+                            });
+        if (tensor.storageTypeId != tensor.elementTypeId) {
+            valueId = emit(builder, spv::Op::OpINotEqual, boolType,
+                           {
+                               {SPV_OPERAND_TYPE_ID, {valueId}},
+                               {SPV_OPERAND_TYPE_ID, {getConstant(tensor.storageTypeId, 0)}},
+                           });
+        }
+        if (isChecked) {
+            valueId = emit(builder, spv::Op::OpSelect, tensor.elementTypeId,
+                           {
+                               {SPV_OPERAND_TYPE_ID, {access.outOfBoundsIds[i]}},
+                               {SPV_OPERAND_TYPE_ID, {outOfBoundsValueId}},
+                               {SPV_OPERAND_TYPE_ID, {valueId}},
+                           });
+        }
+        valueIds.push_back({SPV_OPERAND_TYPE_ID, {valueId}});
+    }
+
+    replace(instruction, isArray ? emit(builder, spv::Op::OpCompositeConstruct, resultTypeId, valueIds)
+                                 : valueIds.front().words[0]);
+}
+
+void TensorAsBufferPass::lowerWrite(Instruction *instruction) {
+    // OpTensorWriteARM <tensor> <coordinates> <object> [<tensor operands>]
+    InstructionBuilder builder(context(), instruction, preservedAnalyses);
+    const auto tensor = getTensor(instruction->GetSingleWordInOperand(0));
+    const auto objectId = instruction->GetSingleWordInOperand(2);
+    const auto *objectType = get_def_use_mgr()->GetDef(get_def_use_mgr()->GetDef(objectId)->type_id());
+    const bool isArray = objectType->opcode() == spv::Op::OpTypeArray;
+    const auto count = isArray ? getArrayLength(objectType) : 1;
+
+    const auto tensorOperands = instruction->NumInOperands() > 3 ? instruction->GetSingleWordInOperand(3) : 0;
+    const auto memoryAccess = getMemoryAccess(tensorOperands);
+    const auto voidType = findOrAddType(spv::Op::OpTypeVoid, {});
+    const auto pointerType = getPointerType(spv::StorageClass::PhysicalStorageBuffer, tensor.storageTypeId);
+
+    const auto access = emitAccess(builder, tensor, instruction->GetSingleWordInOperand(1), count, isBoundsChecked);
+    for (uint32_t i = 0; i < count; i++) {
+        auto valueId = objectId;
+        if (isArray) {
+            valueId = emit(builder, spv::Op::OpCompositeExtract, objectType->GetSingleWordInOperand(0),
+                           {
+                               {SPV_OPERAND_TYPE_ID, {objectId}},
+                               {SPV_OPERAND_TYPE_LITERAL_INTEGER, {i}},
+                           });
+        }
+        if (tensor.storageTypeId != tensor.elementTypeId) {
+            valueId = emit(builder, spv::Op::OpSelect, tensor.storageTypeId,
+                           {
+                               {SPV_OPERAND_TYPE_ID, {valueId}},
+                               {SPV_OPERAND_TYPE_ID, {getConstant(tensor.storageTypeId, 1)}},
+                               {SPV_OPERAND_TYPE_ID, {getConstant(tensor.storageTypeId, 0)}},
+                           });
+        }
+        const auto pointerId =
+            emit(builder, spv::Op::OpConvertUToPtr, pointerType, {{SPV_OPERAND_TYPE_ID, {access.addressIds[i]}}});
+        if (!isBoundsChecked) {
+            builder.AddInstruction(MakeUnique<Instruction>(context(), spv::Op::OpStore, 0, 0,
+                                                           Instruction::OperandList{
+                                                               {SPV_OPERAND_TYPE_ID, {pointerId}},
+                                                               {SPV_OPERAND_TYPE_ID, {valueId}},
+                                                               {SPV_OPERAND_TYPE_MEMORY_ACCESS, {memoryAccess}},
+                                                               {SPV_OPERAND_TYPE_LITERAL_INTEGER, {tensor.elementSize}},
+                                                           }));
+            continue;
+        }
+        const auto inBoundsId =
+            emit(builder, spv::Op::OpLogicalNot, boolType, {{SPV_OPERAND_TYPE_ID, {access.outOfBoundsIds[i]}}});
+        emit(builder, spv::Op::OpFunctionCall, voidType,
+             {
+                 {SPV_OPERAND_TYPE_ID, {storeFunctions.at({tensor.storageTypeId, memoryAccess})}},
+                 {SPV_OPERAND_TYPE_ID, {inBoundsId}},
+                 {SPV_OPERAND_TYPE_ID, {pointerId}},
+                 {SPV_OPERAND_TYPE_ID, {valueId}},
+             });
+    }
+
+    context()->KillInst(instruction);
+}
+
+void TensorAsBufferPass::removeTensorTypes() {
+    for (auto *load : tensorLoads) {
+        context()->KillInst(load);
+    }
+    for (auto *functionType : tensorFunctionTypes) {
+        context()->KillInst(functionType);
+    }
+    for (const auto &[pointerTypeId, _] : tensorPointerTypes) {
+        context()->KillInst(get_def_use_mgr()->GetDef(pointerTypeId));
+    }
+    for (const auto arrayTypeId : tensorArrayTypes) {
+        context()->KillInst(get_def_use_mgr()->GetDef(arrayTypeId));
+    }
+    for (const auto &[tensorTypeId, _] : tensorTypes) {
+        context()->KillInst(get_def_use_mgr()->GetDef(tensorTypeId));
+    }
+}
+
+void TensorAsBufferPass::updateCapabilities() {
+    auto *memoryModel = get_module()->GetMemoryModel();
+    memoryModel->SetInOperand(0, {static_cast<uint32_t>(spv::AddressingModel::PhysicalStorageBuffer64)});
+
+    context()->AddCapability(spv::Capability::PhysicalStorageBufferAddresses);
+    context()->AddCapability(spv::Capability::Int64);
+    addExtension("SPV_KHR_physical_storage_buffer");
+
+    if (usesBoolTensors) {
+        context()->AddCapability(spv::Capability::Int8);
+    }
+    if (uses8BitStorage) {
+        context()->AddCapability(spv::Capability::StorageBuffer8BitAccess);
+        addExtension("SPV_KHR_8bit_storage");
+    }
+    if (uses16BitStorage) {
+        context()->AddCapability(spv::Capability::StorageBuffer16BitAccess);
+        addExtension("SPV_KHR_16bit_storage");
+    }
+    if (context()->get_feature_mgr()->HasCapability(spv::Capability::StorageTensorArrayNonUniformIndexingARM)) {
+        context()->AddCapability(spv::Capability::UniformBufferArrayNonUniformIndexing);
+    }
+
+    std::vector<Instruction *> tensorDeclarations;
+    for (auto &capability : get_module()->capabilities()) {
+        switch (spv::Capability(capability.GetSingleWordInOperand(0))) {
+        case spv::Capability::TensorsARM:
+        case spv::Capability::StorageTensorArrayDynamicIndexingARM:
+        case spv::Capability::StorageTensorArrayNonUniformIndexingARM:
+            tensorDeclarations.push_back(&capability);
+            break;
+        default:
+            break;
+        }
+    }
+    for (auto &extension : get_module()->extensions()) {
+        if (extension.GetInOperand(0).AsString() == "SPV_ARM_tensors") {
+            tensorDeclarations.push_back(&extension);
+        }
+    }
+    for (auto *declaration : tensorDeclarations) {
+        context()->KillInst(declaration);
+    }
+}
+
+TensorAsBufferPass::Tensor TensorAsBufferPass::getTensor(uint32_t tensorId) {
+    // Tensors are always loaded from a variable or an access chain into a tensor array
+    const auto *load = get_def_use_mgr()->GetDef(tensorId);
+    const auto elementTypeId = tensorTypes.at(load->type_id());
+    const auto *elementType = get_def_use_mgr()->GetDef(elementTypeId);
+
+    Tensor tensor{load->GetSingleWordInOperand(0), elementTypeId, elementTypeId, 1};
+    switch (elementType->opcode()) {
+    case spv::Op::OpTypeBool:
+        // Boolean tensors are stored as 8-bit integers
+        tensor.storageTypeId = getIntType(8, 0);
+        usesBoolTensors = true;
+        break;
+    case spv::Op::OpTypeInt:
+    case spv::Op::OpTypeFloat:
+        tensor.elementSize = elementType->GetSingleWordInOperand(0) / 8;
+        break;
+    default:
+        throw std::runtime_error("Unsupported tensor element type");
+    }
+
+    uses8BitStorage = uses8BitStorage || tensor.elementSize == 1;
+    uses16BitStorage = uses16BitStorage || tensor.elementSize == 2;
+    return tensor;
+}
+
+TensorAsBufferPass::Access TensorAsBufferPass::emitAccess(InstructionBuilder &builder, const Tensor &tensor,
+                                                          uint32_t coordinatesId, uint32_t count, bool isChecked) {
+    const auto *coordinatesType = get_def_use_mgr()->GetDef(get_def_use_mgr()->GetDef(coordinatesId)->type_id());
+    if (coordinatesType->opcode() != spv::Op::OpTypeArray) {
+        throw std::runtime_error("Tensor coordinates must be an array");
+    }
+    const auto coordinateType = coordinatesType->GetSingleWordInOperand(0);
+    const auto rank = getArrayLength(coordinatesType);
+    if (rank == 0 || rank > maxRank) {
+        throw std::runtime_error("Unsupported tensor rank " + std::to_string(rank));
+    }
+
+    Access access;
+    access.baseAddressId = emitDescriptorLoad(builder, tensor.descriptorPointerId, descriptorAddressMember);
+
+    // The strides are in bytes. Negative coordinates wrap around and fail the unsigned bounds check.
+    uint32_t offsetId = 0;
+    uint32_t outOfBoundsId = 0;
+    uint32_t coordinateId = 0;
+    uint32_t shapeId = 0;
+    uint32_t strideId = 0;
+    for (uint32_t i = 0; i < rank; i++) {
+        const auto extractId = emit(builder, spv::Op::OpCompositeExtract, coordinateType,
+                                    {
+                                        {SPV_OPERAND_TYPE_ID, {coordinatesId}},
+                                        {SPV_OPERAND_TYPE_LITERAL_INTEGER, {i}},
+                                    });
+        coordinateId = emitToUint64(builder, extractId, coordinateType);
+        strideId = emitDescriptorLoad(builder, tensor.descriptorPointerId, descriptorStrideMember,
+                                      getConstant(uint32Type, i));
+
+        if (isChecked) {
+            shapeId = emitDescriptorLoad(builder, tensor.descriptorPointerId, descriptorShapeMember,
+                                         getConstant(uint32Type, i));
+            const auto pastEndId = emit(builder, spv::Op::OpUGreaterThanEqual, boolType,
+                                        {{SPV_OPERAND_TYPE_ID, {coordinateId}}, {SPV_OPERAND_TYPE_ID, {shapeId}}});
+            outOfBoundsId =
+                i == 0 ? pastEndId
+                       : emit(builder, spv::Op::OpLogicalOr, boolType,
+                              {{SPV_OPERAND_TYPE_ID, {outOfBoundsId}}, {SPV_OPERAND_TYPE_ID, {pastEndId}}});
+        }
+
+        const auto termId = emit(builder, spv::Op::OpIMul, uint64Type,
+                                 {{SPV_OPERAND_TYPE_ID, {coordinateId}}, {SPV_OPERAND_TYPE_ID, {strideId}}});
+        offsetId = i == 0 ? termId
+                          : emit(builder, spv::Op::OpIAdd, uint64Type,
+                                 {{SPV_OPERAND_TYPE_ID, {offsetId}}, {SPV_OPERAND_TYPE_ID, {termId}}});
+    }
+
+    access.addressIds.push_back(
+        emit(builder, spv::Op::OpIAdd, uint64Type,
+             {{SPV_OPERAND_TYPE_ID, {access.baseAddressId}}, {SPV_OPERAND_TYPE_ID, {offsetId}}}));
+    if (isChecked) {
+        access.outOfBoundsIds.push_back(outOfBoundsId);
+    }
+
+    // Array reads and writes access consecutive elements along the innermost dimension
+    for (uint32_t i = 1; i < count; i++) {
+        const auto indexId = getConstant(uint64Type, i);
+        if (isChecked) {
+            const auto innerId = emit(builder, spv::Op::OpIAdd, uint64Type,
+                                      {{SPV_OPERAND_TYPE_ID, {coordinateId}}, {SPV_OPERAND_TYPE_ID, {indexId}}});
+            const auto pastEndId = emit(builder, spv::Op::OpUGreaterThanEqual, boolType,
+                                        {{SPV_OPERAND_TYPE_ID, {innerId}}, {SPV_OPERAND_TYPE_ID, {shapeId}}});
+            access.outOfBoundsIds.push_back(
+                emit(builder, spv::Op::OpLogicalOr, boolType,
+                     {{SPV_OPERAND_TYPE_ID, {access.outOfBoundsIds.back()}}, {SPV_OPERAND_TYPE_ID, {pastEndId}}}));
+        }
+
+        const auto stepId = emit(builder, spv::Op::OpIMul, uint64Type,
+                                 {{SPV_OPERAND_TYPE_ID, {strideId}}, {SPV_OPERAND_TYPE_ID, {indexId}}});
+        access.addressIds.push_back(
+            emit(builder, spv::Op::OpIAdd, uint64Type,
+                 {{SPV_OPERAND_TYPE_ID, {access.addressIds.front()}}, {SPV_OPERAND_TYPE_ID, {stepId}}}));
+    }
+
+    return access;
+}
+
+uint32_t TensorAsBufferPass::emitDescriptorLoad(InstructionBuilder &builder, uint32_t descriptorPointerId,
+                                                uint32_t member, uint32_t indexId) {
+    Instruction::OperandList indices{
+        {SPV_OPERAND_TYPE_ID, {descriptorPointerId}},
+        {SPV_OPERAND_TYPE_ID, {getConstant(uint32Type, member)}},
+    };
+    if (indexId != 0) {
+        indices.push_back({SPV_OPERAND_TYPE_ID, {indexId}});
+    }
+
+    const auto pointerId = emit(builder, spv::Op::OpAccessChain, uint64UniformPointerType, indices);
+    return emit(builder, spv::Op::OpLoad, uint64Type, {{SPV_OPERAND_TYPE_ID, {pointerId}}});
+}
+
+uint32_t TensorAsBufferPass::emitToUint64(InstructionBuilder &builder, uint32_t valueId, uint32_t typeId) {
+    const auto *type = get_def_use_mgr()->GetDef(typeId);
+    if (type->opcode() != spv::Op::OpTypeInt) {
+        throw std::runtime_error("Tensor coordinates must be integers");
+    }
+
+    const auto width = type->GetSingleWordInOperand(0);
+    const bool isSigned = type->GetSingleWordInOperand(1) != 0;
+    if (width == 64) {
+        return isSigned ? emit(builder, spv::Op::OpBitcast, uint64Type, {{SPV_OPERAND_TYPE_ID, {valueId}}}) : valueId;
+    }
+    return emit(builder, isSigned ? spv::Op::OpSConvert : spv::Op::OpUConvert, uint64Type,
+                {{SPV_OPERAND_TYPE_ID, {valueId}}});
+}
+
+uint32_t TensorAsBufferPass::emitFromUint64(InstructionBuilder &builder, uint32_t valueId, uint32_t typeId) {
+    if (typeId == uint64Type) {
+        return valueId;
+    }
+
+    const auto *type = get_def_use_mgr()->GetDef(typeId);
+    const auto width = type->GetSingleWordInOperand(0);
+    const bool isSigned = type->GetSingleWordInOperand(1) != 0;
+    if (width == 64) {
+        return emit(builder, spv::Op::OpBitcast, typeId, {{SPV_OPERAND_TYPE_ID, {valueId}}});
+    }
+    return emit(builder, isSigned ? spv::Op::OpSConvert : spv::Op::OpUConvert, typeId,
+                {{SPV_OPERAND_TYPE_ID, {valueId}}});
+}
+
+uint32_t TensorAsBufferPass::emit(InstructionBuilder &builder, spv::Op opcode, uint32_t typeId,
+                                  const Instruction::OperandList &operands) {
+    const auto id = takeId();
+    builder.AddInstruction(MakeUnique<Instruction>(context(), opcode, typeId, id, operands));
+    return id;
+}
+
+void TensorAsBufferPass::replace(Instruction *instruction, uint32_t valueId) {
+    context()->ReplaceAllUsesWith(instruction->result_id(), valueId);
+    context()->KillInst(instruction);
+}
+
+uint32_t TensorAsBufferPass::takeId() {
+    const auto id = TakeNextId();
+    if (id == 0) {
+        throw std::runtime_error("Ran out of SPIR-V ids");
+    }
+    return id;
+}
+
+uint32_t TensorAsBufferPass::findOrAddType(spv::Op opcode, const Instruction::OperandList &operands) {
+    // Non-aggregate types must not be declared twice
+    for (const auto &instruction : get_module()->types_values()) {
+        if (instruction.opcode() != opcode || instruction.NumInOperands() != operands.size()) {
+            continue;
+        }
+
+        bool isEqual = true;
+        for (uint32_t i = 0; i < operands.size() && isEqual; i++) {
+            const auto &words = instruction.GetInOperand(i).words;
+            const auto &expected = operands[i].words;
+            isEqual = words.size() == expected.size() && std::equal(words.begin(), words.end(), expected.begin());
+        }
+        if (isEqual) {
+            return instruction.result_id();
+        }
+    }
+    return addType(opcode, operands);
+}
+
+uint32_t TensorAsBufferPass::addType(spv::Op opcode, const Instruction::OperandList &operands) {
+    const auto id = takeId();
+    context()->AddType(MakeUnique<Instruction>(context(), opcode, 0, id, operands));
+    return id;
+}
+
+uint32_t TensorAsBufferPass::getIntType(uint32_t width, uint32_t signedness) {
+    return findOrAddType(spv::Op::OpTypeInt, {
+                                                 {SPV_OPERAND_TYPE_LITERAL_INTEGER, {width}},
+                                                 {SPV_OPERAND_TYPE_LITERAL_INTEGER, {signedness}},
+                                             });
+}
+
+uint32_t TensorAsBufferPass::getPointerType(spv::StorageClass storageClass, uint32_t pointeeTypeId) {
+    return findOrAddType(spv::Op::OpTypePointer,
+                         {
+                             {SPV_OPERAND_TYPE_STORAGE_CLASS, {static_cast<uint32_t>(storageClass)}},
+                             {SPV_OPERAND_TYPE_ID, {pointeeTypeId}},
+                         });
+}
+
+uint32_t TensorAsBufferPass::getConstant(uint32_t typeId, uint64_t value) {
+    auto &id = constants[{typeId, value}];
+    if (id != 0) {
+        return id;
+    }
+
+    Instruction::OperandList operands{{SPV_OPERAND_TYPE_TYPED_LITERAL_NUMBER, {static_cast<uint32_t>(value)}}};
+    if (get_def_use_mgr()->GetDef(typeId)->GetSingleWordInOperand(0) == 64) {
+        operands[0].words.push_back(static_cast<uint32_t>(value >> 32));
+    }
+
+    id = takeId();
+    context()->AddGlobalValue(MakeUnique<Instruction>(context(), spv::Op::OpConstant, typeId, id, operands));
+    return id;
+}
+
+uint32_t TensorAsBufferPass::getNullConstant(uint32_t typeId) {
+    auto &id = nullConstants[typeId];
+    if (id == 0) {
+        id = takeId();
+        context()->AddGlobalValue(
+            MakeUnique<Instruction>(context(), spv::Op::OpConstantNull, typeId, id, Instruction::OperandList{}));
+    }
+    return id;
+}
+
+uint32_t TensorAsBufferPass::getArrayLength(const Instruction *arrayType) const {
+    const auto *length = get_def_use_mgr()->GetDef(arrayType->GetSingleWordInOperand(1));
+    if (length->opcode() != spv::Op::OpConstant) {
+        throw std::runtime_error("Array lengths must be constants");
+    }
+    return length->GetSingleWordInOperand(0);
+}
+
+void TensorAsBufferPass::decorate(uint32_t id, spv::Decoration decoration, std::optional<uint32_t> value) {
+    Instruction::OperandList operands{
+        {SPV_OPERAND_TYPE_ID, {id}},
+        {SPV_OPERAND_TYPE_DECORATION, {static_cast<uint32_t>(decoration)}},
+    };
+    if (value.has_value()) {
+        operands.push_back({SPV_OPERAND_TYPE_LITERAL_INTEGER, {*value}});
+    }
+    context()->AddAnnotationInst(MakeUnique<Instruction>(context(), spv::Op::OpDecorate, 0, 0, operands));
+}
+
+void TensorAsBufferPass::decorateMember(uint32_t id, uint32_t member, spv::Decoration decoration, uint32_t value) {
+    context()->AddAnnotationInst(
+        MakeUnique<Instruction>(context(), spv::Op::OpMemberDecorate, 0, 0,
+                                Instruction::OperandList{
+                                    {SPV_OPERAND_TYPE_ID, {id}},
+                                    {SPV_OPERAND_TYPE_LITERAL_INTEGER, {member}},
+                                    {SPV_OPERAND_TYPE_DECORATION, {static_cast<uint32_t>(decoration)}},
+                                    {SPV_OPERAND_TYPE_LITERAL_INTEGER, {value}},
+                                }));
+}
+
+void TensorAsBufferPass::addExtension(const std::string &extension) {
+    for (const auto &instruction : get_module()->extensions()) {
+        if (instruction.GetInOperand(0).AsString() == extension) {
+            return;
+        }
+    }
+    context()->AddExtension(extension);
+}
+
+bool TensorAsBufferPass::isTensorType(uint32_t id) const {
+    return tensorTypes.count(id) != 0 || tensorArrayTypes.count(id) != 0;
+}
+
+} // namespace spvtools::opt
+
+/*******************************************************************************
+ * Tensor lowering
+ *******************************************************************************/
+
+namespace mlsdk::el::layer {
+
+TensorModuleInfo inspectTensorModule(const std::vector<uint32_t> &spirv) {
+    if (spirv.size() < spirvHeaderWords || spirv[0] != spv::MagicNumber) {
+        return {};
+    }
+
+    TensorModuleInfo info;
+    // Tensor types, arrays of tensors and pointers to either
+    std::set<uint32_t> tensorTypes;
+    bool hasEntryPoint = false;
+    bool isCompute = true;
+    for (size_t offset = spirvHeaderWords; offset < spirv.size();) {
+        const uint32_t wordCount = spirv[offset] >> spv::WordCountShift;
+        const auto opcode = static_cast<spv::Op>(spirv[offset] & spv::OpCodeMask);
+        if (wordCount == 0 || offset + wordCount > spirv.size()) {
+            return {};
+        }
+
+        const auto *operands = &spirv[offset + 1];
+        switch (opcode) {
+        case spv::Op::OpEntryPoint:
+            hasEntryPoint = true;
+            isCompute = isCompute && wordCount > 1 &&
+                        operands[0] == static_cast<uint32_t>(spv::ExecutionModel::GLCompute);
+            break;
+        case spv::Op::OpTypeTensorARM:
+            if (wordCount > 1) {
+                tensorTypes.insert(operands[0]);
+            }
+            break;
+        case spv::Op::OpTypeArray:
+        case spv::Op::OpTypeRuntimeArray:
+        case spv::Op::OpTypePointer: {
+            const uint32_t elementIndex = opcode == spv::Op::OpTypePointer ? 2 : 1;
+            if (wordCount > elementIndex + 1 && tensorTypes.count(operands[elementIndex]) != 0) {
+                tensorTypes.insert(operands[0]);
+            }
+            break;
+        }
+        case spv::Op::OpTypeFunction:
+            // Result id and return type, followed by the parameter types
+            for (uint32_t i = 2; i + 1 < wordCount; i++) {
+                info.hasTensorParameters = info.hasTensorParameters || tensorTypes.count(operands[i]) != 0;
+            }
+            break;
+        case spv::Op::OpVariable:
+            info.hasTensors = info.hasTensors || (wordCount > 1 && tensorTypes.count(operands[0]) != 0);
+            break;
+        default:
+            break;
+        }
+
+        offset += wordCount;
+    }
+
+    info.isValid = true;
+    info.isCompute = hasEntryPoint && isCompute;
+    return info;
+}
+
+bool declaresTensorCapability(const uint32_t *spirv, size_t size) {
+    if (size < spirvHeaderWords || spirv[0] != spv::MagicNumber) {
+        // Leave malformed modules to the full inspection, which reports them
+        return true;
+    }
+
+    // Capabilities are the first instructions of a module, so the scan stops at the first other instruction
+    for (size_t offset = spirvHeaderWords; offset < size;) {
+        const uint32_t wordCount = spirv[offset] >> spv::WordCountShift;
+        if (wordCount == 0 || offset + wordCount > size) {
+            return true;
+        }
+        if (static_cast<spv::Op>(spirv[offset] & spv::OpCodeMask) != spv::Op::OpCapability) {
+            return false;
+        }
+        if (wordCount > 1 && static_cast<spv::Capability>(spirv[offset + 1]) == spv::Capability::TensorsARM) {
+            return true;
+        }
+        offset += wordCount;
+    }
+    return false;
+}
+
+std::optional<std::vector<uint32_t>> lowerTensorsToBuffers(const std::vector<uint32_t> &spirv, bool isBoundsChecked) {
+    spvtools::Optimizer optimizer{SPV_ENV_UNIVERSAL_1_6};
+
+    if (inspectTensorModule(spirv).hasTensorParameters) {
+        // Tensors can only be lowered where they are loaded from their variables, which requires inlining every
+        // function taking a tensor
+        optimizer.RegisterPass(spvtools::CreateInlineExhaustivePass());
+        optimizer.RegisterPass(spvtools::CreateEliminateDeadFunctionsPass());
+    }
+    optimizer.RegisterPass(
+        spvtools::Optimizer::PassToken{spvtools::MakeUnique<spvtools::opt::TensorAsBufferPass>(isBoundsChecked)});
+
+    spvtools::OptimizerOptions options;
+    options.set_run_validator(false);
+    std::vector<uint32_t> lowered;
+    try {
+        if (!optimizer.Run(spirv.data(), spirv.size(), &lowered, options)) {
+            MLEL_LOG(tensorLog, Severity::Info) << "Failed to lower tensors in SPIR-V at: " << spirv.data()
+                                                << std::endl;
+            return std::nullopt;
+        }
+    } catch (const std::exception &e) {
+        MLEL_LOG(tensorLog, Severity::Info) << "Could not lower tensors in SPIR-V at: " << spirv.data() << ": "
+                                            << e.what() << std::endl;
+        return std::nullopt;
+    }
+
+    return lowered;
+}
+
+} // namespace mlsdk::el::layer
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#pragma once
+
+/*******************************************************************************
+ * Includes
+ *******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// SPIRV-Tools and SPIRV-Cross both declare the spv namespace, so this header must not include either of them
+
+namespace mlsdk::el::layer {
+
+/*******************************************************************************
+ * Tensor lowering
+ *******************************************************************************/
+
+struct TensorModuleInfo {
+    bool isValid = false;
+    bool hasTensors = false;
+    bool isCompute = false;
+    bool hasTensorParameters = false;
+};
+
+/**
+ * Scan the SPIR-V words for tensor variables and entry points without building a module.
+ */
+TensorModuleInfo inspectTensorModule(const std::vector<uint32_t> &spirv);
+
+/**
+ * Scan the leading capabilities of the SPIR-V words for TensorsARM. Return false only for well formed modules that do
+ * not declare it, so they can be passed through without any further inspection.
+ */
+bool declaresTensorCapability(const uint32_t *spirv, size_t size);
+
+/**
+ * Lower tensor variables, reads, writes and size queries to uniform descriptor records and buffer device address
+ * loads and stores, directly on the SPIR-V module. All other instructions are left untouched, unless tensors are
+ * passed to functions in which case the module is inlined first.
+ *
+ * Without bounds checking, only reads with an out of bounds value are checked, every other read and write is assumed
+ * to be in bounds and accesses memory unconditionally.
+ *
+ * Return std::nullopt if the module uses tensors in a way the pass does not support.
+ */
+std::optional<std::vector<uint32_t>> lowerTensorsToBuffers(const std::vector<uint32_t> &spirv,
+                                                           bool isBoundsChecked = true);
+
+} // namespace mlsdk::el::layer
@@ -6,9 +6,14 @@
 #include "tensor_arm.hpp"
 
 #include "tensor_arm_detail.hpp"
+#include "tensor_descriptor.hpp"
 
 #include "mlel/utils.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <numeric>
 #include <vulkan/vulkan_format_traits.hpp>
 
@@ -95,6 +100,14 @@ VkResult TensorARM::create(const Device &dev, const VkTensorCreateInfoARM &creat
 }
 
 void TensorARM::destroy(const Device &dev, const VkAllocationCallbacks *pAllocator) {
+    {
+        // Views may outlive the tensor, they stop referring to it here
+        std::lock_guard lock(m_descriptorMutex);
+        for (auto *descriptor : m_descriptors) {
+            descriptor->releaseTensor();
+        }
+        m_descriptors.clear();
+    }
     dev.loader->vkDestroyBuffer(dev.device, m_tensorBuffer, pAllocator);
 }
 
@@ -135,7 +148,22 @@ void TensorARM::getDeviceTensorMemoryRequirements(const Device &dev, const VkTen
 }
 
 VkResult TensorARM::bindTensorMemory(const Device &dev, VkDeviceMemory memory, VkDeviceSize offset) {
-    return dev.loader->vkBindBufferMemory(dev.device, m_tensorBuffer, memory, offset);
+    const VkResult result = dev.loader->vkBindBufferMemory(dev.device, m_tensorBuffer, memory, offset);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    const VkBufferDeviceAddressInfo addressInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, // type
+        nullptr,                                      // next
+        m_tensorBuffer,                               // buffer
+    };
+    std::lock_guard lock(m_descriptorMutex);
+    m_deviceAddress = dev.loader->vkGetBufferDeviceAddress(dev.device, &addressInfo);
+    for (auto *descriptor : m_descriptors) {
+        descriptor->writeRecord(*this);
+    }
+    return VK_SUCCESS;
 }
 
 void TensorARM::updateAliasedTensorInfo(const Device &dev, VkImage image) {
@@ -152,34 +180,98 @@ void TensorARM::updateAliasedTensorInfo(const Device &dev, VkImage image) {
         };
         VkSubresourceLayout imageSubresourceLayout{};
         dev.loader->vkGetImageSubresourceLayout(dev.device, image, &imageSubresource, &imageSubresourceLayout);
+
+        std::lock_guard lock(m_descriptorMutex);
         tensor_arm_detail::updateAliasedStrides(rank, m_info.strides, imageSubresourceLayout);
+        for (auto *descriptor : m_descriptors) {
+            descriptor->writeRecord(*this);
+        }
     }
 }
 
-void TensorARM::copyToTensor(CommandBuffer &cmd, const TensorARM &dstTensor) {
+void TensorARM::addDescriptor(TensorDescriptor *descriptor) {
+    std::lock_guard lock(m_descriptorMutex);
+    descriptor->writeRecord(*this);
+    m_descriptors.push_back(descriptor);
+}
+
+void TensorARM::removeDescriptor(TensorDescriptor *descriptor) {
+    std::lock_guard lock(m_descriptorMutex);
+    m_descriptors.erase(std::remove(m_descriptors.begin(), m_descriptors.end(), descriptor), m_descriptors.end());
+}
+
+void TensorARM::copyToTensor(CommandBuffer &cmd, TensorCopyPipelineCache &pipelineCache,
+                             TensorCopyRegionArena &regionArena, const TensorARM &dstTensor, uint32_t regionCount,
+                             const VkTensorCopyARM *regions) const {
     const auto &srcDimensions = m_info.dimensions;
-    const auto &srcStrides = m_info.strides;
-    const auto srcElementSize = m_info.elementSize;
     const auto &dstDimensions = dstTensor.m_info.dimensions;
-    const auto &dstStrides = dstTensor.m_info.strides;
-    const auto dstElementSize = dstTensor.m_info.elementSize;
+    const auto elementSize = m_info.elementSize;
 
-    if (srcDimensions.size() != dstDimensions.size() || srcElementSize != dstElementSize ||
-        !std::equal(srcDimensions.begin(), srcDimensions.end(), dstDimensions.begin())) {
-        throw std::runtime_error("Src tensor and dst tensor should have same dimensions and element size.");
+    if (srcDimensions.size() != dstDimensions.size() || elementSize != dstTensor.m_info.elementSize) {
+        throw std::runtime_error("Src tensor and dst tensor should have same rank and element size.");
     }
 
-    if (std::equal(srcStrides.begin(), srcStrides.end(), dstStrides.begin())) {
-        VkBufferCopy copyInfo = {0, 0, m_info.size};
-        cmd.loader->vkCmdCopyBuffer(cmd.commandBuffer, getTensorBuffer(), dstTensor.getTensorBuffer(), 1, &copyInfo);
-    } else {
-        const auto regionCount = static_cast<uint32_t>(utils::getElementCount(srcDimensions));
-        m_copy_pipeline = std::make_shared<TensorCopyPipeline>(cmd.loader, cmd.device->device, *this, dstTensor);
-        cmd.beginSecondaryCommandBuffer();
-        assert(regionCount < std::numeric_limits<uint32_t>::max());
-        m_copy_pipeline->cmdBindAndDispatchCopy(cmd.secondaryCommandBuffer, regionCount);
-        cmd.endAndSubmitSecondaryCommandBuffer();
+    // Missing offsets are zero and a missing extent covers the whole tensor
+    const auto rank = srcDimensions.size();
+    const std::vector<int64_t> zeros(rank, 0);
+    std::vector<tensor_arm_detail::CopyRegion> copyRegions;
+    copyRegions.reserve(regionCount);
+    for (uint32_t i = 0; i < regionCount; i++) {
+        const auto &region = regions[i];
+        if ((region.pSrcOffset != nullptr || region.pDstOffset != nullptr || region.pExtent != nullptr) &&
+            region.dimensionCount != rank) {
+            throw std::runtime_error("Tensor copy region should have the same rank as the tensors.");
+        }
+        copyRegions.push_back({
+            region.pSrcOffset ? std::vector<int64_t>(region.pSrcOffset, region.pSrcOffset + rank) : zeros,
+            region.pDstOffset ? std::vector<int64_t>(region.pDstOffset, region.pDstOffset + rank) : zeros,
+            region.pExtent ? std::vector<int64_t>(region.pExtent, region.pExtent + rank) : srcDimensions,
+        });
+    }
+
+    const VkBufferDeviceAddressInfo srcAddressInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, // type
+        nullptr,                                      // next
+        getTensorBuffer(),                            // buffer
+    };
+    const VkBufferDeviceAddressInfo dstAddressInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, // type
+        nullptr,                                      // next
+        dstTensor.getTensorBuffer(),                  // buffer
+    };
+    const auto srcAddress = cmd.loader->vkGetBufferDeviceAddress(cmd.device->device, &srcAddressInfo);
+    const auto dstAddress = cmd.loader->vkGetBufferDeviceAddress(cmd.device->device, &dstAddressInfo);
+    const bool isVectorAligned = srcAddress % tensor_arm_detail::copyVectorSize == 0 &&
+                                 dstAddress % tensor_arm_detail::copyVectorSize == 0;
+
+    const auto plan =
+        tensor_arm_detail::planCopy(static_cast<int64_t>(elementSize), srcDimensions, m_info.strides, dstDimensions,
+                                    dstTensor.m_info.strides, copyRegions, isVectorAligned);
+
+    if (!plan.bufferCopies.empty()) {
+        cmd.loader->vkCmdCopyBuffer(cmd.commandBuffer, getTensorBuffer(), dstTensor.getTensorBuffer(),
+                                    static_cast<uint32_t>(plan.bufferCopies.size()), plan.bufferCopies.data());
     }
+
+    // Recorded straight into the application's command buffer. Like the copy command itself, this leaves the
+    // compute pipeline and push constant state undefined for the commands that follow.
+    const auto dispatchCopy = [&](const tensor_arm_detail::CopyDispatch &dispatch, size_t unitSize) {
+        if (dispatch.regions.empty()) {
+            return;
+        }
+
+        const TensorCopyPipeline::PushConstant pushConstant = {
+            srcAddress, // src address
+            dstAddress, // dst address
+            regionArena.allocate(*cmd.device, cmd.commandBuffer, dispatch.regions.data(),
+                                 dispatch.regions.size() * sizeof(tensor_arm_detail::CopyRegionEntry)), // regions
+            static_cast<uint32_t>(dispatch.regions.size()), // region count
+        };
+        const auto &pipeline = pipelineCache.get(*cmd.device, unitSize);
+        pipeline.cmdDispatchCopy(cmd.commandBuffer, pushConstant, dispatch.elementCount);
+    };
+    dispatchCopy(plan.elementCopies, elementSize);
+    dispatchCopy(plan.vectorCopies, static_cast<size_t>(tensor_arm_detail::copyVectorSize));
 }
 
 VkResult TensorARM::getOpaqueCaptureDescriptorDataEXT(const Device &dev, void *pData) {
@@ -191,44 +283,41 @@ VkResult TensorARM::getOpaqueCaptureDescriptorDataEXT(const Device &dev, void *p
     return dev.loader->vkGetBufferOpaqueCaptureDescriptorDataEXT(dev.device, &info, pData);
 }
 
-TensorCopyPipeline::TensorCopyPipeline(
-    const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader, VkDevice _device,
-    const TensorARM &srcTensor, const TensorARM &dstTensor)
-    : loader{_loader}, device{_device}, pushConstant{createPushConstant(srcTensor, dstTensor)},
-      shaderModule{createShaderModule(srcTensor)}, descriptorPool{createDescriptorPool()},
-      descriptorSetLayout{createDescriptorSetLayout()}, pipelineLayout{createPipelineLayout()},
-      pipeline{createPipeline(srcTensor)}, descriptorSet{createDescriptorSet(srcTensor, dstTensor)} {}
+/*******************************************************************************
+ * TensorCopyPipeline
+ *******************************************************************************/
+
+TensorCopyPipeline::TensorCopyPipeline(const Device &dev, size_t elementSize)
+    : loader{dev.loader}, device{dev.device}, pipelineLayout{createPipelineLayout()},
+      shaderModule{createShaderModule(elementSize)}, pipeline{createPipeline()} {}
 
 TensorCopyPipeline::~TensorCopyPipeline() {
-    loader->vkFreeDescriptorSets(device, descriptorPool, 1, &descriptorSet);
-    loader->vkDestroyDescriptorPool(device, descriptorPool, nullptr);
     loader->vkDestroyPipeline(device, pipeline, nullptr);
-    loader->vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
     loader->vkDestroyShaderModule(device, shaderModule, nullptr);
-    loader->vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    loader->vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 }
 
-TensorCopyPipeline::PushConstant TensorCopyPipeline::createPushConstant(const TensorARM &srcTensor,
-                                                                        const TensorARM &dstTensor) const {
-    PushConstant constant;
-    const auto &dimensions = srcTensor.getTensorInfo().dimensions;
-    const auto &srcStrides = srcTensor.getTensorInfo().strides;
-    const auto &dstStrides = dstTensor.getTensorInfo().strides;
-    std::copy(dimensions.begin(), dimensions.end(), constant.dimensions);
-    std::copy(srcStrides.begin(), srcStrides.end(), constant.srcStrides);
-    std::copy(dstStrides.begin(), dstStrides.end(), constant.dstStrides);
-    return constant;
-}
+VkShaderModule TensorCopyPipeline::createShaderModule(size_t elementSize) const {
+    // Copies move raw elements, so only the element size matters. Vectorized copies move uvec4 elements.
+    static const std::map<size_t, std::string> elementTypes = {
+        {1, "uint8_t"},
+        {2, "uint16_t"},
+        {4, "uint32_t"},
+        {8, "uint64_t"},
+        {static_cast<size_t>(tensor_arm_detail::copyVectorSize), "uvec4"},
+    };
+    const auto elementType = elementTypes.find(elementSize);
+    if (elementType == elementTypes.end()) {
+        throw std::runtime_error("Tensor element size not supported for copy: " + std::to_string(elementSize));
+    }
 
-VkShaderModule TensorCopyPipeline::createShaderModule(const TensorARM &srcTensor) const {
-    const auto srcType = std::string(getFormatInfo(srcTensor.getTensorInfo().format)->glslType);
     const std::lock_guard lock(cacheMutex);
-    auto &spirv = spirvCache[srcType];
+    auto &spirv = spirvCache[elementSize];
     if (spirv.empty()) {
         std::string tmp = glsl;
         replaceAll(tmp, "%warpX%", std::to_string(warp1D));
-        replaceAll(tmp, "%type%", srcType);
-        replaceAll(tmp, "%type_size%", std::to_string(vk::blockSize(vk::Format(srcTensor.getTensorInfo().format))));
+        replaceAll(tmp, "%type%", elementType->second);
+        replaceAll(tmp, "%type_size%", std::to_string(elementSize));
         spirv = glslToSpirv(tmp);
     }
 
@@ -248,76 +337,19 @@ VkShaderModule TensorCopyPipeline::createShaderModule(const TensorARM &srcTensor
     return vkShaderModule;
 }
 
-VkDescriptorPool TensorCopyPipeline::createDescriptorPool() const {
-    const VkDescriptorPoolSize poolSize = {
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // type
-        2,                                 // descriptor count
-    };
-
-    const VkDescriptorPoolCreateInfo createInfo = {
-        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,     // type
-        nullptr,                                           // next
-        VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, // flags
-        1,                                                 // max sets
-        1,                                                 // pool size count
-        &poolSize,                                         // pool size
-    };
-
-    VkDescriptorPool pool;
-    if (loader->vkCreateDescriptorPool(device, &createInfo, nullptr, &pool) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate descriptor pool");
-    }
-
-    return pool;
-}
-
-VkDescriptorSetLayout TensorCopyPipeline::createDescriptorSetLayout() const {
-    const std::vector<VkDescriptorSetLayoutBinding> bindings = {
-        {
-            0,                                 // binding
-            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // type
-            1,                                 // descriptor count
-            VK_SHADER_STAGE_COMPUTE_BIT,       // stage flags
-            nullptr,                           // VkSampler
-        },
-        {
-            1,                                 // binding
-            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // type
-            1,                                 // descriptor count
-            VK_SHADER_STAGE_COMPUTE_BIT,       // stage flags
-            nullptr,                           // VkSampler
-        },
-    };
-
-    const VkDescriptorSetLayoutCreateInfo createInfo = {
-        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, // type
-        nullptr,                                             // next
-        0,                                                   // flags
-        uint32_t(bindings.size()),                           // binding count
-        bindings.data(),                                     // bindings
-    };
-
-    VkDescriptorSetLayout layout;
-    if (loader->vkCreateDescriptorSetLayout(device, &createInfo, nullptr, &layout) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create descriptor set layout");
-    }
-
-    return layout;
-}
-
 VkPipelineLayout TensorCopyPipeline::createPipelineLayout() const {
     const VkPushConstantRange pushConstantRange = {
         VK_SHADER_STAGE_COMPUTE_BIT, // flags
         0,                           // offset
-        sizeof(pushConstant)         // size
+        sizeof(PushConstant)         // size
     };
 
     const VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, // type
         nullptr,                                       // next
         0,                                             // flags
-        1,                                             // layout count
-        &descriptorSetLayout,                          // layout
+        0,                                             // layout count
+        nullptr,                                       // layout
         1,                                             // push constant count
         &pushConstantRange,                            // push constants
     };
@@ -330,21 +362,7 @@ VkPipelineLayout TensorCopyPipeline::createPipelineLayout() const {
     return layout;
 }
 
-VkPipeline TensorCopyPipeline::createPipeline(const TensorARM &srcTensor) const {
-    const auto rank = static_cast<uint32_t>(srcTensor.getTensorInfo().dimensions.size());
-    const VkSpecializationMapEntry entry = {
-        0,               // constantID
-        0,               // offset
-        sizeof(uint32_t) // size
-    };
-
-    const VkSpecializationInfo specInfo = {
-        1,                // mapEntryCount
-        &entry,           // pMapEntries
-        sizeof(uint32_t), // dataSize
-        &rank             // pData
-    };
-
+VkPipeline TensorCopyPipeline::createPipeline() const {
     const VkPipelineShaderStageCreateInfo pipelineShaderCreateInfo = {
         VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, // type
         nullptr,                                             // next
@@ -352,7 +370,7 @@ VkPipeline TensorCopyPipeline::createPipeline(const TensorARM &srcTensor) const
         VK_SHADER_STAGE_COMPUTE_BIT,                         // stage flag bits
         shaderModule,                                        // shader module
         "main",                                              // name
-        &specInfo                                            // specialization info
+        nullptr                                              // specialization info
     };
 
     const VkComputePipelineCreateInfo computePipelineCreateInfo = {
@@ -374,75 +392,126 @@ VkPipeline TensorCopyPipeline::createPipeline(const TensorARM &srcTensor) const
     return vkPipeline;
 }
 
-VkDescriptorSet TensorCopyPipeline::createDescriptorSet(const TensorARM &srcTensor, const TensorARM &dstTensor) const {
-    const VkDescriptorSetAllocateInfo allocateInfo = {
-        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, // type
-        nullptr,                                        // next
-        descriptorPool,                                 // descriptor pool
-        1,                                              // descriptor set layout count
-        &descriptorSetLayout,                           // descriptor set layouts
-    };
+void TensorCopyPipeline::cmdDispatchCopy(VkCommandBuffer cmd, const PushConstant &pushConstant,
+                                         uint32_t elementCount) const {
+    loader->vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    loader->vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstant),
+                               &pushConstant);
+    loader->vkCmdDispatch(cmd, divideRoundUp(elementCount, warp1D), 1, 1);
+}
 
-    VkDescriptorSet vkDescriptorSet;
-    if (loader->vkAllocateDescriptorSets(device, &allocateInfo, &vkDescriptorSet) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate descriptor set");
+const std::string TensorCopyPipeline::glsl =
+#include "shaders/copy.comp"
+    ;
+
+/*******************************************************************************
+ * TensorCopyPipelineCache
+ *******************************************************************************/
+
+const TensorCopyPipeline &TensorCopyPipelineCache::get(const Device &dev, size_t elementSize) {
+    const std::lock_guard lock(mutex);
+    auto &pipeline = pipelines[elementSize];
+    if (!pipeline) {
+        pipeline = std::make_unique<TensorCopyPipeline>(dev, elementSize);
     }
+    return *pipeline;
+}
 
-    struct VkDescriptorBufferInfo srcBufferInfo = {
-        srcTensor.getTensorBuffer(), // buffer
-        0,                           // offset
-        VK_WHOLE_SIZE,               // range
-    };
+void TensorCopyPipelineCache::destroy() {
+    const std::lock_guard lock(mutex);
+    pipelines.clear();
+}
 
-    struct VkDescriptorBufferInfo dstBufferInfo = {
-        dstTensor.getTensorBuffer(), // buffer
-        0,                           // offset
-        VK_WHOLE_SIZE,               // range
-    };
+/*******************************************************************************
+ * TensorCopyRegionArena
+ *******************************************************************************/
+
+VkDeviceAddress TensorCopyRegionArena::allocate(const Device &dev, VkCommandBuffer commandBuffer, const void *data,
+                                                VkDeviceSize size) {
+    const std::lock_guard lock(mutex);
+
+    auto &chunks = usedChunks[commandBuffer];
+    if (chunks.empty() || chunks.back().used + size > chunks.back().size) {
+        auto chunk =
+            std::find_if(freeChunks.begin(), freeChunks.end(), [size](const auto &c) { return c.size >= size; });
+        if (chunk != freeChunks.end()) {
+            chunks.push_back(*chunk);
+            freeChunks.erase(chunk);
+        } else {
+            chunks.push_back(createChunk(dev, std::max(size, chunkSize)));
+        }
+    }
 
-    const std::vector<VkWriteDescriptorSet> write = {
-        {
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // type
-            nullptr,                                // next
-            vkDescriptorSet,                        // set
-            0,                                      // binding
-            0,                                      // array index
-            1,                                      // descriptor count
-            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,      // descriptor type
-            nullptr,                                // image info
-            &srcBufferInfo,                         // buffer info
-            nullptr,                                // texel buffer views
-        },
-        {
-            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, // type
-            nullptr,                                // next
-            vkDescriptorSet,                        // set
-            1,                                      // binding
-            0,                                      // array index
-            1,                                      // descriptor count
-            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,      // descriptor type
-            nullptr,                                // image info
-            &dstBufferInfo,                         // buffer info
-            nullptr,                                // texel buffer views
-        },
-    };
+    // The memory is host coherent, and host writes are visible to commands submitted afterwards
+    auto &chunk = chunks.back();
+    const auto offset = chunk.used;
+    std::memcpy(chunk.data + offset, data, size);
+    chunk.used = (offset + size + tableAlignment - 1) / tableAlignment * tableAlignment;
+    return chunk.address + offset;
+}
 
-    loader->vkUpdateDescriptorSets(device, uint32_t(write.size()), write.data(), 0, nullptr);
+void TensorCopyRegionArena::release(VkCommandBuffer commandBuffer) {
+    const std::lock_guard lock(mutex);
 
-    return vkDescriptorSet;
+    auto it = usedChunks.find(commandBuffer);
+    if (it == usedChunks.end()) {
+        return;
+    }
+    for (auto &chunk : it->second) {
+        chunk.used = 0;
+        freeChunks.push_back(chunk);
+    }
+    usedChunks.erase(it);
 }
 
-void TensorCopyPipeline::cmdBindAndDispatchCopy(VkCommandBuffer cmd, uint32_t regionCount) {
-    loader->vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
-    loader->vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstant),
-                               &pushConstant);
-    loader->vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0,
-                                    nullptr);
-    loader->vkCmdDispatch(cmd, divideRoundUp(regionCount, warp1D), 1, 1);
+void TensorCopyRegionArena::destroy(const Device &dev) {
+    const std::lock_guard lock(mutex);
+
+    for (const auto &[_, chunks] : usedChunks) {
+        freeChunks.insert(freeChunks.end(), chunks.begin(), chunks.end());
+    }
+    usedChunks.clear();
+    for (const auto &chunk : freeChunks) {
+        dev.loader->vkUnmapMemory(dev.device, chunk.memory);
+        dev.loader->vkDestroyBuffer(dev.device, chunk.buffer, dev.callbacks);
+        dev.loader->vkFreeMemory(dev.device, chunk.memory, dev.callbacks);
+    }
+    freeChunks.clear();
 }
 
-const std::string TensorCopyPipeline::glsl =
-#include "shaders/copy.comp"
-    ;
+TensorCopyRegionArena::Chunk TensorCopyRegionArena::createChunk(const Device &dev, VkDeviceSize size) const {
+    const VkBufferCreateInfo bufferCreateInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,                                           // type
+        nullptr,                                                                        // next
+        0,                                                                              // flags
+        size,                                                                           // size
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, // usage
+        VK_SHARING_MODE_EXCLUSIVE,                                                      // sharing mode
+        0,                                                                              // queue family count
+        nullptr,                                                                        // queue families
+    };
+
+    Chunk chunk;
+    chunk.size = size;
+    if (createHostVisibleBuffer(dev, bufferCreateInfo, dev.callbacks, chunk.buffer, chunk.memory,
+                                VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create tensor copy region table");
+    }
+
+    if (dev.loader->vkMapMemory(dev.device, chunk.memory, 0, VK_WHOLE_SIZE, 0,
+                                reinterpret_cast<void **>(&chunk.data)) != VK_SUCCESS) {
+        dev.loader->vkDestroyBuffer(dev.device, chunk.buffer, dev.callbacks);
+        dev.loader->vkFreeMemory(dev.device, chunk.memory, dev.callbacks);
+        throw std::runtime_error("Failed to map tensor copy region table");
+    }
+
+    const VkBufferDeviceAddressInfo addressInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, // type
+        nullptr,                                      // next
+        chunk.buffer,                                 // buffer
+    };
+    chunk.address = dev.loader->vkGetBufferDeviceAddress(dev.device, &addressInfo);
+    return chunk;
+}
 
 } // namespace mlsdk::el::layer
@@ -7,13 +7,20 @@
 #pragma once
 
 #include "mlel/vulkan_layer.hpp"
+#include "tensor_arm_detail.hpp"
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace mlsdk::el::layer {
 
-class TensorCopyPipeline;
+class TensorCopyPipelineCache;
+class TensorCopyRegionArena;
+class TensorDescriptor;
 
 class TensorARM {
   public:
@@ -44,6 +51,7 @@ class TensorARM {
 
     VkBuffer getTensorBuffer() const { return m_tensorBuffer; };
     const TensorInfo &getTensorInfo() const { return m_info; };
+    VkDeviceAddress getDeviceAddress() const { return m_deviceAddress; };
 
     VkResult create(const Device &dev, const VkTensorCreateInfoARM &createInfo, const VkAllocationCallbacks *allocator);
     void destroy(const Device &dev, const VkAllocationCallbacks *pAllocator);
@@ -52,51 +60,103 @@ class TensorARM {
                                                   VkMemoryRequirements2 *requirements);
     VkResult bindTensorMemory(const Device &dev, VkDeviceMemory memory, VkDeviceSize offset);
     void updateAliasedTensorInfo(const Device &dev, VkImage image);
-    void copyToTensor(CommandBuffer &cmd, const TensorARM &dstTensor);
+    void copyToTensor(CommandBuffer &cmd, TensorCopyPipelineCache &pipelineCache, TensorCopyRegionArena &regionArena,
+                      const TensorARM &dstTensor, uint32_t regionCount, const VkTensorCopyARM *regions) const;
     VkResult getOpaqueCaptureDescriptorDataEXT(const Device &dev, void *pData);
+    void addDescriptor(TensorDescriptor *descriptor);
+    void removeDescriptor(TensorDescriptor *descriptor);
 
   private:
     VkBuffer m_tensorBuffer = {};
     TensorInfo m_info;
-    std::shared_ptr<TensorCopyPipeline> m_copy_pipeline;
+    VkDeviceAddress m_deviceAddress = 0;
+
+    // Views may be created before the tensor is bound to memory, so the descriptor records of all views are rewritten
+    // whenever the address or the strides of the tensor change
+    std::mutex m_descriptorMutex;
+    std::vector<TensorDescriptor *> m_descriptors;
 };
 
 class TensorCopyPipeline {
   public:
-    TensorCopyPipeline(const std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> &_loader,
-                       VkDevice _device, const TensorARM &srcTensor, const TensorARM &dstTensor);
-    virtual ~TensorCopyPipeline();
-    void cmdBindAndDispatchCopy(VkCommandBuffer cmd, uint32_t regionCount);
-
-  private:
     struct PushConstant {
-        int64_t dimensions[TensorARM::TENSOR_MAX_DIMENSIONS];
-        uint64_t srcStrides[TensorARM::TENSOR_MAX_DIMENSIONS];
-        uint64_t dstStrides[TensorARM::TENSOR_MAX_DIMENSIONS];
+        VkDeviceAddress srcAddress;
+        VkDeviceAddress dstAddress;
+        VkDeviceAddress regionTableAddress;
+        uint32_t regionCount;
     };
 
-    VkDescriptorPool createDescriptorPool() const;
-    VkDescriptorSetLayout createDescriptorSetLayout() const;
-    VkDescriptorSet createDescriptorSet(const TensorARM &srcTensor, const TensorARM &dstTensor) const;
+    TensorCopyPipeline(const Device &dev, size_t elementSize);
+    virtual ~TensorCopyPipeline();
+    TensorCopyPipeline(const TensorCopyPipeline &) = delete;
+    TensorCopyPipeline &operator=(const TensorCopyPipeline &) = delete;
+
+    void cmdDispatchCopy(VkCommandBuffer cmd, const PushConstant &pushConstant, uint32_t elementCount) const;
+
+  private:
     VkPipelineLayout createPipelineLayout() const;
-    VkShaderModule createShaderModule(const TensorARM &srcTensor) const;
-    VkPipeline createPipeline(const TensorARM &srcTensor) const;
-    PushConstant createPushConstant(const TensorARM &srcTensor, const TensorARM &dstTensor) const;
+    VkShaderModule createShaderModule(size_t elementSize) const;
+    VkPipeline createPipeline() const;
 
     std::shared_ptr<VULKAN_HPP_NAMESPACE::detail::DispatchLoaderDynamic> loader;
     VkDevice device;
-    PushConstant pushConstant;
-    VkShaderModule shaderModule;
-    VkDescriptorPool descriptorPool;
-    VkDescriptorSetLayout descriptorSetLayout;
     VkPipelineLayout pipelineLayout;
+    VkShaderModule shaderModule;
     VkPipeline pipeline;
-    VkDescriptorSet descriptorSet;
 
     static const uint32_t warp1D = 128;
     static const std::string glsl;
     static inline std::mutex cacheMutex;
-    static inline std::unordered_map<std::string, std::vector<uint32_t>> spirvCache;
+    static inline std::unordered_map<size_t, std::vector<uint32_t>> spirvCache;
+};
+
+/**
+ * Copy pipelines of a device, created on first use for each element size and kept until the device is destroyed.
+ * Tensors are passed as buffer device addresses and the rank of each region comes from the region table, so a
+ * pipeline serves any pair of tensors.
+ */
+class TensorCopyPipelineCache {
+  public:
+    const TensorCopyPipeline &get(const Device &dev, size_t elementSize);
+    void destroy();
+
+  private:
+    std::mutex mutex;
+    std::map<size_t, std::unique_ptr<TensorCopyPipeline>> pipelines;
+};
+
+/**
+ * Host visible memory for the region tables of tensor copies. Tables are bump allocated from chunks owned by the
+ * command buffer they are recorded into, and the chunks are recycled once the command buffer is reset or freed.
+ */
+class TensorCopyRegionArena {
+  public:
+    TensorCopyRegionArena() = default;
+    TensorCopyRegionArena(const TensorCopyRegionArena &) = delete;
+    TensorCopyRegionArena &operator=(const TensorCopyRegionArena &) = delete;
+
+    VkDeviceAddress allocate(const Device &dev, VkCommandBuffer commandBuffer, const void *data, VkDeviceSize size);
+    void release(VkCommandBuffer commandBuffer);
+    void destroy(const Device &dev);
+
+  private:
+    struct Chunk {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint8_t *data = nullptr;
+        VkDeviceAddress address = 0;
+        VkDeviceSize size = 0;
+        VkDeviceSize used = 0;
+    };
+
+    Chunk createChunk(const Device &dev, VkDeviceSize size) const;
+
+    static constexpr VkDeviceSize chunkSize = 64 * 1024;
+    static constexpr VkDeviceSize tableAlignment = 16;
+
+    std::mutex mutex;
+    std::vector<Chunk> freeChunks;
+    std::map<VkCommandBuffer, std::vector<Chunk>> usedChunks;
 };
 
 } // namespace mlsdk::el::layer
@@ -8,7 +8,15 @@
 
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <vector>
 
 namespace mlsdk::el::layer::tensor_arm_detail {
@@ -29,4 +37,255 @@ inline void updateAliasedStrides(const std::size_t rank, std::vector<int64_t> &s
     }
 }
 
+/*******************************************************************************
+ * Tensor copy
+ *******************************************************************************/
+
+constexpr size_t copyMaxRank = 6;
+
+// Bytes moved per invocation by the vectorized copy shader
+constexpr int64_t copyVectorSize = 16;
+
+struct CopyRegion {
+    std::vector<int64_t> srcOffset;
+    std::vector<int64_t> dstOffset;
+    std::vector<int64_t> extent;
+};
+
+/**
+ * One entry of the region table read by shaders/copy.comp. Offsets and strides are in elements of the shader, and
+ * firstElement is the index of the first invocation copying the region. Only the innermost rank dimensions are used,
+ * aligned to the end of the arrays.
+ */
+struct CopyRegionEntry {
+    uint32_t firstElement;
+    uint32_t srcOffset;
+    uint32_t dstOffset;
+    uint32_t rank;
+    uint32_t extent[copyMaxRank];
+    uint32_t srcStrides[copyMaxRank];
+    uint32_t dstStrides[copyMaxRank];
+};
+
+struct CopyDispatch {
+    std::vector<CopyRegionEntry> regions;
+    uint32_t elementCount = 0;
+};
+
+struct CopyPlan {
+    // Regions contiguous in both tensors
+    std::vector<VkBufferCopy> bufferCopies;
+    // Regions copied by the shader one tensor element per invocation
+    CopyDispatch elementCopies;
+    // Regions copied by the shader copyVectorSize bytes per invocation
+    CopyDispatch vectorCopies;
+};
+
+/**
+ * A dimension of a copy region, with strides in bytes.
+ */
+struct CopyDimension {
+    int64_t extent;
+    int64_t srcStride;
+    int64_t dstStride;
+};
+
+/**
+ * Drop the dimensions of extent 1 and merge adjacent dimensions that are contiguous in both tensors. The result is
+ * ordered from the outermost to the innermost dimension and is never empty.
+ */
+inline std::vector<CopyDimension> collapseCopyDimensions(const std::vector<int64_t> &extent,
+                                                         const std::vector<int64_t> &srcStrides,
+                                                         const std::vector<int64_t> &dstStrides) {
+    std::vector<CopyDimension> dimensions;
+    for (size_t i = extent.size(); i > 0; i--) {
+        const CopyDimension dimension{extent[i - 1], srcStrides[i - 1], dstStrides[i - 1]};
+        if (dimension.extent == 1) {
+            continue;
+        }
+        auto *inner = dimensions.empty() ? nullptr : &dimensions.back();
+        if (inner != nullptr && dimension.srcStride == inner->srcStride * inner->extent &&
+            dimension.dstStride == inner->dstStride * inner->extent) {
+            inner->extent *= dimension.extent;
+        } else {
+            dimensions.push_back(dimension);
+        }
+    }
+    if (dimensions.empty()) {
+        dimensions.push_back({1, 0, 0});
+    }
+    std::reverse(dimensions.begin(), dimensions.end());
+    return dimensions;
+}
+
+inline uint32_t toCopyIndex(int64_t value) {
+    // The copy shader indexes elements with 32-bit integers
+    if (value < 0 || value >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Tensor copy index out of range: " + std::to_string(value));
+    }
+    return static_cast<uint32_t>(value);
+}
+
+inline void addCopyRegion(CopyDispatch &dispatch, const std::vector<CopyDimension> &dimensions, int64_t srcByteOffset,
+                          int64_t dstByteOffset, int64_t unitSize) {
+    const auto toUnits = [unitSize](int64_t bytes) {
+        if (bytes % unitSize != 0) {
+            throw std::runtime_error("Tensor strides not supported for copy.");
+        }
+        return toCopyIndex(bytes / unitSize);
+    };
+
+    CopyRegionEntry entry{dispatch.elementCount, toUnits(srcByteOffset), toUnits(dstByteOffset),
+                          static_cast<uint32_t>(dimensions.size()), {}, {}, {}};
+    int64_t count = 1;
+    for (size_t i = 0; i < dimensions.size(); i++) {
+        const auto j = copyMaxRank - dimensions.size() + i;
+        entry.extent[j] = toCopyIndex(dimensions[i].extent);
+        entry.srcStrides[j] = toUnits(dimensions[i].srcStride);
+        entry.dstStrides[j] = toUnits(dimensions[i].dstStride);
+        count *= dimensions[i].extent;
+    }
+    dispatch.elementCount = toCopyIndex(int64_t{dispatch.elementCount} + count);
+    dispatch.regions.push_back(entry);
+}
+
+/**
+ * Split the regions of a tensor copy into buffer copies and shader copies.
+ *
+ * Regions that are contiguous in both tensors become buffer copy ranges, merged when consecutive. The remaining
+ * regions are listed in region tables so the shader copies them with one dispatch per table. Regions whose innermost
+ * run is contiguous and aligned to copyVectorSize bytes in both tensors are copied as vectors, provided the tensors
+ * themselves are aligned as given by isVectorAligned.
+ */
+inline CopyPlan planCopy(int64_t elementSize, const std::vector<int64_t> &srcDimensions,
+                         const std::vector<int64_t> &srcStrides, const std::vector<int64_t> &dstDimensions,
+                         const std::vector<int64_t> &dstStrides, const std::vector<CopyRegion> &regions,
+                         bool isVectorAligned = false) {
+    const auto rank = srcDimensions.size();
+    if (rank == 0 || rank > copyMaxRank || dstDimensions.size() != rank) {
+        throw std::runtime_error("Src tensor and dst tensor should have the same rank.");
+    }
+
+    CopyPlan plan;
+    for (const auto &region : regions) {
+        if (region.srcOffset.size() != rank || region.dstOffset.size() != rank || region.extent.size() != rank) {
+            throw std::runtime_error("Tensor copy region should have the same rank as the tensors.");
+        }
+
+        int64_t srcByteOffset = 0;
+        int64_t dstByteOffset = 0;
+        bool isEmpty = false;
+        for (size_t i = 0; i < rank; i++) {
+            const auto extent = region.extent[i];
+            if (extent < 0 || region.srcOffset[i] < 0 || region.dstOffset[i] < 0 ||
+                region.srcOffset[i] + extent > srcDimensions[i] || region.dstOffset[i] + extent > dstDimensions[i]) {
+                throw std::runtime_error("Tensor copy region out of bounds.");
+            }
+            isEmpty = isEmpty || extent == 0;
+            srcByteOffset += region.srcOffset[i] * srcStrides[i];
+            dstByteOffset += region.dstOffset[i] * dstStrides[i];
+        }
+        if (isEmpty) {
+            continue;
+        }
+
+        auto dimensions = collapseCopyDimensions(region.extent, srcStrides, dstStrides);
+        auto &inner = dimensions.back();
+        const bool isInnerContiguous =
+            inner.extent == 1 || (inner.srcStride == elementSize && inner.dstStride == elementSize);
+
+        if (dimensions.size() == 1 && isInnerContiguous) {
+            const auto size = static_cast<VkDeviceSize>(inner.extent * elementSize);
+            const auto srcStart = static_cast<VkDeviceSize>(srcByteOffset);
+            const auto dstStart = static_cast<VkDeviceSize>(dstByteOffset);
+            auto *previous = plan.bufferCopies.empty() ? nullptr : &plan.bufferCopies.back();
+            if (previous != nullptr && previous->srcOffset + previous->size == srcStart &&
+                previous->dstOffset + previous->size == dstStart) {
+                previous->size += size;
+            } else {
+                plan.bufferCopies.push_back({srcStart, dstStart, size});
+            }
+            continue;
+        }
+
+        // Every vector must start on a vector boundary in both tensors
+        const auto innerBytes = inner.extent * elementSize;
+        bool isVector = isVectorAligned && isInnerContiguous && innerBytes % copyVectorSize == 0 &&
+                        srcByteOffset % copyVectorSize == 0 && dstByteOffset % copyVectorSize == 0;
+        for (size_t i = 0; i + 1 < dimensions.size(); i++) {
+            isVector = isVector && dimensions[i].srcStride % copyVectorSize == 0 &&
+                       dimensions[i].dstStride % copyVectorSize == 0;
+        }
+
+        if (isVector) {
+            inner = {innerBytes / copyVectorSize, copyVectorSize, copyVectorSize};
+            addCopyRegion(plan.vectorCopies, dimensions, srcByteOffset, dstByteOffset, copyVectorSize);
+        } else {
+            addCopyRegion(plan.elementCopies, dimensions, srcByteOffset, dstByteOffset, elementSize);
+        }
+    }
+
+    return plan;
+}
+
+/*******************************************************************************
+ * Tensor barriers
+ *******************************************************************************/
+
+/**
+ * Replaces every group of at least threshold buffer barriers with identical stage and access masks, and no queue family
+ * ownership transfer, by one global memory barrier with the same masks. Drivers walk buffer barriers one by one, while
+ * a memory barrier costs the same regardless of how many tensors it covers. A threshold of 0 disables coalescing.
+ * Scratch containers use the allocator of bufferBarriers.
+ */
+template <typename BufferBarriers, typename MemoryBarriers>
+void coalesceBufferBarriers(BufferBarriers &bufferBarriers, MemoryBarriers &memoryBarriers, size_t threshold) {
+    if (threshold == 0 || bufferBarriers.size() < threshold) {
+        return;
+    }
+
+    using Key = std::tuple<VkPipelineStageFlags2, VkAccessFlags2, VkPipelineStageFlags2, VkAccessFlags2>;
+    const auto getKey = [](const VkBufferMemoryBarrier2 &barrier) {
+        return Key{barrier.srcStageMask, barrier.srcAccessMask, barrier.dstStageMask, barrier.dstAccessMask};
+    };
+    const auto isCoalescable = [](const VkBufferMemoryBarrier2 &barrier) {
+        return barrier.srcQueueFamilyIndex == barrier.dstQueueFamilyIndex;
+    };
+
+    using GroupAllocator = typename std::allocator_traits<
+        typename BufferBarriers::allocator_type>::template rebind_alloc<std::pair<const Key, size_t>>;
+    std::map<Key, size_t, std::less<Key>, GroupAllocator> groupSizes{GroupAllocator{bufferBarriers.get_allocator()}};
+    for (const auto &barrier : bufferBarriers) {
+        if (isCoalescable(barrier)) {
+            groupSizes[getKey(barrier)]++;
+        }
+    }
+
+    BufferBarriers remaining{bufferBarriers.get_allocator()};
+    remaining.reserve(bufferBarriers.size());
+    for (const auto &barrier : bufferBarriers) {
+        if (!isCoalescable(barrier) || groupSizes[getKey(barrier)] < threshold) {
+            remaining.push_back(barrier);
+        }
+    }
+    if (remaining.size() == bufferBarriers.size()) {
+        return;
+    }
+
+    for (const auto &[key, size] : groupSizes) {
+        if (size >= threshold) {
+            const auto &[srcStageMask, srcAccessMask, dstStageMask, dstAccessMask] = key;
+            memoryBarriers.push_back(VkMemoryBarrier2{
+                VK_STRUCTURE_TYPE_MEMORY_BARRIER_2, // sType
+                nullptr,                            // pNext
+                srcStageMask,                       // srcStageMask
+                srcAccessMask,                      // srcAccessMask
+                dstStageMask,                       // dstStageMask
+                dstAccessMask                       // dstAccessMask
+            });
+        }
+    }
+    bufferBarriers = std::move(remaining);
+}
+
 } // namespace mlsdk::el::layer::tensor_arm_detail
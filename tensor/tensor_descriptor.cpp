@@ -6,96 +6,161 @@
 
 #include "tensor_descriptor.hpp"
 
+#include <algorithm>
+
 namespace mlsdk::el::layer {
 
-VkResult TensorDescriptor::create(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
-                                  const VkAllocationCallbacks *allocator) {
-    VkResult result;
-    // create buffer
-    const auto *pCaptureDescriptorInfo = findType<VkOpaqueCaptureDescriptorDataCreateInfoEXT>(
-        createInfo->pNext, VK_STRUCTURE_TYPE_OPAQUE_CAPTURE_DESCRIPTOR_DATA_CREATE_INFO_EXT);
-    VkBufferCreateFlags flags = (createInfo->flags & VK_TENSOR_VIEW_CREATE_DESCRIPTOR_BUFFER_CAPTURE_REPLAY_BIT_ARM)
-                                    ? VK_BUFFER_CREATE_DESCRIPTOR_BUFFER_CAPTURE_REPLAY_BIT_EXT
-                                    : 0;
-    const VkBufferCreateInfo bufferCreateInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        pCaptureDescriptorInfo,
-        flags,
-        sizeof(DescriptorBuffer),
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VK_SHARING_MODE_EXCLUSIVE,
-        0,
-        nullptr,
-    };
-    result = dev.loader->vkCreateBuffer(dev.device, &bufferCreateInfo, allocator, &m_buffer);
+namespace {
+uint32_t findMemoryType(const Device &dev, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    dev.loader->vkGetPhysicalDeviceMemoryProperties(dev.physicalDevice->physicalDevice, &memoryProperties);
+
+    uint32_t memoryTypeIndex = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        auto propertyFlags = memoryProperties.memoryTypes[i].propertyFlags;
+        if (((1U << i) & typeFilter) && (propertyFlags & properties)) {
+            memoryTypeIndex = i;
+            break;
+        }
+    }
+    return memoryTypeIndex;
+}
+} // namespace
+
+VkResult createHostVisibleBuffer(const Device &dev, const VkBufferCreateInfo &bufferCreateInfo,
+                                 const VkAllocationCallbacks *allocator, VkBuffer &buffer, VkDeviceMemory &memory,
+                                 VkMemoryAllocateFlags allocateFlags) {
+    VkResult result = dev.loader->vkCreateBuffer(dev.device, &bufferCreateInfo, allocator, &buffer);
     if (result != VK_SUCCESS) {
         return result;
     }
-    // allocate memory
+
     VkMemoryRequirements memoryRequirements;
-    dev.loader->vkGetBufferMemoryRequirements(dev.device, m_buffer, &memoryRequirements);
+    dev.loader->vkGetBufferMemoryRequirements(dev.device, buffer, &memoryRequirements);
     uint32_t memoryTypeIndex =
         findMemoryType(dev, memoryRequirements.memoryTypeBits,
                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
+    const VkMemoryAllocateFlagsInfo allocFlagsInfo = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+        nullptr,
+        allocateFlags,
+        0,
+    };
     const VkMemoryAllocateInfo allocInfo = {
         VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        nullptr,
+        allocateFlags != 0 ? &allocFlagsInfo : nullptr,
         memoryRequirements.size,
         memoryTypeIndex,
     };
-    result = dev.loader->vkAllocateMemory(dev.device, &allocInfo, allocator, &m_memory);
+    result = dev.loader->vkAllocateMemory(dev.device, &allocInfo, allocator, &memory);
     if (result != VK_SUCCESS) {
-        dev.loader->vkDestroyBuffer(dev.device, m_buffer, allocator);
+        dev.loader->vkDestroyBuffer(dev.device, buffer, allocator);
+        buffer = VK_NULL_HANDLE;
         return result;
     }
-    result = dev.loader->vkBindBufferMemory(dev.device, m_buffer, m_memory, 0);
+
+    result = dev.loader->vkBindBufferMemory(dev.device, buffer, memory, 0);
+    if (result != VK_SUCCESS) {
+        dev.loader->vkDestroyBuffer(dev.device, buffer, allocator);
+        dev.loader->vkFreeMemory(dev.device, memory, allocator);
+        buffer = VK_NULL_HANDLE;
+        memory = VK_NULL_HANDLE;
+    }
     return result;
 }
 
-VkBuffer TensorDescriptor::getTensorDescriptorBuffer(const Device &dev, VkTensorARM tensorHandle) {
-    auto *tensor = reinterpret_cast<TensorARM *>(tensorHandle);
-    const auto &info = tensor->getTensorInfo();
+/*******************************************************************************
+ * TensorDescriptor
+ *******************************************************************************/
+
+VkResult TensorDescriptor::create(const Device &dev, TensorDescriptorArena &arena,
+                                  const VkTensorViewCreateInfoARM *createInfo, const VkAllocationCallbacks *allocator) {
+    // Descriptor capture and replay needs the buffer to be created with the captured data, so such views cannot
+    // share a slab
+    if (createInfo->flags & VK_TENSOR_VIEW_CREATE_DESCRIPTOR_BUFFER_CAPTURE_REPLAY_BIT_ARM) {
+        return createDedicatedBuffer(dev, createInfo, allocator);
+    }
 
-    DescriptorBuffer *descriptor;
-    VkResult result =
-        dev.loader->vkMapMemory(dev.device, m_memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void **>(&descriptor));
+    TensorDescriptorArena::Allocation allocation;
+    VkResult result = arena.allocate(dev, allocation);
     if (result != VK_SUCCESS) {
-        return VK_NULL_HANDLE;
+        return result;
     }
 
-    const VkBufferDeviceAddressInfo addressInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+    m_arena = &arena;
+    m_buffer = allocation.buffer;
+    m_offset = allocation.offset;
+    m_record = allocation.descriptor;
+
+    // The tensor writes the record now and again once it is bound to memory, if the view is created before that
+    m_tensor = reinterpret_cast<TensorARM *>(createInfo->tensor);
+    m_tensor->addDescriptor(this);
+    return VK_SUCCESS;
+}
+
+VkResult TensorDescriptor::createDedicatedBuffer(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
+                                                 const VkAllocationCallbacks *allocator) {
+    const auto *pCaptureDescriptorInfo = findType<VkOpaqueCaptureDescriptorDataCreateInfoEXT>(
+        createInfo->pNext, VK_STRUCTURE_TYPE_OPAQUE_CAPTURE_DESCRIPTOR_DATA_CREATE_INFO_EXT);
+    const VkBufferCreateInfo bufferCreateInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        pCaptureDescriptorInfo,
+        VK_BUFFER_CREATE_DESCRIPTOR_BUFFER_CAPTURE_REPLAY_BIT_EXT,
+        sizeof(DescriptorBuffer),
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
         nullptr,
-        tensor->getTensorBuffer(),
     };
+    VkResult result = createHostVisibleBuffer(dev, bufferCreateInfo, allocator, m_buffer, m_memory);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
 
-    descriptor->address = dev.loader->vkGetBufferDeviceAddress(dev.device, &addressInfo);
-    std::copy(info.dimensions.begin(), info.dimensions.end(), descriptor->dimensions);
-    std::copy(info.strides.begin(), info.strides.end(), descriptor->strides);
-
-    dev.loader->vkUnmapMemory(dev.device, m_memory);
+    // The memory stays mapped until the view is destroyed, like the slabs of the arena
+    result = dev.loader->vkMapMemory(dev.device, m_memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void **>(&m_record));
+    if (result != VK_SUCCESS) {
+        destroy(dev, allocator);
+        return result;
+    }
 
-    return m_buffer;
+    m_tensor = reinterpret_cast<TensorARM *>(createInfo->tensor);
+    m_tensor->addDescriptor(this);
+    return VK_SUCCESS;
 }
 
-uint32_t TensorDescriptor::findMemoryType(const Device &dev, uint32_t typeFilter,
-                                          VkMemoryPropertyFlags properties) const {
-    VkPhysicalDeviceMemoryProperties memoryProperties;
-    dev.loader->vkGetPhysicalDeviceMemoryProperties(dev.physicalDevice->physicalDevice, &memoryProperties);
+void TensorDescriptor::writeRecord(const TensorARM &tensor) {
+    const auto &info = tensor.getTensorInfo();
 
-    uint32_t memoryTypeIndex = 0;
-    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
-        auto propertyFlags = memoryProperties.memoryTypes[i].propertyFlags;
-        if (((1U << i) & typeFilter) && (propertyFlags & properties)) {
-            memoryTypeIndex = i;
-            break;
-        }
-    }
-    return memoryTypeIndex;
+    // An unbound tensor has no address yet, the record is written again when it is bound
+    m_record->address = tensor.getDeviceAddress();
+    std::copy(info.dimensions.begin(), info.dimensions.end(), m_record->dimensions);
+    std::copy(info.strides.begin(), info.strides.end(), m_record->strides);
+}
+
+VkDescriptorBufferInfo TensorDescriptor::getDescriptorBufferInfo() const {
+    return {
+        m_buffer,                 // buffer
+        m_offset,                 // offset
+        sizeof(DescriptorBuffer), // range
+    };
 }
 
 void TensorDescriptor::destroy(const Device &dev, const VkAllocationCallbacks *pAllocator) {
+    if (m_tensor != nullptr) {
+        m_tensor->removeDescriptor(this);
+        m_tensor = nullptr;
+    }
+    m_record = nullptr;
+
+    if (m_arena != nullptr) {
+        m_arena->release(m_buffer, m_offset);
+        m_arena = nullptr;
+        m_buffer = VK_NULL_HANDLE;
+        return;
+    }
+
     if (m_buffer != VK_NULL_HANDLE) {
         dev.loader->vkDestroyBuffer(dev.device, m_buffer, pAllocator);
         m_buffer = VK_NULL_HANDLE;
@@ -106,4 +171,91 @@ void TensorDescriptor::destroy(const Device &dev, const VkAllocationCallbacks *p
     }
 }
 
+/*******************************************************************************
+ * TensorDescriptorArena
+ *******************************************************************************/
+
+VkResult TensorDescriptorArena::allocate(const Device &dev, Allocation &allocation) {
+    std::lock_guard lock(mutex);
+
+    auto slab = std::find_if(slabs.rbegin(), slabs.rend(), [](const auto &s) { return !s.freeOffsets.empty(); });
+    if (slab == slabs.rend()) {
+        VkResult result = createSlab(dev);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        slab = slabs.rbegin();
+    }
+
+    allocation.buffer = slab->buffer;
+    allocation.offset = slab->freeOffsets.back();
+    allocation.descriptor = reinterpret_cast<TensorDescriptor::DescriptorBuffer *>(slab->data + allocation.offset);
+    slab->freeOffsets.pop_back();
+    return VK_SUCCESS;
+}
+
+void TensorDescriptorArena::release(VkBuffer buffer, VkDeviceSize offset) {
+    std::lock_guard lock(mutex);
+
+    auto slab = std::find_if(slabs.begin(), slabs.end(), [buffer](const auto &s) { return s.buffer == buffer; });
+    if (slab != slabs.end()) {
+        slab->freeOffsets.push_back(offset);
+    }
+}
+
+VkResult TensorDescriptorArena::createSlab(const Device &dev) {
+    if (recordStride == 0) {
+        VkPhysicalDeviceProperties properties;
+        dev.loader->vkGetPhysicalDeviceProperties(dev.physicalDevice->physicalDevice, &properties);
+        const auto alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+        recordStride = (sizeof(TensorDescriptor::DescriptorBuffer) + alignment - 1) / alignment * alignment;
+    }
+
+    const VkBufferCreateInfo bufferCreateInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        nullptr,
+        0,
+        recordStride * recordsPerSlab,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        nullptr,
+    };
+
+    Slab slab;
+    VkResult result = createHostVisibleBuffer(dev, bufferCreateInfo, dev.callbacks, slab.buffer, slab.memory);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    // The slab stays mapped until the device is destroyed, records are written through this pointer
+    result = dev.loader->vkMapMemory(dev.device, slab.memory, 0, VK_WHOLE_SIZE, 0,
+                                     reinterpret_cast<void **>(&slab.data));
+    if (result != VK_SUCCESS) {
+        dev.loader->vkDestroyBuffer(dev.device, slab.buffer, dev.callbacks);
+        dev.loader->vkFreeMemory(dev.device, slab.memory, dev.callbacks);
+        return result;
+    }
+
+    // Hand out the lowest offsets first
+    slab.freeOffsets.reserve(recordsPerSlab);
+    for (VkDeviceSize i = recordsPerSlab; i > 0; i--) {
+        slab.freeOffsets.push_back((i - 1) * recordStride);
+    }
+
+    slabs.push_back(std::move(slab));
+    return VK_SUCCESS;
+}
+
+void TensorDescriptorArena::destroy(const Device &dev) {
+    std::lock_guard lock(mutex);
+
+    for (auto &slab : slabs) {
+        dev.loader->vkUnmapMemory(dev.device, slab.memory);
+        dev.loader->vkDestroyBuffer(dev.device, slab.buffer, dev.callbacks);
+        dev.loader->vkFreeMemory(dev.device, slab.memory, dev.callbacks);
+    }
+    slabs.clear();
+}
+
 } // namespace mlsdk::el::layer
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2023-2025 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-FileCopyrightText: Copyright 2023-2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
  * SPDX-License-Identifier: Apache-2.0
  *
  */
@@ -10,8 +10,20 @@
 #include "tensor_arm.hpp"
 #include <vulkan/vulkan.hpp>
 
+#include <mutex>
+#include <vector>
+
 namespace mlsdk::el::layer {
 
+class TensorDescriptorArena;
+
+/**
+ * Create a buffer bound to a dedicated host visible and coherent allocation.
+ */
+VkResult createHostVisibleBuffer(const Device &dev, const VkBufferCreateInfo &bufferCreateInfo,
+                                 const VkAllocationCallbacks *allocator, VkBuffer &buffer, VkDeviceMemory &memory,
+                                 VkMemoryAllocateFlags allocateFlags = 0);
+
 class TensorDescriptor {
     template <typename T, size_t ALIGN> struct alignas(ALIGN) AlignAs {
         T v;
@@ -31,14 +43,66 @@ class TensorDescriptor {
     TensorDescriptor(const TensorDescriptor &) = delete;
     TensorDescriptor &operator=(const TensorDescriptor &) = delete;
 
-    VkResult create(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
+    VkResult create(const Device &dev, TensorDescriptorArena &arena, const VkTensorViewCreateInfoARM *createInfo,
                     const VkAllocationCallbacks *allocator);
     void destroy(const Device &dev, const VkAllocationCallbacks *pAllocator);
-    VkBuffer getTensorDescriptorBuffer(const Device &dev, VkTensorARM tensorHandle);
+    VkDescriptorBufferInfo getDescriptorBufferInfo() const;
+
+    /// Write the record from the current address and strides of the tensor, called by the tensor holding its lock.
+    void writeRecord(const TensorARM &tensor);
+    /// Stop referring to the tensor, which is being destroyed.
+    void releaseTensor() { m_tensor = nullptr; }
 
   private:
-    uint32_t findMemoryType(const Device &dev, uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    VkResult createDedicatedBuffer(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
+                                   const VkAllocationCallbacks *allocator);
+
+    // Views created for descriptor buffer capture and replay need a buffer of their own, all other views share a slab
+    // of the device arena
     VkDeviceMemory m_memory = VK_NULL_HANDLE;
     VkBuffer m_buffer = VK_NULL_HANDLE;
+    VkDeviceSize m_offset = 0;
+    TensorDescriptorArena *m_arena = nullptr;
+    // Mapped record, written again by the tensor when it is bound to memory or its strides change
+    DescriptorBuffer *m_record = nullptr;
+    TensorARM *m_tensor = nullptr;
+};
+
+/**
+ * Suballocates tensor descriptor records from large, persistently mapped, host visible uniform buffers. Each record
+ * is bound through the offset and range of its VkDescriptorBufferInfo.
+ */
+class TensorDescriptorArena {
+  public:
+    struct Allocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        TensorDescriptor::DescriptorBuffer *descriptor = nullptr;
+    };
+
+    TensorDescriptorArena() = default;
+    TensorDescriptorArena(const TensorDescriptorArena &) = delete;
+    TensorDescriptorArena &operator=(const TensorDescriptorArena &) = delete;
+
+    VkResult allocate(const Device &dev, Allocation &allocation);
+    void release(VkBuffer buffer, VkDeviceSize offset);
+    void destroy(const Device &dev);
+
+  private:
+    struct Slab {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint8_t *data = nullptr;
+        std::vector<VkDeviceSize> freeOffsets;
+    };
+
+    VkResult createSlab(const Device &dev);
+
+    static constexpr VkDeviceSize recordsPerSlab = 256;
+
+    std::mutex mutex;
+    std::vector<Slab> slabs;
+    VkDeviceSize recordStride = 0;
 };
+
 } // namespace mlsdk::el::layer
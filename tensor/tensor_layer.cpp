@@ -8,15 +8,24 @@
  * Includes
  *******************************************************************************/
 
+#include "mlel/host_timer.hpp"
+#include "mlel/utils.hpp"
 #include "mlel/vulkan_layer.hpp"
 
 #include "descriptor_binding.hpp"
+#include "shader_disk_cache.hpp"
+#include "shader_rewrite_cache.hpp"
+#include "spirv_pass_tensor_buffer.hpp"
 #include "tensor_arm.hpp"
 #include "tensor_log.hpp"
 #include "tensor_processor.hpp"
 #include "tensor_view.hpp"
 #include "version.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <variant>
@@ -38,9 +47,38 @@ class TensorDevice : public Device {
     TensorDevice(const std::shared_ptr<PhysicalDevice> &_physicalDevice, VkDevice _device,
                  PFN_vkGetInstanceProcAddr _gipr, PFN_vkGetDeviceProcAddr _gdpr,
                  const VkAllocationCallbacks *_callbacks)
-        : Device(_physicalDevice, _device, _gipr, _gdpr, _callbacks) {}
+        : Device(_physicalDevice, _device, _gipr, _gdpr, _callbacks) {
+        if (utils::isTruthyEnvironmentValue(std::getenv("VMEL_TENSOR_PROFILING"))) {
+            // Only the histograms are reported, so no events are kept
+            hostTimers = std::make_unique<utils::HostTimerRegistry>(0);
+        }
+    }
+
+    ~TensorDevice() {
+        descriptorArena.destroy(*this);
+        copyPipelineCache.destroy();
+        copyRegionArena.destroy(*this);
+
+        if (!hostTimers) {
+            return;
+        }
+
+        for (const auto &[phase, histogram] : hostTimers->getHistograms()) {
+            tensorLog(Severity::Info) << "Host phase " << phase << ": count=" << histogram.count
+                                      << " total_us=" << histogram.totalNanoseconds / 1000
+                                      << " min_us=" << histogram.minNanoseconds / 1000
+                                      << " max_us=" << histogram.maxNanoseconds / 1000
+                                      << " p50_us=" << histogram.percentile(0.50) / 1000
+                                      << " p95_us=" << histogram.percentile(0.95) / 1000
+                                      << " p99_us=" << histogram.percentile(0.99) / 1000 << std::endl;
+        }
+    }
 
     bool uniformBufferUpdateAfterBindEnabled = false;
+    std::unique_ptr<utils::HostTimerRegistry> hostTimers;
+    TensorDescriptorArena descriptorArena;
+    TensorCopyPipelineCache copyPipelineCache;
+    TensorCopyRegionArena copyRegionArena;
 };
 
 /*******************************************************************************
@@ -137,6 +175,13 @@ class TensorLayer : public VulkanLayerImpl {
             {"vkGetTensorViewOpaqueCaptureDescriptorDataARM",
              PFN_vkVoidFunction(vkGetTensorViewOpaqueCaptureDescriptorDataARM)},
 
+            // Command buffer
+            {"vkBeginCommandBuffer", PFN_vkVoidFunction(vkBeginCommandBuffer)},
+            {"vkResetCommandBuffer", PFN_vkVoidFunction(vkResetCommandBuffer)},
+            {"vkFreeCommandBuffers", PFN_vkVoidFunction(vkFreeCommandBuffers)},
+            {"vkResetCommandPool", PFN_vkVoidFunction(vkResetCommandPool)},
+            {"vkDestroyCommandPool", PFN_vkVoidFunction(vkDestroyCommandPool)},
+
             // Shader
             {"vkCreateShaderModule", PFN_vkVoidFunction(vkCreateShaderModule)},
 
@@ -243,8 +288,9 @@ class TensorLayer : public VulkanLayerImpl {
     static VkResult VKAPI_CALL vkCreateTensorViewARM(VkDevice device, const VkTensorViewCreateInfoARM *createInfo,
                                                      const VkAllocationCallbacks *allocator,
                                                      VkTensorViewARM *tensorView) {
+        auto handle = VulkanLayerImpl::getHandle(device);
         auto *tensorViewARM = allocateObject<TensorViewARM>(allocator);
-        VkResult result = tensorViewARM->create(*VulkanLayerImpl::getHandle(device), createInfo, allocator);
+        VkResult result = tensorViewARM->create(*handle, handle->descriptorArena, createInfo, allocator);
         if (result != VK_SUCCESS) {
             destroyObject(allocator, tensorViewARM);
             return result;
@@ -300,10 +346,69 @@ class TensorLayer : public VulkanLayerImpl {
 
     static void VKAPI_CALL vkCmdCopyTensorARM(VkCommandBuffer commandBuffer,
                                               const VkCopyTensorInfoARM *copyTensorInfo) {
-        assert(copyTensorInfo->regionCount == 1 && "Only support single region to copy tensor.");
-        auto *srcTensor = reinterpret_cast<TensorARM *>(copyTensorInfo->srcTensor);
+        const auto *srcTensor = reinterpret_cast<const TensorARM *>(copyTensorInfo->srcTensor);
         const auto *dstTensor = reinterpret_cast<const TensorARM *>(copyTensorInfo->dstTensor);
-        srcTensor->copyToTensor(*VulkanLayerImpl::getHandle(commandBuffer), *dstTensor);
+        auto cmd = VulkanLayerImpl::getHandle(commandBuffer);
+        auto handle = VulkanLayerImpl::getHandle(cmd->device->device);
+        srcTensor->copyToTensor(*cmd, handle->copyPipelineCache, handle->copyRegionArena, *dstTensor,
+                                copyTensorInfo->regionCount, copyTensorInfo->pRegions);
+    }
+
+    /*******************************************************************************
+     * Command buffer
+     *******************************************************************************/
+
+    // Region tables of recorded tensor copies are released once the command buffer can no longer execute them
+
+    static VkResult VKAPI_CALL vkBeginCommandBuffer(VkCommandBuffer commandBuffer,
+                                                    const VkCommandBufferBeginInfo *pBeginInfo) {
+        auto handle = VulkanLayerImpl::getHandle(commandBuffer);
+        VulkanLayerImpl::getHandle(handle->device->device)->copyRegionArena.release(commandBuffer);
+        handle->arena.reset();
+        return handle->loader->vkBeginCommandBuffer(commandBuffer, pBeginInfo);
+    }
+
+    static VkResult VKAPI_CALL vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags) {
+        auto handle = VulkanLayerImpl::getHandle(commandBuffer);
+        VulkanLayerImpl::getHandle(handle->device->device)->copyRegionArena.release(commandBuffer);
+        handle->arena.reset();
+        return handle->loader->vkResetCommandBuffer(commandBuffer, flags);
+    }
+
+    static void VKAPI_CALL vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount,
+                                                const VkCommandBuffer *commandBuffers) {
+        auto deviceHandle = VulkanLayerImpl::getHandle(device);
+        for (uint32_t i = 0; i < commandBufferCount; ++i) {
+            deviceHandle->copyRegionArena.release(commandBuffers[i]);
+        }
+        VulkanLayerImpl::vkFreeCommandBuffers(device, commandPool, commandBufferCount, commandBuffers);
+    }
+
+    static VkResult VKAPI_CALL vkResetCommandPool(VkDevice device, VkCommandPool commandPool,
+                                                  VkCommandPoolResetFlags flags) {
+        auto deviceHandle = VulkanLayerImpl::getHandle(device);
+        releaseCommandPool(*deviceHandle, commandPool);
+        return deviceHandle->loader->vkResetCommandPool(device, commandPool, flags);
+    }
+
+    static void VKAPI_CALL vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool,
+                                                const VkAllocationCallbacks *allocator) {
+        auto deviceHandle = VulkanLayerImpl::getHandle(device);
+        releaseCommandPool(*deviceHandle, commandPool);
+        VulkanLayerImpl::vkDestroyCommandPool(device, commandPool, allocator);
+    }
+
+    static void releaseCommandPool(TensorDevice &deviceHandle, VkCommandPool commandPool) {
+        const auto commandBuffers = commandBufferMap.findKeys([&](auto, const auto &commandBufferHandle) {
+            return commandBufferHandle->device.get() == &deviceHandle &&
+                   commandBufferHandle->commandPool == commandPool;
+        });
+        for (auto *const commandBuffer : commandBuffers) {
+            deviceHandle.copyRegionArena.release(commandBuffer);
+            if (const auto handle = VulkanLayerImpl::getHandle(commandBuffer)) {
+                handle->arena.reset();
+            }
+        }
     }
 
     static VkResult vkGetTensorViewOpaqueCaptureDescriptorDataARM(VkDevice device,
@@ -343,46 +448,35 @@ class TensorLayer : public VulkanLayerImpl {
                                                     const VkAllocationCallbacks *pAllocator,
                                                     VkShaderModule *pShaderModule) {
         auto handle = VulkanLayerImpl::getHandle(device);
-        if (pCreateInfo != nullptr && pCreateInfo->pCode != nullptr && pCreateInfo->codeSize > 0) {
+        const utils::ScopedHostTimer shaderModuleTimer(handle->hostTimers.get(), "vkCreateShaderModule");
+        // Shaders without tensors are passed through before hashing or copying them
+        if (pCreateInfo != nullptr && pCreateInfo->pCode != nullptr && pCreateInfo->codeSize > 0 &&
+            declaresTensorCapability(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t))) {
             const uint32_t *spirvCode = pCreateInfo->pCode;
             const std::size_t spirvSize = pCreateInfo->codeSize / sizeof(uint32_t);
             const std::size_t hashCode = spirvHash(spirvCode, spirvSize);
-            bool hasCacheEntry;
-            std::size_t shaderModuleCodeSize = 0;
-            const uint32_t *shaderModulepCode = nullptr;
+            const auto *spirvSourceNew = spirvCache.find(hashCode);
 
-            {
-                scopedMutex l(globalMutex);
-                const auto it = spirvCache.find(hashCode);
-                hasCacheEntry = (it != spirvCache.end());
-                if (hasCacheEntry) {
-                    shaderModuleCodeSize = it->second.size() * sizeof(uint32_t);
-                    shaderModulepCode = it->second.data();
-                }
-            }
-
-            if (!hasCacheEntry) {
+            if (spirvSourceNew == nullptr) {
+                const utils::ScopedHostTimer rewriteTimer(handle->hostTimers.get(), "vkCreateShaderModule/rewrite");
                 std::vector<uint32_t> spirvSource = {spirvCode, spirvCode + spirvSize};
                 const TensorProcessor tensorProcessor(std::move(spirvSource));
                 if (!tensorProcessor.isValidShader()) {
                     return VK_ERROR_UNKNOWN;
                 }
                 if (tensorProcessor.isTensorComputeShader()) {
-                    scopedMutex l(globalMutex);
-                    auto &spirvSourceNew = spirvCache[hashCode];
-                    spirvSourceNew = tensorProcessor.getNewSpirv();
-                    shaderModuleCodeSize = spirvSourceNew.size() * sizeof(uint32_t);
-                    shaderModulepCode = spirvSourceNew.data();
+                    spirvSourceNew = &spirvCache.getOrRewrite(
+                        hashCode, [&]() { return getNewSpirv(tensorProcessor, spirvCode, spirvSize); });
                 }
             }
 
-            if ((shaderModuleCodeSize > 0) && (shaderModulepCode != nullptr)) {
+            if (spirvSourceNew != nullptr && !spirvSourceNew->empty()) {
                 const VkShaderModuleCreateInfo shaderModuleInfo = {
                     VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, // type
                     pCreateInfo->pNext,                          // next
                     pCreateInfo->flags,                          // flags
-                    shaderModuleCodeSize,                        // size
-                    shaderModulepCode                            // code
+                    spirvSourceNew->size() * sizeof(uint32_t),   // size
+                    spirvSourceNew->data()                       // code
                 };
 
                 return handle->loader->vkCreateShaderModule(device, &shaderModuleInfo, pAllocator, pShaderModule);
@@ -398,14 +492,13 @@ class TensorLayer : public VulkanLayerImpl {
                                                         VkPipeline *pPipelines) {
         auto handle = VulkanLayerImpl::getHandle(device);
 
-        std::vector<VkComputePipelineCreateInfo> createInfosNew;
-        std::map<const VkShaderModuleCreateInfo *, VkShaderModule>
-            shaderCache; // avoid creating multiple shader modules for the same shader
-
-        // Inspect all VkComputePipelineCreateInfo for VkShaderModuleCreateInfo to find uses tensorARM in shaders
+        // Inspect all VkComputePipelineCreateInfo for VkShaderModuleCreateInfo to find uses tensorARM in shaders. Each
+        // distinct VkShaderModuleCreateInfo is inspected once, a shaderModule created for it can be reused by every
+        // pipeline referencing it.
+        std::vector<const VkShaderModuleCreateInfo *> shaderCreateInfos(createInfoCount, nullptr);
+        std::vector<const VkShaderModuleCreateInfo *> uniqueShaderCreateInfos;
         for (uint32_t i = 0; i < createInfoCount; i++) {
-            const auto &pipelineCreateInfo = pCreateInfos[i];
-            const auto &shaderStageCreateInfo = pipelineCreateInfo.stage;
+            const auto &shaderStageCreateInfo = pCreateInfos[i].stage;
             if (shaderStageCreateInfo.module != VK_NULL_HANDLE) {
                 // shaderStageCreateInfo uses "module" instead of "pNext" to specify shader
                 continue;
@@ -414,52 +507,70 @@ class TensorLayer : public VulkanLayerImpl {
             const auto *pShaderCreateInfo = findType<VkShaderModuleCreateInfo>(
                 shaderStageCreateInfo.pNext, VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO);
             if (pShaderCreateInfo == nullptr || pShaderCreateInfo->pCode == nullptr ||
-                pShaderCreateInfo->codeSize == 0) {
+                pShaderCreateInfo->codeSize == 0 ||
+                !declaresTensorCapability(pShaderCreateInfo->pCode, pShaderCreateInfo->codeSize / sizeof(uint32_t))) {
                 continue;
             }
-            // If a shaderModule has already been created for this shaderModuleCreateInfo, it can be reused for this
-            // pipeline
-            if (auto it = shaderCache.find(pShaderCreateInfo); it != shaderCache.end()) {
-                createInfosNew[i].stage.module = it->second;
-                continue;
+            shaderCreateInfos[i] = pShaderCreateInfo;
+            if (std::find(uniqueShaderCreateInfos.begin(), uniqueShaderCreateInfos.end(), pShaderCreateInfo) ==
+                uniqueShaderCreateInfos.end()) {
+                uniqueShaderCreateInfos.push_back(pShaderCreateInfo);
             }
+        }
+
+        // Shaders already rewritten, or being rewritten by another thread, are taken from the cache on this thread.
+        // Only the others are handed to the worker pool.
+        std::vector<const std::vector<uint32_t> *> spirvSourcesNew(uniqueShaderCreateInfos.size(), nullptr);
+        std::vector<std::size_t> hashCodes(uniqueShaderCreateInfos.size());
+        std::vector<std::size_t> misses;
+        for (std::size_t i = 0; i < uniqueShaderCreateInfos.size(); i++) {
+            hashCodes[i] = spirvHash(uniqueShaderCreateInfos[i]->pCode,
+                                     uniqueShaderCreateInfos[i]->codeSize / sizeof(uint32_t));
+            spirvSourcesNew[i] = spirvCache.find(hashCodes[i]);
+            if (spirvSourcesNew[i] == nullptr) {
+                misses.push_back(i);
+            }
+        }
+
+        // Replace tensors with buffers in shaders, the rewrites of a batch are independent and run in parallel
+        std::atomic<bool> isValid{true};
+        utils::parallelFor(misses.size(), [&](std::size_t miss) {
+            const auto i = misses[miss];
+            const uint32_t *spirvCode = uniqueShaderCreateInfos[i]->pCode;
+            const std::size_t spirvSize = uniqueShaderCreateInfos[i]->codeSize / sizeof(uint32_t);
+            const std::size_t hashCode = hashCodes[i];
             // Check if the shader uses tensors
-            const uint32_t *spirvCode = pShaderCreateInfo->pCode;
-            const std::size_t spirvSize = pShaderCreateInfo->codeSize / sizeof(uint32_t);
             std::vector<uint32_t> spirvSource = {spirvCode, spirvCode + spirvSize};
             const TensorProcessor tensorProcessor(std::move(spirvSource));
             if (!tensorProcessor.isValidShader()) {
-                return VK_ERROR_UNKNOWN;
-            }
-            if (!tensorProcessor.isTensorComputeShader()) {
-                continue;
+                isValid = false;
+                return;
             }
-            // Can't modify pCreateInfos, so we have to make a copy
-            if (createInfosNew.empty()) {
-                createInfosNew = std::vector<VkComputePipelineCreateInfo>(pCreateInfos, pCreateInfos + createInfoCount);
+            if (tensorProcessor.isTensorComputeShader()) {
+                spirvSourcesNew[i] = &spirvCache.getOrRewrite(
+                    hashCode, [&]() { return getNewSpirv(tensorProcessor, spirvCode, spirvSize); });
             }
-            std::size_t shaderModuleCodeSize;
-            const uint32_t *shaderModulepCode;
-            // Replace tensors with buffers in shader
-            {
-                scopedMutex l(globalMutex);
-                std::size_t hashCode = spirvHash(spirvCode, spirvSize);
-                auto &spirvSourceNew = spirvCache[hashCode];
-                if (spirvSourceNew.empty()) {
-                    spirvSourceNew = tensorProcessor.getNewSpirv();
-                }
-                shaderModuleCodeSize = spirvSourceNew.size() * sizeof(uint32_t);
-                shaderModulepCode = spirvSourceNew.data();
+        });
+        if (!isValid) {
+            return VK_ERROR_UNKNOWN;
+        }
+
+        std::vector<VkComputePipelineCreateInfo> createInfosNew;
+        std::map<const VkShaderModuleCreateInfo *, VkShaderModule>
+            shaderCache; // avoid creating multiple shader modules for the same shader
+        for (std::size_t i = 0; i < uniqueShaderCreateInfos.size(); i++) {
+            if (spirvSourcesNew[i] == nullptr || spirvSourcesNew[i]->empty()) {
+                continue;
             }
+            const auto *pShaderCreateInfo = uniqueShaderCreateInfos[i];
             // Replace incoming VkShaderModuleCreateInfo with modified shader
             VkShaderModuleCreateInfo shaderModuleCreateInfo{
-                VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, // type
-                pShaderCreateInfo->pNext,                    // next
-                pShaderCreateInfo->flags,                    // flags
-                shaderModuleCodeSize,                        // size
-                shaderModulepCode                            // code
+                VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,   // type
+                pShaderCreateInfo->pNext,                      // next
+                pShaderCreateInfo->flags,                      // flags
+                spirvSourcesNew[i]->size() * sizeof(uint32_t), // size
+                spirvSourcesNew[i]->data()                     // code
             };
-            auto &shaderStageCreateInfoNew = createInfosNew[i].stage;
             // The incoming shader is provided via a "const *" pNext chain. To replace the old shader with the new
             // one, we would have to copy all structs in the chain to work around pNext being immutable. Instead, we
             // explicitly call vkCreateShaderModule and set ".module" in the copied VkPipelineShaderStageCreateInfo,
@@ -467,7 +578,16 @@ class TensorLayer : public VulkanLayerImpl {
             VkShaderModule shaderModule;
             handle->loader->vkCreateShaderModule(device, &shaderModuleCreateInfo, pAllocator, &shaderModule);
             shaderCache[pShaderCreateInfo] = shaderModule;
-            shaderStageCreateInfoNew.module = shaderModule;
+        }
+
+        if (!shaderCache.empty()) {
+            // Can't modify pCreateInfos, so we have to make a copy
+            createInfosNew = std::vector<VkComputePipelineCreateInfo>(pCreateInfos, pCreateInfos + createInfoCount);
+            for (uint32_t i = 0; i < createInfoCount; i++) {
+                if (auto it = shaderCache.find(shaderCreateInfos[i]); it != shaderCache.end()) {
+                    createInfosNew[i].stage.module = it->second;
+                }
+            }
         }
         const auto *pCreateInfosNew = createInfosNew.empty() ? pCreateInfos : createInfosNew.data();
         VkResult res = handle->loader->vkCreateComputePipelines(device, pipelineCache, createInfoCount, pCreateInfosNew,
@@ -554,7 +674,7 @@ class TensorLayer : public VulkanLayerImpl {
         auto handle = VulkanLayerImpl::getHandle(device);
 
         auto [writes, _bufferInfos, _imageInfos] =
-            descriptor_binding::substituteTensorWriteDescriptorSet(*handle, descriptorWriteCount, pDescriptorWrites);
+            descriptor_binding::substituteTensorWriteDescriptorSet(descriptorWriteCount, pDescriptorWrites);
 
         handle->loader->vkUpdateDescriptorSets(device, uint32_t(writes.size()), writes.data(), descriptorCopyCount,
                                                pDescriptorCopies);
@@ -565,9 +685,10 @@ class TensorLayer : public VulkanLayerImpl {
                                                      uint32_t set, uint32_t descriptorWriteCount,
                                                      const VkWriteDescriptorSet *pDescriptorWrites) {
         auto handle = VulkanLayerImpl::getHandle(commandBuffer);
+        const Arena::Scope arenaScope{handle->arena};
 
         auto [writes, _bufferInfos, _imageInfos] = descriptor_binding::substituteTensorWriteDescriptorSet(
-            *handle->device, descriptorWriteCount, pDescriptorWrites);
+            descriptorWriteCount, pDescriptorWrites, &handle->arena);
 
         handle->loader->vkCmdPushDescriptorSetKHR(commandBuffer, pipelineBindPoint, layout, set,
                                                   static_cast<uint32_t>(writes.size()), writes.data());
@@ -588,10 +709,13 @@ class TensorLayer : public VulkanLayerImpl {
             return;
         }
 
+        const Arena::Scope arenaScope{handle->arena};
+        const ArenaAllocator<void> allocator{&handle->arena};
+
         // replace tensor/image aliasing flag
-        std::vector<VkImageMemoryBarrier2> imageMemoryBarriers{pDependencyInfo->pImageMemoryBarriers,
-                                                               pDependencyInfo->pImageMemoryBarriers +
-                                                                   pDependencyInfo->imageMemoryBarrierCount};
+        ArenaVector<VkImageMemoryBarrier2> imageMemoryBarriers{
+            pDependencyInfo->pImageMemoryBarriers,
+            pDependencyInfo->pImageMemoryBarriers + pDependencyInfo->imageMemoryBarrierCount, allocator};
         for (auto &barrier : imageMemoryBarriers) {
             if (barrier.oldLayout == VK_IMAGE_LAYOUT_TENSOR_ALIASING_ARM) {
                 barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -602,17 +726,13 @@ class TensorLayer : public VulkanLayerImpl {
         }
 
         // replace tensor memory barrier with buffer memory barrier
-        std::vector<VkBufferMemoryBarrier2> bufferMemoryBarriers{pDependencyInfo->pBufferMemoryBarriers,
-                                                                 pDependencyInfo->pBufferMemoryBarriers +
-                                                                     pDependencyInfo->bufferMemoryBarrierCount};
+        ArenaVector<VkBufferMemoryBarrier2> tensorBufferBarriers(allocator);
         if (tensorDependencyInfo != nullptr) {
-            std::vector<VkTensorMemoryBarrierARM> tensorMemoryBarriers{
-                tensorDependencyInfo->pTensorMemoryBarriers,
-                tensorDependencyInfo->pTensorMemoryBarriers + tensorDependencyInfo->tensorMemoryBarrierCount};
-
-            for (const auto &barrier : tensorMemoryBarriers) {
+            tensorBufferBarriers.reserve(tensorDependencyInfo->tensorMemoryBarrierCount);
+            for (uint32_t i = 0; i < tensorDependencyInfo->tensorMemoryBarrierCount; i++) {
+                const auto &barrier = tensorDependencyInfo->pTensorMemoryBarriers[i];
                 const auto *tensorARM = reinterpret_cast<const TensorARM *>(barrier.tensor);
-                bufferMemoryBarriers.emplace_back(VkBufferMemoryBarrier2{
+                tensorBufferBarriers.emplace_back(VkBufferMemoryBarrier2{
                     VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2, // sType
                     nullptr,                                   // pNext
                     barrier.srcStageMask,                      // srcStageMask
@@ -628,7 +748,7 @@ class TensorLayer : public VulkanLayerImpl {
             }
         } else if (tensorBarrier != nullptr) {
             const auto *tensorARM = reinterpret_cast<const TensorARM *>(tensorBarrier->tensor);
-            bufferMemoryBarriers.emplace_back(VkBufferMemoryBarrier2{
+            tensorBufferBarriers.emplace_back(VkBufferMemoryBarrier2{
                 VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2, // sType
                 nullptr,                                   // pNext
                 tensorBarrier->srcStageMask,               // srcStageMask
@@ -642,12 +762,25 @@ class TensorLayer : public VulkanLayerImpl {
                 VK_WHOLE_SIZE                              // size
             });
         }
+
+        // collapse tensor barriers sharing their masks into global memory barriers
+        ArenaVector<VkMemoryBarrier2> memoryBarriers{
+            pDependencyInfo->pMemoryBarriers, pDependencyInfo->pMemoryBarriers + pDependencyInfo->memoryBarrierCount,
+            allocator};
+        tensor_arm_detail::coalesceBufferBarriers(tensorBufferBarriers, memoryBarriers, getBarrierCoalesceThreshold());
+
+        ArenaVector<VkBufferMemoryBarrier2> bufferMemoryBarriers{
+            pDependencyInfo->pBufferMemoryBarriers,
+            pDependencyInfo->pBufferMemoryBarriers + pDependencyInfo->bufferMemoryBarrierCount, allocator};
+        bufferMemoryBarriers.insert(bufferMemoryBarriers.end(), tensorBufferBarriers.begin(),
+                                    tensorBufferBarriers.end());
+
         const VkDependencyInfo newDependencyInfo{
             VK_STRUCTURE_TYPE_DEPENDENCY_INFO,                  // sType
             nullptr,                                            // pNext
             pDependencyInfo->dependencyFlags,                   // dependencyFlags
-            pDependencyInfo->memoryBarrierCount,                // memoryBarrierCount
-            pDependencyInfo->pMemoryBarriers,                   // pMemoryBarriers
+            static_cast<uint32_t>(memoryBarriers.size()),       // memoryBarrierCount
+            memoryBarriers.data(),                              // pMemoryBarriers
             static_cast<uint32_t>(bufferMemoryBarriers.size()), // bufferMemoryBarrierCount
             bufferMemoryBarriers.data(),                        // pBufferMemoryBarriers
             static_cast<uint32_t>(imageMemoryBarriers.size()),  // imageMemoryBarrierCount
@@ -672,9 +805,12 @@ class TensorLayer : public VulkanLayerImpl {
             return;
         }
 
+        const Arena::Scope arenaScope{handle->arena};
+
         // Replace any `VK_IMAGE_LAYOUT_TENSOR_ALIASING_ARM` flags
-        std::vector<VkImageMemoryBarrier> imageMemoryBarriers(pImageMemoryBarriers,
-                                                              pImageMemoryBarriers + imageMemoryBarrierCount);
+        ArenaVector<VkImageMemoryBarrier> imageMemoryBarriers(pImageMemoryBarriers,
+                                                              pImageMemoryBarriers + imageMemoryBarrierCount,
+                                                              ArenaAllocator<VkImageMemoryBarrier>{&handle->arena});
 
         for (auto &barrier : imageMemoryBarriers) {
             if (barrier.oldLayout == VK_IMAGE_LAYOUT_TENSOR_ALIASING_ARM) {
@@ -949,7 +1085,72 @@ class TensorLayer : public VulkanLayerImpl {
         return result;
     }
 
-    static inline std::unordered_map<std::size_t, std::vector<uint32_t>> spirvCache;
+    static std::vector<uint32_t> getNewSpirv(const TensorProcessor &tensorProcessor, const uint32_t *spirvCode,
+                                             std::size_t spirvSize) {
+        const auto *diskCache = getShaderDiskCache();
+        if (diskCache != nullptr) {
+            if (auto spirv = diskCache->load(spirvCode, spirvSize)) {
+                return std::move(*spirv);
+            }
+        }
+
+        auto spirv = tensorProcessor.getNewSpirv(isTensorAccessBoundsChecked());
+        if (diskCache != nullptr) {
+            diskCache->store(spirvCode, spirvSize, spirv);
+        }
+        return spirv;
+    }
+
+    static size_t getBarrierCoalesceThreshold() {
+        // Number of tensor barriers with identical masks from which they are merged into one memory barrier. Opt-in
+        // until the cost of global memory barriers has been measured on the supported drivers
+        static const size_t threshold = []() -> size_t {
+            const char *value = std::getenv("VMEL_TENSOR_BARRIER_COALESCE_THRESHOLD");
+            if (value == nullptr || *value == '\0') {
+                return defaultBarrierCoalesceThreshold;
+            }
+            char *end = nullptr;
+            const auto parsed = std::strtoull(value, &end, 10);
+            if (end == value || *end != '\0' || std::strchr(value, '-') != nullptr) {
+                tensorLog(Severity::Warning) << "Ignoring invalid VMEL_TENSOR_BARRIER_COALESCE_THRESHOLD " << value
+                                             << std::endl;
+                return defaultBarrierCoalesceThreshold;
+            }
+            return static_cast<size_t>(parsed);
+        }();
+        return threshold;
+    }
+
+    static bool isTensorAccessBoundsChecked() {
+        // Opt-in for applications whose shaders never access tensors out of bounds, except through reads with an out
+        // of bounds value
+        static const bool isBoundsChecked =
+            !utils::isTruthyEnvironmentValue(std::getenv("VMEL_TENSOR_UNCHECKED_ACCESS"));
+        return isBoundsChecked;
+    }
+
+    static const ShaderDiskCache *getShaderDiskCache() {
+        // Rewrites depend on the layer build, so the version and build flags are part of every key
+        static const auto diskCache = []() -> std::unique_ptr<ShaderDiskCache> {
+            const char *directory = std::getenv("VMEL_TENSOR_SHADER_CACHE");
+            if (directory == nullptr || *directory == '\0') {
+                return nullptr;
+            }
+            std::string salt{mlsdk::el::details::version};
+#ifdef EXPERIMENTAL_MOLTEN_VK_SUPPORT
+            salt += "+moltenvk";
+#endif
+            if (!isTensorAccessBoundsChecked()) {
+                salt += "+unchecked";
+            }
+            return std::make_unique<ShaderDiskCache>(directory, salt);
+        }();
+        return diskCache.get();
+    }
+
+    static constexpr size_t defaultBarrierCoalesceThreshold = 0;
+
+    static inline ShaderRewriteCache spirvCache;
 
     static inline MemoryAliasing memoryAliasing;
     static bool isUniformBufferUpdateAfterBindEnabled(const VkDeviceCreateInfo *createInfo) {
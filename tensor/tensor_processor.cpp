@@ -8,10 +8,11 @@
 
 #include "descriptor_binding.hpp"
 #include "mlel/utils.hpp"
+#include "spirv_glsl_tensor_buffer.hpp"
+#include "spirv_pass_tensor_buffer.hpp"
 #include "tensor_log.hpp"
 #include <map>
 #include <set>
-#include <spirv_cross_error_handling.hpp>
 #include <sstream>
 
 using namespace mlsdk::el::utils;
@@ -20,24 +21,23 @@ using namespace mlsdk::el::log;
 namespace mlsdk::el::layer {
 
 TensorProcessor::TensorProcessor(std::vector<uint32_t> spirv_) : m_spirv{std::move(spirv_)} {
-    try {
-        m_spirvCompiler = std::make_unique<CompilerTensorAsBuffer>(m_spirv);
-        bool hasTensor = m_spirvCompiler->hasTensors();
-        bool isCompute = m_spirvCompiler->isCompute();
-        m_isTensorCompute = hasTensor && isCompute;
-        if (hasTensor && !isCompute) {
-            tensorLog(Severity::Error)
-                << "SPIR-V at: " << m_spirv.data()
-                << " uses OpTypeTensorARM but is not a compute shader. This is unsupported by the Tensor Layer."
-                << std::endl;
-            m_isValid = false;
-        } else {
-            m_isValid = true;
-        }
-    } catch (spirv_cross::CompilerError const &) {
-        // bypass SPIRV that can't be compiled with SPIRV-Cross, and log a warning
+    const auto info = inspectTensorModule(m_spirv);
+    if (!info.isValid) {
+        // bypass SPIR-V that can't be parsed, and log a warning
         tensorLog(Severity::Error) << "SPIR-V at:" << m_spirv.data() << " could not be parsed." << std::endl;
         m_isValid = false;
+        return;
+    }
+
+    m_isTensorCompute = info.hasTensors && info.isCompute;
+    if (info.hasTensors && !info.isCompute) {
+        tensorLog(Severity::Error)
+            << "SPIR-V at: " << m_spirv.data()
+            << " uses OpTypeTensorARM but is not a compute shader. This is unsupported by the Tensor Layer."
+            << std::endl;
+        m_isValid = false;
+    } else {
+        m_isValid = true;
     }
 }
 
@@ -45,14 +45,24 @@ bool TensorProcessor::isTensorComputeShader() const { return m_isTensorCompute;
 
 bool TensorProcessor::isValidShader() const { return m_isValid; }
 
-std::vector<uint32_t> TensorProcessor::getNewSpirv() const {
+std::vector<uint32_t> TensorProcessor::getNewSpirv(bool isBoundsChecked) const {
     if (!isTensorComputeShader()) {
         return m_spirv;
     }
 
-    std::string glslSource = m_spirvCompiler->compile();
+#ifndef EXPERIMENTAL_MOLTEN_VK_SUPPORT
+    // Rewrite the tensor instructions in place, which leaves the rest of the module untouched
+    if (auto lowered = lowerTensorsToBuffers(m_spirv, isBoundsChecked)) {
+        return std::move(*lowered);
+    }
+    MLEL_LOG(tensorLog, Severity::Info) << "Falling back to GLSL for SPIR-V at: " << m_spirv.data() << std::endl;
+#endif
+
+    // Round trip through GLSL, binding the tensor data as aliased storage buffers
+    CompilerTensorAsBuffer compiler(m_spirv, isBoundsChecked);
+    std::string glslSource = compiler.compile();
 
-    tensorLog(Severity::Debug) << glslSource;
+    MLEL_LOG(tensorLog, Severity::Debug) << glslSource;
 
     return glslToSpirv(glslSource);
 }
@@ -5,10 +5,8 @@
  */
 
 #pragma once
-#include "spirv_glsl_tensor_buffer.hpp"
 
 #include <cstdint>
-#include <memory>
 #include <vector>
 
 namespace mlsdk::el::layer {
@@ -17,11 +15,10 @@ class TensorProcessor {
     explicit TensorProcessor(std::vector<uint32_t> spirv_);
     bool isTensorComputeShader() const;
     bool isValidShader() const;
-    std::vector<uint32_t> getNewSpirv() const;
+    std::vector<uint32_t> getNewSpirv(bool isBoundsChecked = true) const;
 
   private:
     std::vector<uint32_t> m_spirv;
-    std::unique_ptr<CompilerTensorAsBuffer> m_spirvCompiler;
     bool m_isTensorCompute = false;
     bool m_isValid = false;
 };
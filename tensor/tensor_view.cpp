@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: Copyright 2023-2025 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-FileCopyrightText: Copyright 2023-2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
  * SPDX-License-Identifier: Apache-2.0
  *
  */
@@ -8,11 +8,16 @@
 
 namespace mlsdk::el::layer {
 
-VkResult TensorViewARM::create(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
-                               const VkAllocationCallbacks *allocator) {
+VkResult TensorViewARM::create(const Device &dev, TensorDescriptorArena &arena,
+                               const VkTensorViewCreateInfoARM *createInfo, const VkAllocationCallbacks *allocator) {
     m_descriptor = allocateObject<TensorDescriptor>(allocator);
     m_tensor = createInfo->tensor;
-    return m_descriptor->create(dev, createInfo, allocator);
+    VkResult result = m_descriptor->create(dev, arena, createInfo, allocator);
+    if (result != VK_SUCCESS) {
+        destroyObject(allocator, m_descriptor);
+        m_descriptor = nullptr;
+    }
+    return result;
 }
 
 void TensorViewARM::destroy(const Device &dev, const VkAllocationCallbacks *pAllocator) {
@@ -20,8 +25,8 @@ void TensorViewARM::destroy(const Device &dev, const VkAllocationCallbacks *pAll
     destroyObject(pAllocator, m_descriptor);
 }
 
-VkBuffer TensorViewARM::getDescriptorBuffer(const Device &dev) const {
-    return m_descriptor->getTensorDescriptorBuffer(dev, m_tensor);
+VkDescriptorBufferInfo TensorViewARM::getDescriptorBufferInfo() const {
+    return m_descriptor->getDescriptorBufferInfo();
 }
 
 VkBuffer TensorViewARM::getTensorBuffer() const { return reinterpret_cast<TensorARM *>(m_tensor)->getTensorBuffer(); }
@@ -30,7 +35,7 @@ VkResult TensorViewARM::getOpaqueCaptureDescriptorDataEXT(const Device &dev, voi
     const VkBufferCaptureDescriptorDataInfoEXT info = {
         VK_STRUCTURE_TYPE_BUFFER_CAPTURE_DESCRIPTOR_DATA_INFO_EXT,
         nullptr,
-        getDescriptorBuffer(dev),
+        getDescriptorBufferInfo().buffer,
     };
     return dev.loader->vkGetBufferOpaqueCaptureDescriptorDataEXT(dev.device, &info, pData);
 }
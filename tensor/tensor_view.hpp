@@ -18,10 +18,10 @@ class TensorViewARM {
     TensorViewARM(const TensorViewARM &) = delete;
     TensorViewARM &operator=(const TensorViewARM &) = delete;
 
-    VkResult create(const Device &dev, const VkTensorViewCreateInfoARM *createInfo,
+    VkResult create(const Device &dev, TensorDescriptorArena &arena, const VkTensorViewCreateInfoARM *createInfo,
                     const VkAllocationCallbacks *allocator);
     void destroy(const Device &dev, const VkAllocationCallbacks *pAllocator);
-    VkBuffer getDescriptorBuffer(const Device &dev) const;
+    VkDescriptorBufferInfo getDescriptorBufferInfo() const;
     VkBuffer getTensorBuffer() const;
     VkResult getOpaqueCaptureDescriptorDataEXT(const Device &dev, void *pData) const;
 
@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*
+ * Measures the cost of ingesting a graph module with megabytes of inline constants, as done by every data graph
+ * pipeline creation before the graph is lowered. The optimizer round trip builds the IR for each inspection and
+ * serializes the module after the passes, while the graph layer now builds the IR once and runs the passes in place.
+ */
+
+#include "spirv_module.hpp"
+
+#include "source/opt/build_module.h"
+#include "spirv-tools/optimizer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t arrayCount = 512;
+constexpr uint32_t arrayLength = 1024;
+constexpr uint32_t iterationCount = 5;
+
+template <typename T> uint32_t word(T value) { return static_cast<uint32_t>(value); }
+
+void addInstruction(std::vector<uint32_t> &spirv, spv::Op opcode, const std::vector<uint32_t> &operands) {
+    spirv.push_back(static_cast<uint32_t>((operands.size() + 1) << 16) | word(opcode));
+    spirv.insert(spirv.end(), operands.begin(), operands.end());
+}
+
+// Compute module with a specialization constant and arrayCount arrays of arrayLength unique float constants
+std::vector<uint32_t> makeModule() {
+    enum : uint32_t { VOID = 1, FUNCTION_TYPE, FLOAT, UINT, LENGTH, ARRAY, SPEC, MAIN, LABEL, FIRST_CONSTANT };
+
+    std::vector<uint32_t> spirv{spv::MagicNumber, 0x00010600, 0, 0, 0};
+    addInstruction(spirv, spv::Op::OpCapability, {word(spv::Capability::Shader)});
+    addInstruction(spirv, spv::Op::OpMemoryModel,
+                   {word(spv::AddressingModel::Logical), word(spv::MemoryModel::GLSL450)});
+
+    const char name[] = "main";
+    std::vector<uint32_t> entryPoint{word(spv::ExecutionModel::GLCompute), MAIN, 0, 0};
+    std::memcpy(&entryPoint[2], name, sizeof(name));
+    addInstruction(spirv, spv::Op::OpEntryPoint, entryPoint);
+    addInstruction(spirv, spv::Op::OpExecutionMode, {MAIN, word(spv::ExecutionMode::LocalSize), 1, 1, 1});
+    addInstruction(spirv, spv::Op::OpDecorate, {SPEC, word(spv::Decoration::SpecId), 0});
+
+    addInstruction(spirv, spv::Op::OpTypeVoid, {VOID});
+    addInstruction(spirv, spv::Op::OpTypeFunction, {FUNCTION_TYPE, VOID});
+    addInstruction(spirv, spv::Op::OpTypeFloat, {FLOAT, 32});
+    addInstruction(spirv, spv::Op::OpTypeInt, {UINT, 32, 0});
+    addInstruction(spirv, spv::Op::OpConstant, {UINT, LENGTH, arrayLength});
+    addInstruction(spirv, spv::Op::OpTypeArray, {ARRAY, FLOAT, LENGTH});
+    addInstruction(spirv, spv::Op::OpSpecConstant, {FLOAT, SPEC, 0x3f800000});
+
+    uint32_t id = FIRST_CONSTANT;
+    for (uint32_t i = 0; i < arrayCount; i++) {
+        std::vector<uint32_t> composite{ARRAY, 0};
+        for (uint32_t j = 0; j < arrayLength; j++) {
+            addInstruction(spirv, spv::Op::OpConstant, {FLOAT, id, 0x3f800000 + i * arrayLength + j});
+            composite.push_back(id++);
+        }
+        composite[1] = id++;
+        addInstruction(spirv, spv::Op::OpConstantComposite, composite);
+    }
+
+    addInstruction(spirv, spv::Op::OpFunction, {VOID, MAIN, word(spv::FunctionControlMask::MaskNone), FUNCTION_TYPE});
+    addInstruction(spirv, spv::Op::OpLabel, {LABEL});
+    addInstruction(spirv, spv::Op::OpReturn, {});
+    addInstruction(spirv, spv::Op::OpFunctionEnd, {});
+
+    spirv[3] = id;
+    return spirv;
+}
+
+template <typename Ingest> double measure(Ingest &&ingest) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterationCount; i++) {
+        if (!ingest()) {
+            std::cerr << "Failed to ingest module" << std::endl;
+            return 0;
+        }
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterationCount;
+}
+
+} // namespace
+
+int main() {
+    const auto spirv = makeModule();
+    const spvtools::MessageConsumer consumer = [](spv_message_level_t, const char *, const spv_position_t &,
+                                                  const char *) {};
+
+    const float specValue = 2.0f;
+    const VkSpecializationMapEntry mapEntry{0, 0, sizeof(specValue)};
+    const VkSpecializationInfo specializationInfo{1, &mapEntry, sizeof(specValue), &specValue};
+
+    const auto optimizerRoundTrip = measure([&] {
+        // The module was parsed once to find the graphs, once to check the instruction set versions, and once more by
+        // the optimizer, which then serialized the result
+        for (int i = 0; i < 2; i++) {
+            const auto ir = spvtools::BuildModule(SPV_ENV_UNIVERSAL_1_6, consumer, spirv.data(), spirv.size());
+            if (ir == nullptr) {
+                return false;
+            }
+        }
+
+        std::unordered_map<uint32_t, std::vector<uint32_t>> values{{0, {0x40000000}}};
+        spvtools::Optimizer optimizer{SPV_ENV_UNIVERSAL_1_6};
+        optimizer.SetMessageConsumer(consumer);
+        optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(values));
+        optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
+        optimizer.RegisterPass(spvtools::CreateFoldSpecConstantOpAndCompositePass());
+
+        spvtools::OptimizerOptions options;
+        options.set_run_validator(false);
+        std::vector<uint32_t> optimizedModule;
+        return optimizer.Run(spirv.data(), spirv.size(), &optimizedModule, options);
+    });
+
+    const auto buildOnce = measure([&] {
+        auto ir = mlsdk::el::layer::buildGraphModule(spirv.data(), spirv.size(), consumer);
+        if (ir == nullptr) {
+            return false;
+        }
+
+        spvtools::opt::PassManager passes;
+        passes.SetMessageConsumer(consumer);
+        mlsdk::el::layer::addSpecConstantDefaultPasses(passes, &specializationInfo);
+        return passes.Run(ir.get()) != spvtools::opt::Pass::Status::Failure;
+    });
+
+    std::cout << "Ingested a module of " << spirv.size() * sizeof(uint32_t) / (1024 * 1024) << " MiB with "
+              << arrayCount * arrayLength << " inline constants" << std::endl;
+    std::cout << "Optimizer round trip: " << optimizerRoundTrip << " ms/pipeline" << std::endl;
+    std::cout << "Build once: " << buildOnce << " ms/pipeline" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+/*
+ * Measures the cost of resolving the layer state of a command buffer, as done by every intercepted vkCmd* call. Each
+ * thread records into its own command buffer while the handle map holds the command buffers of all threads.
+ */
+
+#include "mlel/handle_map.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t threadCount = 8;
+constexpr uint32_t commandCount = 1000000;
+constexpr uintptr_t commandBufferCount = 1024;
+
+struct alignas(64) CommandBuffer {
+    std::atomic<uint64_t> commands{0};
+};
+
+template <typename Lookup> double recordCommands(Lookup &&lookup) {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&lookup, i] {
+            const auto handle = (i + 1) * 0x40;
+            for (uint32_t j = 0; j < commandCount / threadCount; j++) {
+                lookup(handle)->commands.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / commandCount;
+}
+
+} // namespace
+
+int main() {
+    mlsdk::el::layer::HandleMap<uintptr_t, CommandBuffer> handleMap;
+    std::map<uintptr_t, std::shared_ptr<CommandBuffer>> globalMap;
+    std::recursive_mutex globalMutex;
+
+    for (uintptr_t handle = 0; handle < commandBufferCount; handle++) {
+        auto commandBuffer = std::make_shared<CommandBuffer>();
+        handleMap.insert(handle * 0x40, commandBuffer);
+        globalMap[handle * 0x40] = std::move(commandBuffer);
+    }
+
+    const auto globalLookup = recordCommands([&](uintptr_t handle) {
+        const std::lock_guard<std::recursive_mutex> l(globalMutex);
+        return globalMap[handle];
+    });
+    const auto handleMapLookup = recordCommands([&](uintptr_t handle) { return handleMap.find(handle); });
+
+    std::cout << "Recorded " << commandCount << " commands on " << threadCount << " threads" << std::endl;
+    std::cout << "Global map lookup: " << globalLookup << " ns/command" << std::endl;
+    std::cout << "Handle map lookup: " << handleMapLookup << " ns/command" << std::endl;
+
+    return 0;
+}
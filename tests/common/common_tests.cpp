@@ -7,15 +7,25 @@
 #include <gtest/gtest.h>
 
 #include "mlel/float.hpp"
+#include "mlel/handle_map.hpp"
 #include "mlel/log.hpp"
 #include "mlel/utils.hpp"
+#include "mlel/vulkan_allocator.hpp"
 
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include <vulkan/vulkan.h>
@@ -71,6 +81,43 @@ TEST(MLEmulationLayerLog, HexDump) {
     testLog(Severity::Error) << HexDump(charPointer, sizeof(testchar));
 }
 
+struct CountedOutput {
+    uint32_t &count;
+};
+
+std::ostream &operator<<(std::ostream &os, const CountedOutput &output) {
+    output.count++;
+    return os;
+}
+
+TEST(MLEmulationLayerLog, FiltersBeforeFormatting) {
+    Log testLog("VMEL_TEST_SEVERITY", "TestLog");
+    uint32_t count = 0;
+
+    testLog(Severity::Debug) << CountedOutput{count} << std::endl;
+    EXPECT_EQ(count, testLog.enabled(Severity::Debug) ? 1u : 0u);
+
+    count = 0;
+    testLog(Severity::Error) << CountedOutput{count} << std::endl;
+    EXPECT_EQ(count, 1u);
+}
+
+TEST(MLEmulationLayerLog, LazyEntriesSkipOperands) {
+    Log testLog("VMEL_TEST_SEVERITY", "TestLog");
+    uint32_t evaluated = 0;
+    const auto operand = [&evaluated] {
+        evaluated++;
+        return std::string("operand");
+    };
+
+    MLEL_LOG(testLog, Severity::Debug) << operand() << std::endl;
+    EXPECT_EQ(evaluated, testLog.enabled(Severity::Debug) ? 1u : 0u);
+
+    evaluated = 0;
+    MLEL_LOG(testLog, Severity::Error) << operand() << std::endl;
+    EXPECT_EQ(evaluated, 1u);
+}
+
 template <typename T> void checkFloat(T v) {
     float8_e4m3 f8{v};
     float16 f16{v};
@@ -204,6 +251,25 @@ TEST(MLEmulationLayerFloat, Formats) {
     ASSERT_FALSE(std::isnormal(float(f16)));
 }
 
+template <typename T> void checkToDouble() {
+    for (uint32_t i = 0; i < (1U << (8 * sizeof(T))); i++) {
+        const auto bits = typename T::dtype(i);
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        // Compare bits, NaN never compares equal
+        const double expected = double(value);
+        const double actual = T::toDouble(bits);
+        ASSERT_EQ(std::memcmp(&expected, &actual, sizeof(double)), 0) << "bits=" << i;
+    }
+}
+
+TEST(MLEmulationLayerFloat, ToDoubleMatchesConversion) {
+    checkToDouble<float8_e4m3>();
+    checkToDouble<float8_e5m2>();
+    checkToDouble<float16>();
+}
+
 struct ExpectedFormatInfo {
     VkFormat format;
     bool isInteger;
@@ -293,4 +359,180 @@ TEST(MLEmulationLayerUtils, MakeFormatThrowsForUnsupportedFormat) {
     EXPECT_THROW(static_cast<void>(getFormatInfo(VK_FORMAT_UNDEFINED)), std::runtime_error);
 }
 
+TEST(MLEmulationLayerUtils, ParallelForVisitsEachIndexOnce) {
+    std::vector<std::atomic<int>> visits(100);
+    parallelFor(visits.size(), [&](std::size_t i) { visits[i]++; });
+    for (const auto &visit : visits) {
+        EXPECT_EQ(visit, 1);
+    }
+
+    EXPECT_THROW(parallelFor(10,
+                             [](std::size_t i) {
+                                 if (i == 5) {
+                                     throw std::runtime_error("failed");
+                                 }
+                             }),
+                 std::runtime_error);
+}
+
+TEST(MLEmulationLayerUtils, ParallelForReusesThreads) {
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    for (int i = 0; i < 20; i++) {
+        parallelFor(64, [&](std::size_t) {
+            const std::scoped_lock l(mutex);
+            threadIds.insert(std::this_thread::get_id());
+        });
+    }
+
+    EXPECT_LE(threadIds.size(), std::max(1U, std::thread::hardware_concurrency()));
+}
+
+TEST(MLEmulationLayerUtils, ParallelForNests) {
+    std::vector<std::atomic<int>> visits(64);
+    parallelFor(8, [&](std::size_t i) { parallelFor(8, [&](std::size_t j) { visits[i * 8 + j]++; }); });
+    for (const auto &visit : visits) {
+        EXPECT_EQ(visit, 1);
+    }
+}
+
+struct AllocationCounters {
+    uint32_t allocations = 0;
+    uint32_t frees = 0;
+};
+
+void *countingAllocation(void *userData, size_t size, size_t alignment, VkSystemAllocationScope) {
+    static_cast<AllocationCounters *>(userData)->allocations++;
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void countingFree(void *userData, void *memory) {
+    static_cast<AllocationCounters *>(userData)->frees++;
+    std::free(memory);
+}
+
+template <typename T> struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationCounters *_counters) : counters{_counters} {}
+    template <typename U> explicit CountingAllocator(const CountingAllocator<U> &other) : counters{other.counters} {}
+
+    T *allocate(size_t count) {
+        counters->allocations++;
+        return std::allocator<T>{}.allocate(count);
+    }
+
+    void deallocate(T *pointer, size_t count) {
+        counters->frees++;
+        std::allocator<T>{}.deallocate(pointer, count);
+    }
+
+    AllocationCounters *counters;
+};
+
+TEST(MLEmulationLayerArena, ScopesReuseBlocks) {
+    AllocationCounters counters;
+    const VkAllocationCallbacks callbacks{
+        &counters,          // pUserData
+        countingAllocation, // pfnAllocation
+        nullptr,            // pfnReallocation
+        countingFree,       // pfnFree
+        nullptr,            // pfnInternalAllocation
+        nullptr,            // pfnInternalFree
+    };
+
+    {
+        mlsdk::el::layer::Arena arena{&callbacks};
+        const mlsdk::el::layer::ArenaAllocator<void> allocator{&arena};
+        for (uint32_t command = 0; command < 100; command++) {
+            const mlsdk::el::layer::Arena::Scope scope{arena};
+            mlsdk::el::layer::ArenaVector<uint64_t> values(allocator);
+            std::list<uint32_t, mlsdk::el::layer::ArenaAllocator<uint32_t>> nodes(allocator);
+            for (uint64_t i = 0; i < 1000; i++) {
+                values.push_back(i);
+            }
+            nodes.push_back(command);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % alignof(uint64_t), 0u);
+            EXPECT_EQ(values.back(), 999u);
+        }
+        // Every command after the first one reuses the blocks grown by the first one
+        EXPECT_LE(counters.allocations, 3u);
+
+        arena.reset();
+        EXPECT_EQ(counters.allocations - counters.frees, 1u);
+    }
+    EXPECT_EQ(counters.allocations, counters.frees);
+}
+
+TEST(MLEmulationLayerHandleMap, FindDoesNotInsert) {
+    mlsdk::el::layer::HandleMap<uintptr_t, int> handles;
+    handles.insert(0x1000, std::make_shared<int>(1));
+
+    EXPECT_EQ(*handles.find(0x1000), 1);
+    EXPECT_EQ(handles.find(0x2000), nullptr);
+    EXPECT_EQ(handles.findKeys([](auto, const auto &) { return true; }).size(), 1u);
+
+    EXPECT_TRUE(handles.erase(0x1000));
+    EXPECT_FALSE(handles.erase(0x1000));
+    EXPECT_EQ(handles.find(0x1000), nullptr);
+}
+
+TEST(MLEmulationLayerHandleMap, CachedLookupsFollowChanges) {
+    mlsdk::el::layer::HandleMap<uintptr_t, int> handles;
+    handles.insert(0x1000, std::make_shared<int>(1));
+    EXPECT_EQ(*handles.find(0x1000), 1);
+    EXPECT_EQ(*handles.find(0x1000), 1);
+
+    // A handle value reused for a new object must not resolve to the cached old one
+    handles.erase(0x1000);
+    EXPECT_EQ(handles.find(0x1000), nullptr);
+    handles.insert(0x1000, std::make_shared<int>(2));
+    EXPECT_EQ(*handles.find(0x1000), 2);
+
+    // Maps do not share cached entries
+    mlsdk::el::layer::HandleMap<uintptr_t, int> otherHandles;
+    EXPECT_EQ(otherHandles.find(0x1000), nullptr);
+}
+
+TEST(MLEmulationLayerHandleMap, CacheDoesNotKeepErasedObjectsAllocated) {
+    AllocationCounters counters;
+    mlsdk::el::layer::HandleMap<uintptr_t, int> handles;
+    handles.insert(0x1000, std::allocate_shared<int>(CountingAllocator<int>{&counters}, 1));
+    EXPECT_EQ(*handles.find(0x1000), 1);
+    EXPECT_EQ(*handles.find(0x1000), 1);
+
+    // The object shares its allocation with the control block, which must be freed when the handle is erased
+    handles.erase(0x1000);
+    EXPECT_EQ(counters.allocations, 1u);
+    EXPECT_EQ(counters.frees, 1u);
+}
+
+TEST(MLEmulationLayerHandleMap, ConcurrentLookups) {
+    mlsdk::el::layer::HandleMap<uintptr_t, uintptr_t> handles;
+    constexpr uintptr_t handleCount = 256;
+    for (uintptr_t handle = 0; handle < handleCount; handle++) {
+        handles.insert(handle * 64, std::make_shared<uintptr_t>(handle));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4);
+    for (size_t i = 0; i < mismatches.size(); i++) {
+        threads.emplace_back([&handles, &mismatches, i] {
+            for (uintptr_t handle = 0; handle < handleCount; handle++) {
+                const auto value = handles.find(handle * 64);
+                mismatches[i] += !value || *value != handle;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (const auto count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+    handles.eraseIf([](auto handle, const auto &) { return handle >= 64 * 128; });
+    EXPECT_EQ(handles.findKeys([](auto, const auto &) { return true; }).size(), 128u);
+}
+
 } // namespace
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "metrics_exporter.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace mlsdk::el::layer;
+
+std::string readFile(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+size_t countOccurrences(const std::string &text, const std::string &pattern) {
+    size_t count = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size())) {
+        count++;
+    }
+    return count;
+}
+
+TEST(MetricsExporter, QuantileUsesNearestRank) { // cppcheck-suppress syntaxError
+    const std::vector<double> values{5.0, 1.0, 4.0, 2.0, 3.0};
+
+    ASSERT_EQ(getQuantile(values, 0.5), 3.0);
+    ASSERT_EQ(getQuantile(values, 0.95), 5.0);
+    ASSERT_EQ(getQuantile(values, 0.0), 1.0);
+    ASSERT_EQ(getQuantile({}, 0.5), 0.0);
+}
+
+TEST(MetricsExporter, FormatsOpenMetricsSummary) {
+    const std::vector<LatencySeries> series{{"0x1", "tosa", "CONV2D", {0.001, 0.002, 0.003, 0.004}}};
+    const auto text = formatOpenMetrics(series, 10.0);
+
+    ASSERT_EQ(text.find("# TYPE vmel_graph_operator_latency_seconds summary\n"), 0u);
+    const std::string labels = "pipeline=\"0x1\",pipeline_kind=\"tosa\",operator=\"CONV2D\"";
+    ASSERT_NE(text.find("vmel_graph_operator_latency_seconds{" + labels + ",quantile=\"0.5\"} 0.002 10.000\n"),
+              std::string::npos);
+    ASSERT_NE(text.find("vmel_graph_operator_latency_seconds{" + labels + ",quantile=\"0.99\"} 0.004 10.000\n"),
+              std::string::npos);
+    ASSERT_NE(text.find("vmel_graph_operator_latency_seconds_count{" + labels + "} 4 10.000\n"), std::string::npos);
+    ASSERT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+TEST(MetricsExporter, EscapesLabelValues) {
+    const std::vector<LatencySeries> series{{"0x1", "tosa", "a\"b\\c", {0.001}}};
+    const auto text = formatOpenMetrics(series, 0.0);
+
+    ASSERT_NE(text.find("operator=\"a\\\"b\\\\c\""), std::string::npos);
+}
+
+TEST(MetricsExporter, ReplacesFileWithEachSnapshot) {
+    const auto path = std::filesystem::temp_directory_path() / "vmel_metrics_exporter_test.txt";
+    std::filesystem::remove(path);
+
+    std::atomic<int> snapshots{0};
+    {
+        MetricsExporter exporter(path.string(), std::chrono::milliseconds{1}, [&snapshots] {
+            const auto count = ++snapshots;
+            const std::vector<LatencySeries> series{{"0x1", "tosa", "CONV2D", std::vector<double>(count, 0.001)}};
+            return formatOpenMetrics(series, static_cast<double>(count));
+        });
+
+        // Wait for at least two export intervals
+        while (snapshots.load() < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    // The file holds only the final snapshot, as a single exposition
+    const auto text = readFile(path);
+    ASSERT_GE(snapshots.load(), 3);
+    ASSERT_EQ(countOccurrences(text, "# EOF\n"), 1u);
+    ASSERT_EQ(countOccurrences(text, "# TYPE "), 1u);
+    ASSERT_EQ(text.substr(text.size() - 6), "# EOF\n");
+    ASSERT_NE(text.find("_count{pipeline=\"0x1\",pipeline_kind=\"tosa\",operator=\"CONV2D\"} " +
+                        std::to_string(snapshots.load()) + " "),
+              std::string::npos);
+    ASSERT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+    std::filesystem::remove(path);
+}
+
+} // namespace
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "pipeline_results.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace mlsdk::el::layer;
+
+VkPipeline makePipeline(uint32_t i) { return reinterpret_cast<VkPipeline>(static_cast<uintptr_t>(0x1000 + i)); }
+
+// Publishes pipeline i as makePipeline(i) and records the order of the published entries
+struct Publisher {
+    VkPipeline operator()(uint32_t i) {
+        published.push_back(i);
+        return makePipeline(i);
+    }
+
+    std::vector<uint32_t> published;
+};
+
+const auto noEarlyReturn = [](uint32_t) { return false; };
+
+TEST(PipelineResults, ReportsResultsInCreateInfoOrder) { // cppcheck-suppress syntaxError
+    const std::vector<VkResult> results{VK_SUCCESS, VK_ERROR_OUT_OF_HOST_MEMORY, VK_SUCCESS,
+                                        VK_PIPELINE_COMPILE_REQUIRED};
+    const std::vector<std::exception_ptr> exceptions(results.size());
+    std::vector<VkPipeline> pipelines(results.size(), makePipeline(99));
+    Publisher publisher;
+
+    ASSERT_EQ(collectPipelineResults(results, exceptions, noEarlyReturn, publisher, pipelines.data()),
+              VK_ERROR_OUT_OF_HOST_MEMORY);
+    ASSERT_EQ(pipelines, (std::vector<VkPipeline>{makePipeline(0), VK_NULL_HANDLE, makePipeline(2), VK_NULL_HANDLE}));
+    ASSERT_EQ(publisher.published, (std::vector<uint32_t>{0, 2}));
+}
+
+TEST(PipelineResults, ErrorsTakePrecedenceOverCompileRequired) {
+    const std::vector<VkResult> results{VK_PIPELINE_COMPILE_REQUIRED, VK_ERROR_OUT_OF_DEVICE_MEMORY,
+                                        VK_ERROR_OUT_OF_HOST_MEMORY};
+    const std::vector<std::exception_ptr> exceptions(results.size());
+    std::vector<VkPipeline> pipelines(results.size());
+    Publisher publisher;
+
+    ASSERT_EQ(collectPipelineResults(results, exceptions, noEarlyReturn, publisher, pipelines.data()),
+              VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    ASSERT_TRUE(publisher.published.empty());
+
+    const std::vector<VkResult> compileRequired{VK_SUCCESS, VK_PIPELINE_COMPILE_REQUIRED};
+    ASSERT_EQ(collectPipelineResults(compileRequired, std::vector<std::exception_ptr>(compileRequired.size()),
+                                     noEarlyReturn, publisher, pipelines.data()),
+              VK_PIPELINE_COMPILE_REQUIRED);
+}
+
+TEST(PipelineResults, EarlyReturnNullsLaterPipelines) {
+    const std::vector<VkResult> results{VK_SUCCESS, VK_ERROR_OUT_OF_HOST_MEMORY, VK_SUCCESS,
+                                        VK_PIPELINE_COMPILE_REQUIRED, VK_SUCCESS, VK_ERROR_OUT_OF_DEVICE_MEMORY};
+    const std::vector<std::exception_ptr> exceptions(results.size());
+    std::vector<VkPipeline> pipelines(results.size(), makePipeline(99));
+    Publisher publisher;
+
+    // Only the flagged failure stops the collection, an earlier failure without the flag does not
+    const auto isEarlyReturn = [](uint32_t i) { return i == 3 || i == 4; };
+    ASSERT_EQ(collectPipelineResults(results, exceptions, isEarlyReturn, publisher, pipelines.data()),
+              VK_ERROR_OUT_OF_HOST_MEMORY);
+    ASSERT_EQ(pipelines, (std::vector<VkPipeline>{makePipeline(0), VK_NULL_HANDLE, makePipeline(2), VK_NULL_HANDLE,
+                                                  VK_NULL_HANDLE, VK_NULL_HANDLE}));
+    ASSERT_EQ(publisher.published, (std::vector<uint32_t>{0, 2}));
+}
+
+TEST(PipelineResults, RethrowsFirstException) {
+    const std::vector<VkResult> results{VK_SUCCESS, VK_SUCCESS, VK_ERROR_OUT_OF_HOST_MEMORY, VK_SUCCESS};
+    std::vector<std::exception_ptr> exceptions(results.size());
+    exceptions[1] = std::make_exception_ptr(std::runtime_error("first"));
+    exceptions[3] = std::make_exception_ptr(std::runtime_error("second"));
+    std::vector<VkPipeline> pipelines(results.size(), makePipeline(99));
+    Publisher publisher;
+
+    try {
+        collectPipelineResults(results, exceptions, noEarlyReturn, publisher, pipelines.data());
+        FAIL() << "Expected the first exception to be rethrown";
+    } catch (const std::runtime_error &error) {
+        ASSERT_STREQ(error.what(), "first");
+    }
+    ASSERT_EQ(pipelines, (std::vector<VkPipeline>{makePipeline(0), VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE}));
+    ASSERT_EQ(publisher.published, (std::vector<uint32_t>{0}));
+}
+
+} // namespace
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "shader_disk_cache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using namespace mlsdk::el::layer;
+
+class ShaderDiskCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / "vmel_shader_disk_cache_test";
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    std::filesystem::path directory;
+    const std::vector<uint32_t> input{0x07230203, 0x00010600, 0, 16, 0};
+    const std::vector<uint32_t> rewritten{0x07230203, 0x00010600, 0, 32, 0, 1, 2, 3};
+};
+
+TEST_F(ShaderDiskCacheTest, ReturnsStoredEntry) {
+    const ShaderDiskCache cache(directory, "version");
+    ASSERT_FALSE(cache.load(input.data(), input.size()).has_value());
+
+    cache.store(input.data(), input.size(), rewritten);
+
+    // A second cache on the same directory stands in for another process
+    const ShaderDiskCache other(directory, "version");
+    const auto loaded = other.load(input.data(), input.size());
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(*loaded, rewritten);
+}
+
+TEST_F(ShaderDiskCacheTest, SaltSeparatesEntries) { // cppcheck-suppress syntaxError
+    ShaderDiskCache(directory, "version").store(input.data(), input.size(), rewritten);
+
+    ASSERT_FALSE(ShaderDiskCache(directory, "other version").load(input.data(), input.size()).has_value());
+}
+
+TEST_F(ShaderDiskCacheTest, IgnoresTruncatedEntries) {
+    const ShaderDiskCache cache(directory, "version");
+    cache.store(input.data(), input.size(), rewritten);
+
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - sizeof(uint32_t));
+    }
+
+    ASSERT_FALSE(cache.load(input.data(), input.size()).has_value());
+}
+
+TEST_F(ShaderDiskCacheTest, RejectsEntriesOfCollidingInputs) {
+    const ShaderDiskCache cache(directory, "version");
+    cache.store(input.data(), input.size(), rewritten);
+
+    // Replace the stored input words of the entry, as if another input of the same size had the same hash
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        const auto headerSize =
+            std::filesystem::file_size(entry.path()) - (input.size() + rewritten.size()) * sizeof(uint32_t);
+        std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(headerSize + 3 * sizeof(uint32_t)));
+        const uint32_t otherBound = 17;
+        file.write(reinterpret_cast<const char *>(&otherBound), sizeof(otherBound));
+    }
+
+    ASSERT_FALSE(cache.load(input.data(), input.size()).has_value());
+}
+
+TEST_F(ShaderDiskCacheTest, IgnoresEntriesWithCorruptSizes) {
+    const ShaderDiskCache cache(directory, "version");
+    cache.store(input.data(), input.size(), rewritten);
+
+    // The output size is the last field of the header
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        const auto headerSize =
+            std::filesystem::file_size(entry.path()) - (input.size() + rewritten.size()) * sizeof(uint32_t);
+        std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(headerSize - sizeof(uint64_t)));
+        const uint64_t outputSize = std::numeric_limits<uint64_t>::max() / sizeof(uint32_t);
+        file.write(reinterpret_cast<const char *>(&outputSize), sizeof(outputSize));
+    }
+
+    ASSERT_FALSE(cache.load(input.data(), input.size()).has_value());
+}
+
+TEST_F(ShaderDiskCacheTest, LeavesNoTemporaryFiles) {
+    const ShaderDiskCache cache(directory, "version");
+    cache.store(input.data(), input.size(), rewritten);
+    cache.store(input.data(), input.size(), rewritten);
+
+    size_t entries = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        ASSERT_EQ(entry.path().extension(), ".spv");
+        entries++;
+    }
+    ASSERT_EQ(entries, 1u);
+}
+
+} // namespace
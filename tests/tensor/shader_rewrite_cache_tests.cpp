@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "mlel/utils.hpp"
+#include "shader_rewrite_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace mlsdk::el::layer;
+
+TEST(ShaderRewriteCache, CoalescesConcurrentRewrites) {
+    ShaderRewriteCache cache;
+    std::atomic<int> rewrites{0};
+    std::vector<const ShaderRewriteCache::Spirv *> results(8, nullptr);
+
+    mlsdk::el::utils::parallelFor(results.size(), [&](std::size_t i) {
+        results[i] = &cache.getOrRewrite(42, [&]() {
+            rewrites++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return ShaderRewriteCache::Spirv{1, 2, 3};
+        });
+    });
+
+    EXPECT_EQ(rewrites, 1);
+    for (const auto *result : results) {
+        ASSERT_EQ(result, results[0]);
+    }
+    EXPECT_EQ(*results[0], (ShaderRewriteCache::Spirv{1, 2, 3}));
+    EXPECT_EQ(cache.find(42), results[0]);
+    EXPECT_EQ(cache.find(43), nullptr);
+}
+
+TEST(ShaderRewriteCache, RetriesFailedRewrite) {
+    ShaderRewriteCache cache;
+    EXPECT_THROW(cache.getOrRewrite(7, []() -> ShaderRewriteCache::Spirv { throw std::runtime_error("failed"); }),
+                 std::runtime_error);
+    EXPECT_EQ(cache.find(7), nullptr);
+
+    const auto &spirv = cache.getOrRewrite(7, []() { return ShaderRewriteCache::Spirv{4}; });
+    EXPECT_EQ(spirv, ShaderRewriteCache::Spirv{4});
+}
+
+} // namespace
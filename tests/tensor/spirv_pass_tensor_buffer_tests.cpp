@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2026 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "mlel/utils.hpp"
+#include "spirv_pass_tensor_buffer.hpp"
+
+#include <algorithm>
+#include <spirv-tools/libspirv.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace mlsdk::el::layer;
+
+const std::string tensorShader = R"(
+#version 460 core
+
+#extension GL_ARM_tensors : enable
+#extension GL_EXT_shader_explicit_arithmetic_types : enable
+
+layout(local_size_x = 1) in;
+
+layout(set = 0, binding = 0) uniform tensorARM<int8_t, 2> src;
+layout(set = 0, binding = 1) uniform tensorARM<bool, 1> mask;
+layout(set = 0, binding = 2) uniform tensorARM<float, 2> dst[2];
+
+void main() {
+    const uint x = gl_GlobalInvocationID.x;
+    const uint size = tensorSizeARM(src, 1);
+
+    int8_t values[2];
+    tensorReadARM(src, uint[](x, 0), values);
+
+    bool enabled;
+    tensorReadARM(mask, uint[](x), enabled, gl_TensorOperandsOutOfBoundsValueARM, false);
+
+    float result[2] = {enabled ? float(values[0]) : 0.0, float(values[1] + size)};
+    tensorWriteARM(dst[x % 2], uint[](x, 0), result);
+}
+)";
+
+const std::string repeatedReadShader = R"(
+#version 460 core
+
+#extension GL_ARM_tensors : enable
+
+layout(local_size_x = 1) in;
+
+layout(set = 0, binding = 0) uniform tensorARM<float, 1> src;
+layout(set = 0, binding = 1) uniform tensorARM<float, 1> dst;
+
+void main() {
+    const uint x = gl_GlobalInvocationID.x;
+
+    float first;
+    float second;
+    tensorReadARM(src, uint[](x), first);
+    tensorReadARM(src, uint[](x + 1), second);
+    tensorWriteARM(dst, uint[](x), first + second);
+}
+)";
+
+const std::string bufferShader = R"(
+#version 460 core
+
+layout(local_size_x = 1) in;
+
+layout(set = 0, binding = 0) buffer Data {
+    float values[];
+};
+
+void main() { values[gl_GlobalInvocationID.x] *= 2.0; }
+)";
+
+constexpr uint32_t opFunctionCall = 57;
+constexpr uint32_t opUGreaterThanEqual = 174;
+
+size_t countInstructions(const std::vector<uint32_t> &spirv, uint32_t opcode) {
+    // Instructions follow the 5 word header, each starting with its word count and opcode
+    size_t count = 0;
+    for (size_t offset = 5; offset < spirv.size(); offset += spirv[offset] >> 16) {
+        if ((spirv[offset] & 0xffff) == opcode) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(SpirvPassTensorBuffer, InspectsTensorComputeShader) {
+    const auto spirv = mlsdk::el::utils::glslToSpirv(tensorShader);
+    const auto info = inspectTensorModule(spirv);
+
+    ASSERT_TRUE(info.isValid);
+    ASSERT_TRUE(info.hasTensors);
+    ASSERT_TRUE(info.isCompute);
+    ASSERT_FALSE(info.hasTensorParameters);
+}
+
+TEST(SpirvPassTensorBuffer, RejectsTruncatedModule) { // cppcheck-suppress syntaxError
+    auto spirv = mlsdk::el::utils::glslToSpirv(tensorShader);
+    spirv.resize(spirv.size() - 1);
+
+    ASSERT_FALSE(inspectTensorModule(spirv).isValid);
+    ASSERT_FALSE(inspectTensorModule({}).isValid);
+}
+
+TEST(SpirvPassTensorBuffer, ChecksTensorCapability) {
+    const auto tensorSpirv = mlsdk::el::utils::glslToSpirv(tensorShader);
+    const auto bufferSpirv = mlsdk::el::utils::glslToSpirv(bufferShader);
+
+    ASSERT_TRUE(declaresTensorCapability(tensorSpirv.data(), tensorSpirv.size()));
+    ASSERT_FALSE(declaresTensorCapability(bufferSpirv.data(), bufferSpirv.size()));
+    // Malformed modules are left to the full inspection
+    ASSERT_TRUE(declaresTensorCapability(bufferSpirv.data(), 1));
+}
+
+TEST(SpirvPassTensorBuffer, LowersTensorsToValidBuffers) {
+    const auto spirv = mlsdk::el::utils::glslToSpirv(tensorShader);
+    const auto lowered = lowerTensorsToBuffers(spirv);
+    ASSERT_TRUE(lowered.has_value());
+
+    const auto info = inspectTensorModule(*lowered);
+    ASSERT_TRUE(info.isValid);
+    ASSERT_FALSE(info.hasTensors);
+
+    spvtools::SpirvTools tools{SPV_ENV_VULKAN_1_3};
+    ASSERT_TRUE(tools.Validate(*lowered));
+
+    std::string disassembly;
+    ASSERT_TRUE(tools.Disassemble(*lowered, &disassembly));
+    ASSERT_EQ(disassembly.find("TensorARM"), std::string::npos);
+    ASSERT_NE(disassembly.find("OpConvertUToPtr"), std::string::npos);
+}
+
+TEST(SpirvPassTensorBuffer, LowersUncheckedAccessesWithoutBoundsTests) {
+    const auto spirv = mlsdk::el::utils::glslToSpirv(repeatedReadShader);
+    const auto checked = lowerTensorsToBuffers(spirv);
+    const auto unchecked = lowerTensorsToBuffers(spirv, false);
+    ASSERT_TRUE(checked.has_value());
+    ASSERT_TRUE(unchecked.has_value());
+
+    spvtools::SpirvTools tools{SPV_ENV_VULKAN_1_3};
+    ASSERT_TRUE(tools.Validate(*unchecked));
+
+    ASSERT_GT(countInstructions(*checked, opUGreaterThanEqual), 0u);
+    ASSERT_EQ(countInstructions(*unchecked, opUGreaterThanEqual), 0u);
+    ASSERT_EQ(countInstructions(*unchecked, opFunctionCall), 0u);
+}
+
+} // namespace
@@ -8,6 +8,7 @@
 
 #include "tensor_arm_detail.hpp"
 
+#include <stdexcept>
 #include <vector>
 
 namespace {
@@ -36,4 +37,124 @@ TEST(TensorARM, LinearImageAliasingUsesImageRowPitch) {
     EXPECT_EQ(strides[0], static_cast<int64_t>(imageLayout.rowPitch));
 }
 
+using mlsdk::el::layer::tensor_arm_detail::coalesceBufferBarriers;
+using mlsdk::el::layer::tensor_arm_detail::CopyRegion;
+using mlsdk::el::layer::tensor_arm_detail::planCopy;
+
+TEST(TensorARM, CopyCoalescesContiguousRegions) {
+    const std::vector<int64_t> dimensions{4, 8};
+    const std::vector<int64_t> strides{8, 1};
+    const std::vector<CopyRegion> regions{
+        {{0, 0}, {2, 0}, {1, 8}},
+        {{1, 0}, {3, 0}, {1, 8}},
+    };
+
+    const auto plan = planCopy(1, dimensions, strides, dimensions, strides, regions);
+
+    ASSERT_EQ(plan.bufferCopies.size(), 1u);
+    EXPECT_EQ(plan.bufferCopies[0].srcOffset, 0u);
+    EXPECT_EQ(plan.bufferCopies[0].dstOffset, 16u);
+    EXPECT_EQ(plan.bufferCopies[0].size, 16u);
+    EXPECT_TRUE(plan.elementCopies.regions.empty());
+}
+
+TEST(TensorARM, CopyBatchesStridedRegions) {
+    const std::vector<int64_t> dimensions{4, 8};
+    const std::vector<int64_t> srcStrides{16, 2};
+    const std::vector<int64_t> dstStrides{32, 2};
+    const std::vector<CopyRegion> regions{
+        {{0, 0}, {0, 0}, {4, 8}},
+        {{1, 2}, {0, 4}, {2, 3}},
+    };
+
+    const auto plan = planCopy(2, dimensions, srcStrides, dimensions, dstStrides, regions);
+
+    EXPECT_TRUE(plan.bufferCopies.empty());
+    EXPECT_TRUE(plan.vectorCopies.regions.empty());
+    const auto &copies = plan.elementCopies;
+    ASSERT_EQ(copies.regions.size(), 2u);
+    EXPECT_EQ(copies.elementCount, 38u);
+    EXPECT_EQ(copies.regions[1].firstElement, 32u);
+    EXPECT_EQ(copies.regions[1].srcOffset, 10u);
+    EXPECT_EQ(copies.regions[1].dstOffset, 4u);
+    EXPECT_EQ(copies.regions[1].rank, 2u);
+    EXPECT_EQ(copies.regions[1].srcStrides[4], 8u);
+    EXPECT_EQ(copies.regions[1].dstStrides[4], 16u);
+    EXPECT_EQ(copies.regions[1].extent[5], 3u);
+}
+
+TEST(TensorARM, CopyCollapsesContiguousDimensions) {
+    // The two innermost dimensions are packed in both tensors, only the outermost one is padded
+    const std::vector<int64_t> dimensions{2, 4, 8};
+    const std::vector<int64_t> srcStrides{64, 8, 1};
+    const std::vector<int64_t> dstStrides{48, 8, 1};
+
+    const auto plan = planCopy(1, dimensions, srcStrides, dimensions, dstStrides, {{{0, 0, 0}, {0, 0, 0}, {2, 4, 8}}});
+
+    ASSERT_EQ(plan.elementCopies.regions.size(), 1u);
+    const auto &region = plan.elementCopies.regions[0];
+    EXPECT_EQ(region.rank, 2u);
+    EXPECT_EQ(region.extent[4], 2u);
+    EXPECT_EQ(region.extent[5], 32u);
+    EXPECT_EQ(region.srcStrides[4], 64u);
+    EXPECT_EQ(region.dstStrides[4], 48u);
+}
+
+TEST(TensorARM, CopyVectorizesAlignedRuns) {
+    const std::vector<int64_t> dimensions{4, 16};
+    const std::vector<int64_t> srcStrides{128, 4};
+    const std::vector<int64_t> dstStrides{64, 4};
+    const std::vector<CopyRegion> regions{{{0, 0}, {0, 0}, {4, 16}}};
+
+    const auto aligned = planCopy(4, dimensions, srcStrides, dimensions, dstStrides, regions, true);
+    ASSERT_EQ(aligned.vectorCopies.regions.size(), 1u);
+    EXPECT_EQ(aligned.vectorCopies.elementCount, 16u);
+    EXPECT_EQ(aligned.vectorCopies.regions[0].extent[5], 4u);
+    EXPECT_EQ(aligned.vectorCopies.regions[0].srcStrides[4], 8u);
+    EXPECT_EQ(aligned.vectorCopies.regions[0].dstStrides[5], 1u);
+
+    const auto unaligned = planCopy(4, dimensions, srcStrides, dimensions, dstStrides, regions, false);
+    EXPECT_TRUE(unaligned.vectorCopies.regions.empty());
+    EXPECT_EQ(unaligned.elementCopies.elementCount, 64u);
+}
+
+TEST(TensorARM, CopyRejectsRegionsOutOfBounds) {
+    const std::vector<int64_t> dimensions{4, 8};
+    const std::vector<int64_t> strides{8, 1};
+
+    EXPECT_THROW(planCopy(1, dimensions, strides, dimensions, strides, {{{3, 0}, {0, 0}, {2, 8}}}),
+                 std::runtime_error);
+}
+
+TEST(TensorARM, CoalescesTensorBarriersAboveThreshold) {
+    const auto makeBarrier = [](VkAccessFlags2 dstAccessMask, uint32_t dstQueueFamilyIndex) {
+        VkBufferMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = dstAccessMask;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+        return barrier;
+    };
+    std::vector<VkBufferMemoryBarrier2> barriers(3, makeBarrier(VK_ACCESS_2_SHADER_READ_BIT, VK_QUEUE_FAMILY_IGNORED));
+    barriers.push_back(makeBarrier(VK_ACCESS_2_SHADER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED));
+    barriers.push_back(makeBarrier(VK_ACCESS_2_SHADER_READ_BIT, 1));
+
+    std::vector<VkMemoryBarrier2> memoryBarriers;
+    auto disabled = barriers;
+    coalesceBufferBarriers(disabled, memoryBarriers, 0);
+    EXPECT_EQ(disabled.size(), 5u);
+    EXPECT_TRUE(memoryBarriers.empty());
+
+    coalesceBufferBarriers(barriers, memoryBarriers, 3);
+    ASSERT_EQ(memoryBarriers.size(), 1u);
+    EXPECT_EQ(memoryBarriers[0].dstAccessMask, VK_ACCESS_2_SHADER_READ_BIT);
+    // The odd one out and the ownership transfer keep their buffer barriers
+    ASSERT_EQ(barriers.size(), 2u);
+    EXPECT_EQ(barriers[0].dstAccessMask, VK_ACCESS_2_SHADER_WRITE_BIT);
+    EXPECT_EQ(barriers[1].dstQueueFamilyIndex, 1u);
+}
+
 } // namespace
@@ -1959,6 +1959,81 @@ TEST_F(MLEmulationLayerForVulkan, LinearTensorImageAliasingUsesImageRowPitch) {
     aliasedMemory.unmapMemory();
 }
 
+TEST_F(MLEmulationLayerForVulkan, TensorViewCreatedBeforeMemoryBind) {
+    constexpr uint32_t width = 5;
+    constexpr uint32_t height = 3;
+    const std::vector<int64_t> dimensions{height, width, 1};
+
+    auto device = createDevice();
+
+    const vk::TensorDescriptionARM tensorDescription{
+        vk::TensorTilingARM::eLinear,
+        vk::Format::eR8Uint,
+        static_cast<uint32_t>(dimensions.size()),
+        dimensions.data(),
+        nullptr,
+        vk::TensorUsageFlagBitsARM::eShader,
+    };
+    const vk::TensorCreateInfoARM tensorCreateInfo{
+        {}, &tensorDescription, vk::SharingMode::eExclusive, 0, nullptr,
+    };
+    vk::raii::TensorARM tensor{&(*device), tensorCreateInfo};
+
+    // Graph pipelines create their tensor views before binding memory, the view must use the memory bound later
+    const vk::TensorViewCreateInfoARM tensorViewCreateInfo{
+        {},
+        *tensor,
+        vk::Format::eR8Uint,
+    };
+    vk::raii::TensorViewARM tensorView{&(*device), tensorViewCreateInfo};
+
+    const vk::TensorMemoryRequirementsInfoARM tensorRequirementsInfo{*tensor};
+    const auto tensorRequirements = (&(*device)).getTensorMemoryRequirementsARM(tensorRequirementsInfo);
+    const auto memoryTypeIndices = device->getPhysicalDevice()->getMemoryTypeIndices(
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        tensorRequirements.memoryRequirements.memoryTypeBits);
+    ASSERT_FALSE(memoryTypeIndices.empty());
+
+    const vk::MemoryAllocateFlagsInfo allocateFlags{vk::MemoryAllocateFlagBits::eDeviceAddress};
+    const vk::MemoryAllocateInfo allocateInfo{
+        tensorRequirements.memoryRequirements.size,
+        memoryTypeIndices.front(),
+        &allocateFlags,
+    };
+    vk::raii::DeviceMemory memory{&(*device), allocateInfo};
+    const vk::BindTensorMemoryInfoARM bindTensorInfo{*tensor, *memory, 0};
+    (&(*device)).bindTensorMemoryARM(bindTensorInfo);
+
+    auto *mappedMemory = static_cast<uint8_t *>(memory.mapMemory(0, VK_WHOLE_SIZE));
+    std::fill(mappedMemory, mappedMemory + allocateInfo.allocationSize, uint8_t{0});
+    memory.unmapMemory();
+
+    auto placeholderTensor = std::make_shared<Tensor>(device, Shape{vk::Format::eR8Uint, dimensions});
+    const TensorComputePipeline::DescriptorMap descriptorMap = {{{0, {placeholderTensor}}}};
+    const auto spirv = mlsdk::el::utils::glslToSpirv(fileToString("tensor_image_alias.comp"));
+    TensorComputePipeline computePipeline{device, descriptorMap, spirv};
+    auto [descriptorPool, descriptorSets] = computePipeline.createDescriptorSets(descriptorMap);
+
+    const vk::WriteDescriptorSetTensorARM tensorWriteInfo{
+        1,
+        &(*tensorView),
+    };
+    const vk::WriteDescriptorSet descriptorWrite{
+        *descriptorSets.front(), 0, 0, 1, vk::DescriptorType::eTensorARM, nullptr, nullptr, nullptr, &tensorWriteInfo,
+    };
+    (&(*device)).updateDescriptorSets({descriptorWrite}, {});
+    computePipeline.dispatchSubmit(descriptorSets, width, height, 1);
+
+    mappedMemory = static_cast<uint8_t *>(memory.mapMemory(0, VK_WHOLE_SIZE));
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            const auto expected = static_cast<uint8_t>((y + 1) * 16 + x);
+            EXPECT_EQ(mappedMemory[y * width + x], expected) << "Mismatch at coordinate (" << x << ", " << y << ")";
+        }
+    }
+    memory.unmapMemory();
+}
+
 TEST_F(MLEmulationLayerForVulkan, ShapeGetElementOffsetNonPacked) {
     const Shape shape{vk::Format::eR64Sint, {2, 3, 4}, {160, 40, 8}};
 